@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/async_registry.hpp>
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/executor.hpp>
+#include <basicpp/core/task.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+using async_registry_t = basicpp::command::async_registry<std::uint64_t, std::uint64_t>;
+using sync_registry_t = basicpp::command::registry<std::uint64_t, std::uint64_t>;
+
+// A command that gives its thread back `waits` times before finishing, standing in for one that waits on I/O.
+async_registry_t::task_type waiting_handler(basicpp::core::executor* pool, int waits, std::uint64_t arg) {
+    for (int i = 0; i < waits; ++i) {
+        co_await basicpp::core::schedule(*pool);
+    }
+    co_return async_registry_t::handler_result::ok(arg + 1);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point began) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    namespace core = basicpp::core;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto calls = bench::scaled(opts, 200'000);
+
+    sync_registry_t sync_registry;
+    async_registry_t async_registry;
+    sync_registry.register_handler("inc", [](std::uint64_t arg) { return sync_registry_t::handler_result::ok(arg + 1); });
+    async_registry.register_handler("inc", [](std::uint64_t arg) -> async_registry_t::task_type {
+        co_return async_registry_t::handler_result::ok(arg + 1);
+    });
+
+    bench::print_header("dispatch overhead on the calling thread");
+    bench::print(bench::measure(opts, "registry::dispatch", calls, [&](std::size_t n) {
+        std::uint64_t sink = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sink += sync_registry.dispatch("inc", i).value();
+        }
+        bench::do_not_optimize(sink);
+    }));
+    bench::print(bench::measure(opts, "async_registry + sync_wait", calls, [&](std::size_t n) {
+        std::uint64_t sink = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            sink += core::sync_wait(async_registry.dispatch("inc", i)).value();
+        }
+        bench::do_not_optimize(sink);
+    }));
+    bench::print(bench::measure(opts, "async_registry awaited in a task", calls, [&](std::size_t n) {
+        auto loop = [](const async_registry_t& registry, std::size_t count) -> core::task<std::uint64_t> {
+            std::uint64_t sink = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                sink += (co_await registry.dispatch("inc", i)).value();
+            }
+            co_return sink;
+        };
+        bench::do_not_optimize(core::sync_wait(loop(async_registry, n)));
+    }));
+
+    const std::size_t in_flight = opts.scale == 0 ? 200 : 10'000 * opts.scale;
+    constexpr int waits = 8;
+
+    bench::print_section("commands in flight, each yielding its thread 8 times (wall ms)");
+    std::cout << std::left << std::setw(28) << "configuration" << std::right << std::setw(14) << "ms" << '\n';
+
+    {
+        const auto began = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        threads.reserve(in_flight);
+        for (std::size_t i = 0; i < in_flight; ++i) {
+            threads.emplace_back([&sync_registry, i] {
+                for (int w = 0; w < waits; ++w) {
+                    std::this_thread::yield();
+                }
+                bench::do_not_optimize(sync_registry.dispatch("inc", i));
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::cout << std::left << std::setw(28) << "thread per command" << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(14) << seconds_since(began) * 1e3 << '\n';
+    }
+
+    for (unsigned workers : {1u, 2u, 4u}) {
+        core::thread_pool_executor pool(workers);
+        async_registry_t registry(pool);
+        registry.register_handler("wait", [&pool](std::uint64_t arg) { return waiting_handler(&pool, waits, arg); });
+
+        const auto began = std::chrono::steady_clock::now();
+        std::vector<async_registry_t::task_type> tasks;
+        tasks.reserve(in_flight);
+        for (std::size_t i = 0; i < in_flight; ++i) {
+            tasks.push_back(registry.dispatch("wait", i));
+        }
+        bench::do_not_optimize(core::sync_wait(core::when_all(std::move(tasks))));
+        std::cout << std::left << std::setw(28) << ("coroutines on " + std::to_string(workers) + " threads")
+                  << std::right << std::fixed << std::setprecision(2) << std::setw(14) << seconds_since(began) * 1e3
+                  << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+
+#include "bench_support.hpp"
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using registry_t = basicpp::command::registry<std::uint64_t, std::uint64_t>;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const std::size_t batch_size = 4096;
+    const auto batches = bench::scaled(opts, 200);
+
+    for (std::size_t handlers : {16u, 1'000u, 100'000u}) {
+        registry_t registry;
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < handlers; ++i) {
+            keys.push_back("tick.command." + std::to_string(i));
+            registry.register_handler(keys.back(), [i](std::uint64_t arg) { return registry_t::handler_result::ok(arg ^ i); });
+        }
+
+        std::vector<registry_t::batch_request> requests;
+        std::uint64_t state = 88172645463325252ULL;
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            requests.push_back({keys[state % handlers], std::tuple<std::uint64_t>(i)});
+        }
+        std::vector<registry_t::handler_result> results(batch_size);
+
+        bench::print_header(std::to_string(handlers) + " handlers, batches of 4096 (ns per request)");
+        bench::print(bench::measure(opts, "dispatch loop", batches * batch_size, [&](std::size_t n) {
+            for (std::size_t b = 0; b < n / batch_size; ++b) {
+                for (std::size_t i = 0; i < batch_size; ++i) {
+                    results[i] = registry.dispatch(requests[i].key, std::get<0>(requests[i].args));
+                }
+                bench::do_not_optimize(results.data());
+            }
+        }));
+        bench::print(bench::measure(opts, "dispatch_batch", batches * batch_size, [&](std::size_t n) {
+            for (std::size_t b = 0; b < n / batch_size; ++b) {
+                registry.dispatch_batch(requests, results);
+                bench::do_not_optimize(results.data());
+            }
+        }));
+        bench::print(bench::measure(opts, "dispatch_batch (parallel)", batches * batch_size, [&](std::size_t n) {
+            for (std::size_t b = 0; b < n / batch_size; ++b) {
+                registry.dispatch_batch(requests, results, basicpp::command::parallel_dispatch{});
+                bench::do_not_optimize(results.data());
+            }
+        }));
+
+        registry.freeze();
+        bench::print(bench::measure(opts, "dispatch_batch (frozen)", batches * batch_size, [&](std::size_t n) {
+            for (std::size_t b = 0; b < n / batch_size; ++b) {
+                registry.dispatch_batch(requests, results);
+                bench::do_not_optimize(results.data());
+            }
+        }));
+    }
+
+    return 0;
+}
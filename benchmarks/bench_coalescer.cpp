@@ -0,0 +1,169 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/history/coalescer.hpp>
+#include <basicpp/core/flat_hash_map.hpp>
+#include <basicpp/history/concurrent_coalescer.hpp>
+#include <basicpp/history/keyed_coalescer.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct add {
+    std::uint64_t operator()(std::uint64_t a, std::uint64_t b) const noexcept {
+        return a + b;
+    }
+};
+
+// The straightforward alternative: the single-threaded coalescer behind a mutex.
+class locked_coalescer {
+public:
+    locked_coalescer() : coalescer_(std::chrono::milliseconds(1), add{}) {}
+
+    void push(std::uint64_t value, clock_type::time_point now) {
+        std::lock_guard lock(mutex_);
+        coalescer_.push(value, now);
+    }
+
+    std::optional<std::uint64_t> consume(clock_type::time_point now) {
+        std::lock_guard lock(mutex_);
+        return coalescer_.consume(now);
+    }
+
+private:
+    std::mutex mutex_;
+    basicpp::history::coalescer<std::uint64_t> coalescer_;
+};
+
+using concurrent_t = basicpp::history::concurrent_coalescer<std::uint64_t, add>;
+using keyed_t = basicpp::history::keyed_coalescer<std::uint32_t, std::uint64_t, clock_type, add>;
+using single_t = basicpp::history::coalescer<std::uint64_t, clock_type, add>;
+
+// The straightforward per-key alternative: one coalescer per key, and a poll that visits every key.
+class scanning_keyed_coalescer {
+public:
+    explicit scanning_keyed_coalescer(clock_type::duration window) : window_(window) {}
+
+    void push(std::uint32_t key, std::uint64_t value, clock_type::time_point now) {
+        coalescers_.try_emplace(key, window_, add{}).first->push(value, now);
+    }
+
+    std::size_t poll(clock_type::time_point now) {
+        std::size_t emitted = 0;
+        coalescers_.for_each([&](const std::uint32_t&, single_t& coalescer) {
+            if (const auto value = coalescer.consume(now)) {
+                basicpp::bench::do_not_optimize(*value);
+                ++emitted;
+            }
+        });
+        return emitted;
+    }
+
+private:
+    clock_type::duration window_;
+    basicpp::core::flat_hash_map<std::uint32_t, single_t> coalescers_;
+};
+
+// Pushes `per_thread` values from each of `threads` producers while one consumer drains once per window;
+// returns Mpush/s. Timestamps are read once per 256 pushes, as a producer batching input would.
+template <typename Coalescer>
+double throughput(Coalescer& coalescer, unsigned threads, std::size_t per_thread) {
+    std::atomic<unsigned> running{threads};
+    std::uint64_t drained = 0;
+    const auto began = clock_type::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            auto now = clock_type::now();
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                if ((i & 255) == 0) {
+                    now = clock_type::now();
+                }
+                coalescer.push(i, now);
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    while (running.load(std::memory_order_acquire) != 0) {
+        if (const auto value = coalescer.consume(clock_type::now())) {
+            drained += *value;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto seconds = std::chrono::duration<double>(clock_type::now() - began).count();
+    basicpp::bench::do_not_optimize(drained);
+    return static_cast<double>(threads * per_thread) / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto per_thread = bench::scaled(opts, 2'000'000);
+
+    bench::print_section("producers pushing into one coalescer, 1 ms window (Mpush/s)");
+    std::cout << std::left << std::setw(12) << "threads" << std::right << std::setw(14) << "mutex" << std::setw(14)
+              << "concurrent" << '\n';
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        locked_coalescer locked;
+        concurrent_t concurrent{std::chrono::milliseconds(1)};
+
+        const auto locked_rate = throughput(locked, threads, per_thread);
+        const auto concurrent_rate = throughput(concurrent, threads, per_thread);
+        std::cout << std::left << std::setw(12) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << locked_rate << std::setw(14) << concurrent_rate << '\n';
+    }
+
+    // Many keys, each pushed now and then; time advances 1 ms per `per_tick` pushes and is polled every tick.
+    const std::uint32_t keys = opts.scale == 0 ? 4096 : 200'000;
+    const std::size_t per_tick = 1000;
+    const auto operations = bench::scaled(opts, 2'000'000);
+    const auto window = std::chrono::milliseconds(50);
+
+    bench::print_header("keyed coalescing, " + std::to_string(keys) + " keys, 50 ms window (ns per push)");
+    bench::print(bench::measure(opts, "coalescer per key, scanning poll", operations, [&](std::size_t n) {
+        scanning_keyed_coalescer scanning{window};
+        auto now = clock_type::time_point{};
+        for (std::size_t i = 0; i < n; ++i) {
+            scanning.push(static_cast<std::uint32_t>((i * 2654435761u) % keys), i, now);
+            if ((i + 1) % per_tick == 0) {
+                now += std::chrono::milliseconds(1);
+                bench::do_not_optimize(scanning.poll(now));
+            }
+        }
+    }));
+    bench::print(bench::measure(opts, "keyed_coalescer", operations, [&](std::size_t n) {
+        keyed_t keyed{window, add{}};
+        auto now = clock_type::time_point{};
+        std::uint64_t emitted = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            keyed.push(static_cast<std::uint32_t>((i * 2654435761u) % keys), i, now);
+            if ((i + 1) % per_tick == 0) {
+                now += std::chrono::milliseconds(1);
+                emitted += keyed.poll(now, [](const std::uint32_t&, std::uint64_t& value) {
+                    bench::do_not_optimize(value);
+                });
+            }
+        }
+        bench::do_not_optimize(emitted);
+    }));
+
+    return 0;
+}
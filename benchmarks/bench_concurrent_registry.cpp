@@ -0,0 +1,122 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/concurrent_registry.hpp>
+#include <basicpp/command/registry.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+using handler_result = basicpp::core::result<std::uint64_t, std::string>;
+
+// Baseline: the single-threaded registry behind a reader-writer lock.
+class locked_registry {
+public:
+    void register_handler(std::string key, std::function<handler_result(std::uint64_t)> handler) {
+        std::unique_lock lock(mutex_);
+        registry_.register_handler(std::move(key), std::move(handler));
+    }
+
+    handler_result dispatch(std::string_view key, std::uint64_t arg) const {
+        std::shared_lock lock(mutex_);
+        return registry_.dispatch(key, arg);
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    basicpp::command::registry<std::uint64_t, std::uint64_t> registry_;
+};
+
+// Runs `threads` dispatching threads for `duration` while one writer re-registers a handler every
+// `writer_period`; returns total dispatches per second.
+template <typename Registry>
+double run(Registry& registry, const std::vector<std::string>& keys, unsigned threads,
+           std::chrono::milliseconds duration, std::chrono::microseconds writer_period) {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> total{0};
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            std::uint64_t count = 0;
+            std::uint64_t sink = 0;
+            for (std::size_t i = t; !stop.load(std::memory_order_relaxed); ++i) {
+                auto result = registry.dispatch(keys[i % keys.size()], i);
+                sink += result ? result.value() : 0;
+                ++count;
+            }
+            basicpp::bench::do_not_optimize(sink);
+            total.fetch_add(count);
+        });
+    }
+
+    std::thread writer([&] {
+        while (!start.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        for (std::uint64_t round = 0; !stop.load(std::memory_order_relaxed); ++round) {
+            registry.register_handler(keys[round % keys.size()], [round](std::uint64_t arg) {
+                return handler_result::ok(arg + round);
+            });
+            std::this_thread::sleep_for(writer_period);
+        }
+    });
+
+    const auto began = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    writer.join();
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+    return static_cast<double>(total.load()) / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto duration = std::chrono::milliseconds(opts.scale == 0 ? 20 : 300 * opts.scale);
+    const auto writer_period = std::chrono::microseconds(200);
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 256; ++i) {
+        keys.push_back("service.command." + std::to_string(i));
+    }
+
+    bench::print_section("dispatch throughput with a writer re-registering every 200us (Mdispatch/s)");
+    std::cout << std::left << std::setw(10) << "threads" << std::right << std::setw(18) << "shared_mutex"
+              << std::setw(18) << "concurrent" << '\n';
+
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+        locked_registry locked;
+        basicpp::command::concurrent_registry<std::uint64_t, std::uint64_t> concurrent;
+        for (const auto& key : keys) {
+            locked.register_handler(key, [](std::uint64_t arg) { return handler_result::ok(arg); });
+            concurrent.register_handler(key, [](std::uint64_t arg) { return handler_result::ok(arg); });
+        }
+
+        const auto locked_rate = run(locked, keys, threads, duration, writer_period);
+        const auto concurrent_rate = run(concurrent, keys, threads, duration, writer_period);
+        std::cout << std::left << std::setw(10) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(18) << locked_rate / 1e6 << std::setw(18) << concurrent_rate / 1e6 << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <basicpp/state/concurrent_state_machine.hpp>
+#include <basicpp/state/dense_state_machine.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+constexpr int state_count = 64;
+constexpr int event_count = 8;
+
+using clock_type = std::chrono::steady_clock;
+using dense_t = basicpp::state::dense_state_machine<int, int, state_count, event_count>;
+using concurrent_t = basicpp::state::concurrent_state_machine<int, int, state_count, event_count>;
+
+// Every state has a transition on every event, so each dispatch succeeds.
+constexpr dense_t::table_type make_table() {
+    dense_t::table_type table;
+    for (int state = 0; state < state_count; ++state) {
+        for (int event = 0; event < event_count; ++event) {
+            table.add_transition(state, event, (state * 7 + event * 13 + 1) % state_count);
+        }
+    }
+    return table;
+}
+
+constexpr auto table = make_table();
+
+// The straightforward alternative: a dense_state_machine behind a mutex.
+class locked_machine {
+public:
+    locked_machine() : machine_(0, table) {}
+
+    dense_t::dispatch_result dispatch(int event) {
+        std::lock_guard lock(mutex_);
+        return machine_.dispatch(event);
+    }
+
+private:
+    std::mutex mutex_;
+    dense_t machine_;
+};
+
+// Dispatches `per_thread` events from each of `threads` threads; returns Mdispatch/s.
+template <typename Machine>
+double throughput(Machine& machine, unsigned threads, std::size_t per_thread) {
+    const auto began = clock_type::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                basicpp::bench::do_not_optimize(machine.dispatch(static_cast<int>((i + t) % event_count)));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto seconds = std::chrono::duration<double>(clock_type::now() - began).count();
+    return static_cast<double>(threads * per_thread) / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto per_thread = bench::scaled(opts, 1'000'000);
+
+    bench::print_section("contended dispatch on one machine (Mdispatch/s)");
+    std::cout << std::left << std::setw(12) << "threads" << std::right << std::setw(14) << "mutex" << std::setw(14)
+              << "lock-free" << std::setw(14) << "sequenced cb" << '\n';
+    for (unsigned threads : {1u, 2u, 4u, 8u}) {
+        locked_machine locked;
+        concurrent_t lock_free{0, table};
+        concurrent_t sequenced{0, table};
+        std::uint64_t transitions = 0;
+        sequenced.on_transition([&](const int&, const int&, const int&) { ++transitions; });
+
+        const auto locked_rate = throughput(locked, threads, per_thread);
+        const auto lock_free_rate = throughput(lock_free, threads, per_thread);
+        const auto sequenced_rate = throughput(sequenced, threads, per_thread);
+        bench::do_not_optimize(transitions);
+        std::cout << std::left << std::setw(12) << threads << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << locked_rate << std::setw(14) << lock_free_rate << std::setw(14)
+                  << sequenced_rate << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/state/state_machine.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+using basicpp::core::error;
+
+template <typename TPolicy>
+void fill(basicpp::command::basic_registry<TPolicy, int>& registry) {
+    using registry_t = basicpp::command::basic_registry<TPolicy, int>;
+    for (int i = 0; i < 64; ++i) {
+        registry.register_handler("command_" + std::to_string(i), [i] { return registry_t::handler_result::ok(i); });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using string_registry = basicpp::command::registry<int>;
+    using error_registry = basicpp::command::basic_registry<basicpp::command::registry_policy<error>, int>;
+    using string_machine = basicpp::state::state_machine<int, int>;
+    using error_machine = basicpp::state::state_machine<int, int, basicpp::state::state_machine_policy<error>>;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto operations = bench::scaled(opts, 1'000'000);
+
+    // Keys long enough to defeat the small-string optimisation, as real command names often are.
+    std::vector<std::string> missing_keys;
+    for (int i = 0; i < 16; ++i) {
+        missing_keys.push_back("unknown_command_with_a_long_name_" + std::to_string(i));
+    }
+
+    string_registry strings;
+    error_registry errors;
+    fill(strings);
+    fill(errors);
+
+    bench::print_header("failed dispatch");
+    bench::print(bench::measure(opts, "registry<std::string> miss", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto result = strings.dispatch(missing_keys[i & 15]);
+            bench::do_not_optimize(result);
+        }
+    }));
+    bench::print(bench::measure(opts, "registry<core::error> miss", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto result = errors.dispatch(missing_keys[i & 15]);
+            bench::do_not_optimize(result);
+        }
+    }));
+
+    string_machine string_states{0};
+    error_machine error_states{0};
+    string_states.add_transition(0, 1, 1);
+    error_states.add_transition(0, 1, 1);
+
+    bench::print(bench::measure(opts, "state_machine<std::string> rejected event", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto result = string_states.dispatch(2);
+            bench::do_not_optimize(result);
+        }
+    }));
+    bench::print(bench::measure(opts, "state_machine<core::error> rejected event", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto result = error_states.dispatch(2);
+            bench::do_not_optimize(result);
+        }
+    }));
+
+    return 0;
+}
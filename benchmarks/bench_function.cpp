@@ -0,0 +1,112 @@
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/function_ref.hpp>
+#include <basicpp/core/inplace_function.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+// 48 bytes of captured state: past std::function's small buffer on the common standard libraries.
+struct payload {
+    std::array<long long, 6> values{1, 2, 3, 4, 5, 6};
+};
+
+template <typename F>
+[[gnu::noinline]] long long call_many(const F& fn, std::size_t n) {
+    long long total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        total += fn(static_cast<int>(i & 7));
+    }
+    return total;
+}
+
+[[gnu::noinline]] long long call_many_ref(basicpp::core::function_ref<long long(int)> fn, std::size_t n) {
+    long long total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        total += fn(static_cast<int>(i & 7));
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using inplace = basicpp::core::inplace_function<long long(int), 64>;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto operations = bench::scaled(opts, 2'000'000);
+
+    auto lambda = [p = payload{}](int index) { return p.values[static_cast<std::size_t>(index) % 6]; };
+
+    bench::print_header("construct + destroy (48-byte capture)");
+    bench::print(bench::measure(opts, "std::function", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            std::function<long long(int)> fn = lambda;
+            bench::do_not_optimize(fn);
+        }
+    }));
+    bench::print(bench::measure(opts, "inplace_function<.., 64>", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            inplace fn = lambda;
+            bench::do_not_optimize(fn);
+        }
+    }));
+
+    std::function<long long(int)> std_fn = lambda;
+    inplace inplace_fn = lambda;
+
+    bench::print_header("call");
+    bench::print(bench::measure(opts, "std::function", operations, [&](std::size_t n) {
+        bench::do_not_optimize(call_many(std_fn, n));
+    }));
+    bench::print(bench::measure(opts, "inplace_function<.., 64>", operations, [&](std::size_t n) {
+        bench::do_not_optimize(call_many(inplace_fn, n));
+    }));
+    bench::print(bench::measure(opts, "function_ref", operations, [&](std::size_t n) {
+        bench::do_not_optimize(call_many_ref(lambda, n));
+    }));
+
+    using std_registry = basicpp::command::registry<long long, int>;
+    using inplace_registry =
+        basicpp::command::basic_registry<basicpp::command::inplace_registry_policy<basicpp::core::error, 64>, long long,
+                                         int>;
+
+    std::vector<std::string> keys;
+    for (int i = 0; i < 256; ++i) {
+        keys.push_back("handler_" + std::to_string(i));
+    }
+    const auto registrations = bench::scaled(opts, 2'000);
+
+    bench::print_header("register 256 handlers (48-byte capture)");
+    bench::print(bench::measure(opts, "registry<std::function>", registrations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            std_registry registry;
+            for (const auto& key : keys) {
+                registry.register_handler(key, [p = payload{}](int index) {
+                    return std_registry::handler_result::ok(p.values[static_cast<std::size_t>(index) % 6]);
+                });
+            }
+            bench::do_not_optimize(registry);
+        }
+    }));
+    bench::print(bench::measure(opts, "registry<inplace_function>", registrations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            inplace_registry registry;
+            for (const auto& key : keys) {
+                registry.register_handler(key, [p = payload{}](int index) {
+                    return inplace_registry::handler_result::ok(p.values[static_cast<std::size_t>(index) % 6]);
+                });
+            }
+            bench::do_not_optimize(registry);
+        }
+    }));
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/queue.hpp>
+#include <basicpp/command/registry.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+using registry_t = basicpp::command::registry<std::uint64_t, std::uint64_t>;
+using clock_type = std::chrono::steady_clock;
+
+// Baseline: a mutex-protected deque with a condition variable, drained one command at a time.
+class locked_queue {
+public:
+    void push(std::string_view key, std::uint64_t arg) {
+        {
+            std::lock_guard lock(mutex_);
+            items_.emplace_back(std::string(key), arg);
+        }
+        ready_.notify_one();
+    }
+
+    void run(registry_t& registry, std::stop_token stop) {
+        std::stop_callback wake(stop, [this] {
+            std::lock_guard lock(mutex_);
+            ready_.notify_all();
+        });
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            ready_.wait(lock, [&] { return stop.stop_requested() || !items_.empty(); });
+            if (items_.empty()) {
+                return;
+            }
+            auto [key, arg] = std::move(items_.front());
+            items_.pop_front();
+            lock.unlock();
+            basicpp::bench::do_not_optimize(registry.dispatch(key, arg));
+            lock.lock();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::pair<std::string, std::uint64_t>> items_;
+};
+
+std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count());
+}
+
+// Pushes `per_producer` commands from each of `producers` threads while one consumer runs; returns Mcommands/s.
+template <typename Queue>
+double throughput(Queue& commands, registry_t& registry, unsigned producers, std::size_t per_producer) {
+    const auto began = clock_type::now();
+    std::jthread consumer([&](std::stop_token stop) { commands.run(registry, stop); });
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (std::size_t i = 0; i < per_producer; ++i) {
+                commands.push("tick", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    consumer.request_stop();
+    consumer.join();
+    const auto seconds = std::chrono::duration<double>(clock_type::now() - began).count();
+    return static_cast<double>(producers * per_producer) / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto per_producer = bench::scaled(opts, 200'000);
+
+    registry_t registry;
+    std::uint64_t sink = 0;
+    registry.register_handler("tick", [&sink](std::uint64_t arg) {
+        sink += arg;
+        return registry_t::handler_result::ok(arg);
+    });
+
+    bench::print_section("throughput, one consumer (Mcommands/s)");
+    std::cout << std::left << std::setw(12) << "producers" << std::right << std::setw(14) << "mutex+deque"
+              << std::setw(14) << "queue" << '\n';
+    for (unsigned producers : {1u, 2u, 4u, 8u}) {
+        locked_queue locked;
+        basicpp::command::queue<std::uint64_t> ring(4096);
+        const auto locked_rate = throughput(locked, registry, producers, per_producer);
+        const auto ring_rate = throughput(ring, registry, producers, per_producer);
+        std::cout << std::left << std::setw(12) << producers << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << locked_rate << std::setw(14) << ring_rate << '\n';
+    }
+
+    // Latency: producers stamp each command with the push time; the handler records the delay.
+    const auto samples = std::max<std::size_t>(1000, per_producer / 4);
+    std::vector<std::uint64_t> delays;
+    delays.reserve(samples * 4);
+    registry.register_handler("stamped", [&delays](std::uint64_t pushed) {
+        delays.push_back(now_ns() - pushed);
+        return registry_t::handler_result::ok(pushed);
+    });
+
+    bench::print_section("push-to-dispatch latency, 4 producers pacing 1 command/us each (ns)");
+    {
+        basicpp::command::queue<std::uint64_t> ring(4096);
+        std::jthread consumer([&](std::stop_token stop) { ring.run(registry, stop); });
+        std::vector<std::thread> threads;
+        for (int p = 0; p < 4; ++p) {
+            threads.emplace_back([&] {
+                auto next = clock_type::now();
+                for (std::size_t i = 0; i < samples; ++i) {
+                    next += std::chrono::microseconds(1);
+                    while (clock_type::now() < next) {
+                    }
+                    ring.push("stamped", now_ns());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        consumer.request_stop();
+        consumer.join();
+    }
+    std::sort(delays.begin(), delays.end());
+    bench::print_value("p50", delays[delays.size() / 2], "ns");
+    bench::print_value("p99", delays[delays.size() * 99 / 100], "ns");
+    bench::print_value("max", delays.back(), "ns");
+
+    bench::do_not_optimize(sink);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+using handler_result = basicpp::core::result<int, std::string>;
+
+// The node-based registry layout used before core::flat_hash_map, for comparison.
+class legacy_registry {
+public:
+    using handler_type = std::function<handler_result(int)>;
+
+    void register_handler(std::string key, handler_type handler) {
+        handlers_[std::move(key)] = std::move(handler);
+    }
+
+    handler_result dispatch(const std::string& key, int arg) const {
+        auto it = handlers_.find(key);
+        if (it == handlers_.end()) {
+            return handler_result::err("command not found: " + key);
+        }
+        return it->second(arg);
+    }
+
+private:
+    std::unordered_map<std::string, handler_type> handlers_;
+};
+
+std::vector<std::size_t> access_pattern(std::size_t handlers, std::size_t count) {
+    std::vector<std::size_t> pattern(count);
+    std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (auto& index : pattern) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        index = static_cast<std::size_t>(state % handlers);
+    }
+    return pattern;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using registry_t = basicpp::command::registry<int, int>;
+    using metered_t =
+        basicpp::command::basic_registry<basicpp::command::with_metrics<basicpp::command::registry_policy<>>, int, int>;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto operations = bench::scaled(opts, 1'000'000);
+
+    for (std::size_t handlers : {10u, 100u, 1'000u, 10'000u, 100'000u}) {
+        std::vector<std::string> keys;
+        keys.reserve(handlers);
+        std::string arena;
+        for (std::size_t i = 0; i < handlers; ++i) {
+            keys.push_back("game.command." + std::to_string(i * 7919));
+            arena += keys.back();
+        }
+
+        // string_views into one buffer, as a caller parsing an input line would hold.
+        std::vector<std::string_view> views;
+        views.reserve(handlers);
+        std::size_t offset = 0;
+        for (const auto& key : keys) {
+            views.emplace_back(arena.data() + offset, key.size());
+            offset += key.size();
+        }
+
+        legacy_registry legacy;
+        registry_t flat;
+        metered_t metered;
+        for (std::size_t i = 0; i < handlers; ++i) {
+            const int value = static_cast<int>(i);
+            legacy.register_handler(keys[i], [value](int arg) { return handler_result::ok(value + arg); });
+            flat.register_handler(keys[i], [value](int arg) { return handler_result::ok(value + arg); });
+            metered.register_handler(keys[i], [value](int arg) { return handler_result::ok(value + arg); });
+        }
+
+        std::vector<registry_t::handle> handles;
+        handles.reserve(handlers);
+        for (const auto& key : keys) {
+            handles.push_back(flat.resolve(key));
+        }
+
+        const auto pattern = access_pattern(handlers, 4096);
+        bench::print_header(std::to_string(handlers) + " handlers");
+
+        bench::print(bench::measure(opts, "legacy dispatch(const std::string&)", operations, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(legacy.dispatch(keys[pattern[i & 4095]], 1));
+            }
+        }));
+        bench::print(bench::measure(opts, "legacy dispatch(string_view -> string)", operations, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(legacy.dispatch(std::string(views[pattern[i & 4095]]), 1));
+            }
+        }));
+        bench::print(bench::measure(opts, "flat dispatch(string_view)", operations, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(flat.dispatch(views[pattern[i & 4095]], 1));
+            }
+        }));
+        bench::print(bench::measure(opts, "flat dispatch(handle)", operations, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(flat.dispatch(handles[pattern[i & 4095]], 1));
+            }
+        }));
+
+        bench::print(bench::measure(opts, "metered dispatch(string_view)", operations, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(metered.dispatch(views[pattern[i & 4095]], 1));
+            }
+        }));
+
+        flat.freeze();
+        bench::print(bench::measure(opts, "frozen dispatch(string_view)", operations, [&](std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                bench::do_not_optimize(flat.dispatch(views[pattern[i & 4095]], 1));
+            }
+        }));
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <basicpp/core/result.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+// The optional-pair layout core::result used before it switched to a discriminated union,
+// kept here so the two can be compared side by side.
+template <typename T, typename E>
+class legacy_result {
+public:
+    static legacy_result ok(T value) {
+        legacy_result r;
+        r.value_.emplace(std::move(value));
+        return r;
+    }
+
+    static legacy_result err(E error) {
+        legacy_result r;
+        r.error_.emplace(std::move(error));
+        return r;
+    }
+
+    bool has_value() const noexcept {
+        return value_.has_value();
+    }
+
+    const T& value() const {
+        if (!value_) {
+            throw std::logic_error("legacy_result accessed without value");
+        }
+        return *value_;
+    }
+
+    const E& error() const {
+        if (!error_) {
+            throw std::logic_error("legacy_result accessed without error");
+        }
+        return *error_;
+    }
+
+private:
+    std::optional<T> value_;
+    std::optional<E> error_;
+};
+
+template <template <typename, typename> class R>
+[[gnu::noinline]] R<int, std::string> parse_digit(char ch) {
+    if (ch < '0' || ch > '9') {
+        return R<int, std::string>::err("expected digit");
+    }
+    return R<int, std::string>::ok(ch - '0');
+}
+
+template <template <typename, typename> class R>
+[[gnu::noinline]] R<int, int> checked_add(int lhs, int rhs) {
+    if (rhs > 1000000 - lhs) {
+        return R<int, int>::err(lhs);
+    }
+    return R<int, int>::ok(lhs + rhs);
+}
+
+template <template <typename, typename> class R>
+long long sum_digits(const std::string& input) {
+    long long total = 0;
+    for (char ch : input) {
+        auto digit = parse_digit<R>(ch);
+        if (digit.has_value()) {
+            total += digit.value();
+        } else {
+            total -= static_cast<long long>(digit.error().size());
+        }
+    }
+    return total;
+}
+
+template <template <typename, typename> class R>
+int accumulate(std::size_t operations) {
+    int total = 0;
+    for (std::size_t i = 0; i < operations; ++i) {
+        auto next = checked_add<R>(total, static_cast<int>(i & 7));
+        total = next.has_value() ? next.value() : 0;
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using basicpp::core::result;
+
+    const auto opts = bench::parse_options(argc, argv);
+
+    bench::print_section("sizeof");
+    bench::print_value("legacy<int, int>", sizeof(legacy_result<int, int>), "bytes");
+    bench::print_value("result<int, int>", sizeof(result<int, int>), "bytes");
+    bench::print_value("legacy<int, std::string>", sizeof(legacy_result<int, std::string>), "bytes");
+    bench::print_value("result<int, std::string>", sizeof(result<int, std::string>), "bytes");
+    bench::print_value("legacy<std::string, std::string>", sizeof(legacy_result<std::string, std::string>), "bytes");
+    bench::print_value("result<std::string, std::string>", sizeof(result<std::string, std::string>), "bytes");
+    bench::print_value("result<void, std::string>", sizeof(result<void, std::string>), "bytes");
+
+    const auto operations = bench::scaled(opts, 2'000'000);
+
+    std::string input;
+    input.reserve(operations);
+    for (std::size_t i = 0; i < operations; ++i) {
+        input.push_back(i % 10 == 0 ? 'x' : static_cast<char>('0' + i % 10));
+    }
+
+    bench::print_header("throughput");
+    bench::print(bench::measure(opts, "legacy checked_add (int, int)", operations, [](std::size_t n) {
+        bench::do_not_optimize(accumulate<legacy_result>(n));
+    }));
+    bench::print(bench::measure(opts, "result checked_add (int, int)", operations, [](std::size_t n) {
+        bench::do_not_optimize(accumulate<result>(n));
+    }));
+    bench::print(bench::measure(opts, "legacy parse_digit (10% errors)", operations, [&](std::size_t) {
+        bench::do_not_optimize(sum_digits<legacy_result>(input));
+    }));
+    bench::print(bench::measure(opts, "result parse_digit (10% errors)", operations, [&](std::size_t) {
+        bench::do_not_optimize(sum_digits<result>(input));
+    }));
+
+    std::vector<legacy_result<int, int>> legacy_batch(1024, legacy_result<int, int>::ok(1));
+    std::vector<result<int, int>> compact_batch(1024, result<int, int>::ok(1));
+    const auto copies = bench::scaled(opts, 2'000);
+    bench::print(bench::measure(opts, "legacy copy 1024 x <int, int>", copies, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto copy = legacy_batch;
+            bench::do_not_optimize(copy.data());
+        }
+    }));
+    bench::print(bench::measure(opts, "result copy 1024 x <int, int>", copies, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            auto copy = compact_batch;
+            bench::do_not_optimize(copy.data());
+        }
+    }));
+
+    return 0;
+}
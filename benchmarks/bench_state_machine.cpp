@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <basicpp/state/dense_state_machine.hpp>
+#include <basicpp/state/state_machine.hpp>
+#include <basicpp/state/state_machine_pool.hpp>
+#include <basicpp/state/transition_trace.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+constexpr int state_count = 64;
+constexpr int event_count = 8;
+
+// Every state has a transition on every event, so each dispatch succeeds.
+template <typename Machine>
+void wire(Machine& machine) {
+    for (int state = 0; state < state_count; ++state) {
+        for (int event = 0; event < event_count; ++event) {
+            machine.add_transition(state, event, (state * 7 + event * 13 + 1) % state_count);
+        }
+    }
+}
+
+std::vector<int> event_stream(std::size_t count) {
+    std::vector<int> events(count);
+    std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (auto& event : events) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        event = static_cast<int>(state % event_count);
+    }
+    return events;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using hashed_t = basicpp::state::state_machine<int, int>;
+    using dense_t = basicpp::state::dense_state_machine<int, int, state_count, event_count>;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto operations = bench::scaled(opts, 2'000'000);
+    const auto events = event_stream(4096);
+
+    hashed_t hashed{0};
+    dense_t dense{0};
+    wire(hashed);
+    wire(dense);
+
+    bench::print_header("dispatch, 64 states x 8 events, no callback");
+    bench::print(bench::measure(opts, "state_machine (unordered_map)", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(hashed.dispatch(events[i & 4095]));
+        }
+    }));
+    bench::print(bench::measure(opts, "dense_state_machine", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(dense.dispatch(events[i & 4095]));
+        }
+    }));
+
+    std::uint64_t transitions = 0;
+    hashed.on_transition([&](const int&, const int&, const int&) { ++transitions; });
+    dense.on_transition([&](const int&, const int&, const int&) { ++transitions; });
+
+    bench::print_header("dispatch with a std::function callback");
+    bench::print(bench::measure(opts, "state_machine (unordered_map)", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(hashed.dispatch(events[i & 4095]));
+        }
+    }));
+    bench::print(bench::measure(opts, "dense_state_machine", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(dense.dispatch(events[i & 4095]));
+        }
+    }));
+    bench::do_not_optimize(transitions);
+
+    // Tracing through observers instead of the callback slot.
+    dense_t plain{0, dense.table()};
+    dense_t traced{0, dense.table()};
+    dense_t cycle_traced{0, dense.table()};
+    basicpp::state::transition_trace<int, int> trace;
+    basicpp::state::transition_trace<int, int, 1024, basicpp::state::cycle_clock> cycle_trace;
+    traced.add_observer(trace);
+    cycle_traced.add_observer(cycle_trace);
+
+    bench::print_header("dense_state_machine dispatch with a transition_trace observer");
+    bench::print(bench::measure(opts, "no observer", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(plain.dispatch(events[i & 4095]));
+        }
+    }));
+    bench::print(bench::measure(opts, "trace, steady_clock", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(traced.dispatch(events[i & 4095]));
+        }
+    }));
+    bench::print(bench::measure(opts, "trace, cycle_clock", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            bench::do_not_optimize(cycle_traced.dispatch(events[i & 4095]));
+        }
+    }));
+    bench::do_not_optimize(trace.recorded() + cycle_trace.recorded());
+
+    // Population of identical machines, one event per instance per step.
+    using pool_t = basicpp::state::state_machine_pool<int, int, state_count, event_count>;
+    const std::size_t instances = opts.scale == 0 ? 4096 : 200'000;
+    const auto steps = std::max<std::size_t>(1, operations / instances);
+
+    dense_t::table_type table;
+    for (int state = 0; state < state_count; ++state) {
+        for (int event = 0; event < event_count; ++event) {
+            table.add_transition(state, event, (state * 7 + event * 13 + 1) % state_count);
+        }
+    }
+    std::vector<dense_t> machines(instances, dense_t{0, table});
+    pool_t pool{table, instances, 0};
+    std::vector<int> population_events(instances);
+    for (std::size_t i = 0; i < instances; ++i) {
+        population_events[i] = events[i & 4095];
+    }
+
+    bench::print_section("population of " + std::to_string(instances) + " machines");
+    bench::print_value("dense_state_machine bytes/instance", sizeof(dense_t), "B");
+    bench::print_value("state_machine_pool bytes/instance", sizeof(pool_t::cell_type), "B");
+
+    bench::print_header("one event per instance (ns per instance)");
+    bench::print(bench::measure(opts, "vector<dense_state_machine>", steps * instances, [&](std::size_t n) {
+        for (std::size_t step = 0; step < n / instances; ++step) {
+            for (std::size_t i = 0; i < instances; ++i) {
+                bench::do_not_optimize(machines[i].dispatch(population_events[i]));
+            }
+        }
+    }));
+    bench::print(bench::measure(opts, "pool.dispatch_all", steps * instances, [&](std::size_t n) {
+        for (std::size_t step = 0; step < n / instances; ++step) {
+            bench::do_not_optimize(pool.dispatch_all(population_events));
+        }
+    }));
+    bench::print(bench::measure(opts, "pool.dispatch_all (parallel)", steps * instances, [&](std::size_t n) {
+        for (std::size_t step = 0; step < n / instances; ++step) {
+            bench::do_not_optimize(pool.dispatch_all(population_events, basicpp::state::parallel_dispatch{}));
+        }
+    }));
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <basicpp/command/command.hpp>
+#include <basicpp/command/static_command.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+struct machine {
+    std::uint64_t* accumulator;
+};
+
+using result_type = basicpp::command::command<machine>::result_type;
+
+// The same four commands written against the virtual interface and as plain value types.
+namespace virtual_impl {
+    struct add final : basicpp::command::command<machine> {
+        explicit add(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) override {
+            *m.accumulator += value;
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+
+    struct multiply final : basicpp::command::command<machine> {
+        explicit multiply(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) override {
+            *m.accumulator *= value;
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+
+    struct mix final : basicpp::command::command<machine> {
+        explicit mix(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) override {
+            *m.accumulator ^= *m.accumulator >> value;
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+
+    struct rotate final : basicpp::command::command<machine> {
+        explicit rotate(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) override {
+            *m.accumulator = (*m.accumulator << value) | (*m.accumulator >> (64 - value));
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+} // namespace virtual_impl
+
+namespace static_impl {
+    struct add : basicpp::command::static_command<add, machine> {
+        explicit add(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) {
+            *m.accumulator += value;
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+
+    struct multiply : basicpp::command::static_command<multiply, machine> {
+        explicit multiply(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) {
+            *m.accumulator *= value;
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+
+    struct mix : basicpp::command::static_command<mix, machine> {
+        explicit mix(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) {
+            *m.accumulator ^= *m.accumulator >> value;
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+
+    struct rotate : basicpp::command::static_command<rotate, machine> {
+        explicit rotate(std::uint64_t v) : value(v) {}
+        result_type execute(const machine& m) {
+            *m.accumulator = (*m.accumulator << value) | (*m.accumulator >> (64 - value));
+            return result_type::ok();
+        }
+        std::uint64_t value;
+    };
+} // namespace static_impl
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+
+    const auto opts = bench::parse_options(argc, argv);
+    constexpr std::size_t program_size = 4096;
+    const auto rounds = std::max<std::size_t>(1, bench::scaled(opts, 2'000));
+
+    // The same pseudo-random program in both representations.
+    std::vector<std::unique_ptr<basicpp::command::command<machine>>> virtual_program;
+    basicpp::command::command_set<machine, static_impl::add, static_impl::multiply, static_impl::mix,
+                                  static_impl::rotate>
+        static_program;
+    static_program.reserve(program_size);
+    std::uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (std::size_t i = 0; i < program_size; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const auto operand = 1 + (state >> 8) % 31;
+        switch (state % 4) {
+        case 0:
+            virtual_program.push_back(std::make_unique<virtual_impl::add>(operand));
+            static_program.emplace<static_impl::add>(operand);
+            break;
+        case 1:
+            virtual_program.push_back(std::make_unique<virtual_impl::multiply>(operand | 1));
+            static_program.emplace<static_impl::multiply>(operand | 1);
+            break;
+        case 2:
+            virtual_program.push_back(std::make_unique<virtual_impl::mix>(operand));
+            static_program.emplace<static_impl::mix>(operand);
+            break;
+        default:
+            virtual_program.push_back(std::make_unique<virtual_impl::rotate>(operand));
+            static_program.emplace<static_impl::rotate>(operand);
+            break;
+        }
+    }
+
+    bench::print_header("execute a 4096-command program (4 command types, random order)");
+    bench::print(bench::measure(opts, "virtual command<T> via unique_ptr", rounds * program_size, [&](std::size_t n) {
+        std::uint64_t accumulator = 1;
+        const machine context{&accumulator};
+        for (std::size_t round = 0; round < n / program_size; ++round) {
+            for (auto& command : virtual_program) {
+                bench::do_not_optimize(command->execute(context));
+            }
+        }
+        bench::do_not_optimize(accumulator);
+    }));
+    bench::print(bench::measure(opts, "command_set (std::visit)", rounds * program_size, [&](std::size_t n) {
+        std::uint64_t accumulator = 1;
+        const machine context{&accumulator};
+        for (std::size_t round = 0; round < n / program_size; ++round) {
+            bench::do_not_optimize(static_program.execute_all(context));
+        }
+        bench::do_not_optimize(accumulator);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal harness shared by the micro-benchmarks in this directory. Each benchmark is a plain
+// executable; pass `--scale N` to multiply iteration counts (or `--scale 0` for a smoke run).
+namespace basicpp::bench {
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(_MSC_VER)
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>(&value);
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+inline void clobber_memory() {
+#if defined(_MSC_VER)
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct options {
+    std::size_t scale = 1;
+    std::size_t samples = 7;
+};
+
+inline options parse_options(int argc, char** argv) {
+    options parsed;
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view arg = argv[index];
+        if (arg == "--scale" && index + 1 < argc) {
+            parsed.scale = static_cast<std::size_t>(std::strtoull(argv[++index], nullptr, 10));
+        } else if (arg == "--samples" && index + 1 < argc) {
+            parsed.samples = std::max<std::size_t>(1, std::strtoull(argv[++index], nullptr, 10));
+        }
+    }
+    if (parsed.scale == 0) {
+        parsed.samples = 1;
+    }
+    return parsed;
+}
+
+inline std::size_t scaled(const options& opts, std::size_t iterations) {
+    return opts.scale == 0 ? std::max<std::size_t>(1, iterations / 1000) : iterations * opts.scale;
+}
+
+struct measurement {
+    std::string name;
+    std::size_t operations = 0;
+    double median_ns_per_op = 0.0;
+    double min_ns_per_op = 0.0;
+};
+
+// Runs `body(operations)` once to warm up and then `opts.samples` times, reporting per-operation cost.
+template <typename Body>
+measurement measure(const options& opts, std::string name, std::size_t operations, Body&& body) {
+    using clock = std::chrono::steady_clock;
+
+    body(operations);
+
+    std::vector<double> samples;
+    samples.reserve(opts.samples);
+    for (std::size_t sample = 0; sample < opts.samples; ++sample) {
+        const auto start = clock::now();
+        body(operations);
+        const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        samples.push_back(elapsed / static_cast<double>(std::max<std::size_t>(1, operations)));
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return measurement{std::move(name), operations, samples[samples.size() / 2], samples.front()};
+}
+
+inline void print_header(std::string_view title) {
+    std::cout << "\n== " << title << " ==\n";
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right << std::setw(14) << "median ns/op"
+              << std::setw(14) << "min ns/op" << '\n';
+}
+
+inline void print(const measurement& m) {
+    std::cout << std::left << std::setw(44) << m.name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << m.median_ns_per_op << std::setw(14) << m.min_ns_per_op << '\n';
+}
+
+inline void print_section(std::string_view title) {
+    std::cout << "\n== " << title << " ==\n";
+}
+
+inline void print_value(std::string_view name, std::size_t value, std::string_view unit) {
+    std::cout << std::left << std::setw(44) << name << std::right << std::setw(14) << value << ' ' << unit << '\n';
+}
+
+} // namespace basicpp::bench
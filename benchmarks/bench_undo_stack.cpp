@@ -0,0 +1,120 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <basicpp/history/undo_stack.hpp>
+
+#include "bench_support.hpp"
+
+namespace {
+
+// The straightforward alternative: a vector of full copies and an index, trimmed from the front.
+class snapshot_vector {
+public:
+    explicit snapshot_vector(std::string initial, std::size_t max_entries)
+        : states_{std::move(initial)}, max_entries_(max_entries) {
+    }
+
+    void push(std::string next) {
+        states_.resize(cursor_ + 1);
+        states_.push_back(std::move(next));
+        ++cursor_;
+        if (states_.size() > max_entries_ + 1) {
+            states_.erase(states_.begin());
+            --cursor_;
+        }
+    }
+
+    bool undo() {
+        return cursor_ != 0 ? (--cursor_, true) : false;
+    }
+
+    const std::string& current() const {
+        return states_[cursor_];
+    }
+
+private:
+    std::vector<std::string> states_;
+    std::size_t cursor_ = 0;
+    std::size_t max_entries_;
+};
+
+// One small edit per push to a 64 KB document.
+void edit(std::string& document, std::size_t step) {
+    document[(step * 7919) % document.size()] = static_cast<char>('a' + step % 26);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    namespace bench = basicpp::bench;
+    using basicpp::history::history_limits;
+
+    const auto opts = bench::parse_options(argc, argv);
+    const auto operations = bench::scaled(opts, 20'000);
+    const std::string document(64 * 1024, 'x');
+    constexpr std::size_t entries = 256;
+
+    bench::print_header("push one edit to a 64 KB document, 256 steps retained (ns per push)");
+    bench::print(bench::measure(opts, "vector of snapshots", operations, [&](std::size_t n) {
+        snapshot_vector history{document, entries};
+        auto next = document;
+        for (std::size_t i = 0; i < n; ++i) {
+            edit(next, i);
+            history.push(next);
+        }
+        bench::do_not_optimize(history.current().size());
+    }));
+    bench::print(bench::measure(opts, "undo_stack, snapshot_delta", operations, [&](std::size_t n) {
+        basicpp::history::undo_stack<std::string> history{document, history_limits{entries, 0}};
+        auto next = document;
+        for (std::size_t i = 0; i < n; ++i) {
+            edit(next, i);
+            history.push(next);
+        }
+        bench::do_not_optimize(history.bytes());
+    }));
+    bench::print(bench::measure(opts, "undo_stack, splice_delta", operations, [&](std::size_t n) {
+        basicpp::history::undo_stack<std::string, basicpp::history::splice_delta<std::string>> history{
+            document, history_limits{entries, 0}};
+        auto next = document;
+        for (std::size_t i = 0; i < n; ++i) {
+            edit(next, i);
+            history.push(next);
+        }
+        bench::do_not_optimize(history.bytes());
+    }));
+
+    bench::print_header("undo then redo across the full history (ns per step)");
+    basicpp::history::undo_stack<std::string> snapshots{document, history_limits{entries, 0}};
+    basicpp::history::undo_stack<std::string, basicpp::history::splice_delta<std::string>> splices{
+        document, history_limits{entries, 0}};
+    auto next = document;
+    for (std::size_t i = 0; i < entries; ++i) {
+        edit(next, i);
+        snapshots.push(next);
+        splices.push(next);
+    }
+    bench::print_value("snapshot_delta bytes retained", snapshots.bytes(), "B");
+    bench::print_value("splice_delta bytes retained", splices.bytes(), "B");
+    bench::print(bench::measure(opts, "undo_stack, snapshot_delta", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!snapshots.undo()) {
+                while (snapshots.redo()) {
+                }
+            }
+        }
+        bench::do_not_optimize(snapshots.current().size());
+    }));
+    bench::print(bench::measure(opts, "undo_stack, splice_delta", operations, [&](std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!splices.undo()) {
+                while (splices.redo()) {
+                }
+            }
+        }
+        bench::do_not_optimize(splices.current().size());
+    }));
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include <basicpp/core/result.hpp>
+#include <basicpp/core/task.hpp>
+
+namespace basicpp::command {
+
+// Asynchronous counterpart of command<TContext>: execute_async() is a coroutine, so an implementation
+// can suspend on other tasks or hop executors without blocking the caller. The context must outlive the task.
+template <typename TContext>
+class async_command {
+public:
+    using context_type = TContext;
+    using result_type = core::result<void, std::string>;
+
+    virtual ~async_command() = default;
+    virtual core::task<result_type> execute_async(const context_type& context) = 0;
+};
+
+} // namespace basicpp::command
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/executor.hpp>
+#include <basicpp/core/flat_hash_map.hpp>
+#include <basicpp/core/result.hpp>
+#include <basicpp/core/task.hpp>
+
+namespace basicpp::command {
+
+// Registry whose handlers are coroutines returning core::task<result<TResult, E>>.
+//
+// dispatch() looks the key up immediately and returns a lazy task; awaiting it moves onto the registry's
+// executor and then runs the handler, so a handler that suspends (on another task, or by scheduling
+// elsewhere) frees its thread for other commands. The task keeps the handler alive, so handlers may be
+// replaced or unregistered while commands they started are still in flight.
+// Arguments are stored in the task by value; reference arguments must outlive the task.
+// Registration is not synchronised with dispatch: mutate the registry from one thread at a time.
+template <typename TPolicy, typename TResult, typename... TArgs>
+class basic_async_registry {
+public:
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using handler_result = core::result<TResult, error_type>;
+    using task_type = core::task<handler_result>;
+    using handler_type = typename TPolicy::template function_type<task_type(TArgs...)>;
+
+    explicit basic_async_registry(core::executor& executor = core::inline_executor::instance()) noexcept
+        : executor_(&executor) {
+    }
+
+    bool register_handler(std::string key, handler_type handler) {
+        auto shared = std::make_shared<const handler_type>(std::move(handler));
+        const auto [slot, inserted] = handlers_.try_emplace(std::move(key), shared);
+        if (!inserted) {
+            *slot = std::move(shared);
+        }
+        return inserted;
+    }
+
+    void unregister_handler(std::string_view key) {
+        handlers_.erase(key);
+    }
+
+    bool contains(std::string_view key) const {
+        return handlers_.contains(key);
+    }
+
+    task_type dispatch(std::string_view key, TArgs... args) const {
+        const auto* handler = handlers_.find(key);
+        if (!handler) {
+            return fail(core::error_factory<error_type>::make(core::errc::command_not_found, "command not found", key));
+        }
+        return run(*handler, *executor_, std::forward<TArgs>(args)...);
+    }
+
+    std::vector<std::string> keys() const {
+        std::vector<std::string> result;
+        result.reserve(handlers_.size());
+        handlers_.for_each([&](const std::string& key, const auto&) { result.push_back(key); });
+        return result;
+    }
+
+    std::size_t size() const noexcept {
+        return handlers_.size();
+    }
+
+    core::executor& executor() const noexcept {
+        return *executor_;
+    }
+
+private:
+    static task_type fail(error_type error) {
+        co_return handler_result::err(std::move(error));
+    }
+
+    static task_type run(std::shared_ptr<const handler_type> handler, core::executor& target, TArgs... args) {
+        co_await core::schedule(target);
+        co_return co_await (*handler)(std::forward<TArgs>(args)...);
+    }
+
+    core::flat_hash_map<std::string, std::shared_ptr<const handler_type>, core::string_hash, std::equal_to<>> handlers_;
+    core::executor* executor_;
+};
+
+template <typename TResult, typename... TArgs>
+using async_registry = basic_async_registry<registry_policy<>, TResult, TArgs...>;
+
+} // namespace basicpp::command
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/flat_hash_map.hpp>
+#include <basicpp/core/perfect_hash.hpp>
+#include <basicpp/core/rcu.hpp>
+#include <basicpp/core/result.hpp>
+
+namespace basicpp::command {
+
+// Thread-safe registry for many dispatching threads and occasional handler hot-swaps.
+//
+// Readers work on an immutable snapshot (a perfect-hash index plus shared handler pointers) published
+// through an atomic pointer and protected by a core::rcu_domain: dispatch, contains and size are
+// wait-free. Mutations serialise on a mutex, publish a new snapshot, wait for readers of the old one to
+// finish, and then free it. A handler therefore must not register or unregister handlers on the registry
+// that is dispatching it; that would wait on itself.
+template <typename TPolicy, typename TResult, typename... TArgs>
+class basic_concurrent_registry {
+public:
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using handler_result = core::result<TResult, error_type>;
+    using handler_type = typename TPolicy::template function_type<handler_result(TArgs...)>;
+
+    basic_concurrent_registry()
+        : current_(new snapshot) {
+    }
+
+    basic_concurrent_registry(const basic_concurrent_registry&) = delete;
+    basic_concurrent_registry& operator=(const basic_concurrent_registry&) = delete;
+
+    ~basic_concurrent_registry() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    bool register_handler(std::string key, handler_type handler) {
+        std::lock_guard lock(write_mutex_);
+        auto shared = std::make_shared<const handler_type>(std::move(handler));
+        const auto [slot, inserted] = handlers_.try_emplace(std::move(key), shared);
+        if (!inserted) {
+            *slot = std::move(shared);
+        }
+        publish();
+        return inserted;
+    }
+
+    void unregister_handler(std::string_view key) {
+        std::lock_guard lock(write_mutex_);
+        if (handlers_.erase(key)) {
+            publish();
+        }
+    }
+
+    bool contains(std::string_view key) const {
+        core::rcu_domain::read_guard guard(domain_);
+        return current_.load(std::memory_order_seq_cst)->find(key) != core::perfect_hash::npos;
+    }
+
+    handler_result dispatch(std::string_view key, TArgs... args) const {
+        core::rcu_domain::read_guard guard(domain_);
+        const auto* view = current_.load(std::memory_order_seq_cst);
+        const auto index = view->find(key);
+        if (index == core::perfect_hash::npos) {
+            return handler_result::err(
+                core::error_factory<error_type>::make(core::errc::command_not_found, "command not found", key));
+        }
+        return (*view->handlers[index])(std::forward<TArgs>(args)...);
+    }
+
+    std::vector<std::string> keys() const {
+        std::lock_guard lock(write_mutex_);
+        std::vector<std::string> result;
+        result.reserve(handlers_.size());
+        handlers_.for_each([&](const std::string& key, const auto&) { result.push_back(key); });
+        return result;
+    }
+
+    std::size_t size() const {
+        core::rcu_domain::read_guard guard(domain_);
+        return current_.load(std::memory_order_seq_cst)->handlers.size();
+    }
+
+private:
+    struct snapshot {
+        core::perfect_hash index;
+        // Used instead of `index` in the unlikely case that the perfect hash cannot be built.
+        core::flat_hash_map<std::string, std::uint32_t, core::string_hash, std::equal_to<>> fallback;
+        bool hashed = true;
+        std::vector<std::shared_ptr<const handler_type>> handlers;
+
+        std::uint32_t find(std::string_view key) const noexcept {
+            if (hashed) {
+                return index.find(key);
+            }
+            const auto* found = fallback.find(key);
+            return found ? *found : core::perfect_hash::npos;
+        }
+    };
+
+    // Called with write_mutex_ held.
+    void publish() {
+        auto next = std::make_unique<snapshot>();
+        std::vector<std::string_view> keys;
+        keys.reserve(handlers_.size());
+        next->handlers.reserve(handlers_.size());
+        handlers_.for_each([&](const std::string& key, const std::shared_ptr<const handler_type>& handler) {
+            keys.push_back(key);
+            next->handlers.push_back(handler);
+        });
+        // Registered keys are distinct, so the build only fails on pathological hash collisions; the
+        // snapshot then indexes its keys with a flat map rather than publishing an empty index.
+        if (!next->index.build(keys)) {
+            next->hashed = false;
+            next->fallback.reserve(keys.size());
+            for (std::uint32_t i = 0; i < keys.size(); ++i) {
+                next->fallback.try_emplace(std::string(keys[i]), i);
+            }
+        }
+
+        const auto* previous = current_.exchange(next.release(), std::memory_order_seq_cst);
+        domain_.synchronize();
+        delete previous;
+    }
+
+    core::flat_hash_map<std::string, std::shared_ptr<const handler_type>, core::string_hash, std::equal_to<>> handlers_;
+    std::atomic<snapshot*> current_;
+    core::rcu_domain domain_;
+    mutable std::mutex write_mutex_;
+};
+
+template <typename TResult, typename... TArgs>
+using concurrent_registry = basic_concurrent_registry<registry_policy<>, TResult, TArgs...>;
+
+} // namespace basicpp::command
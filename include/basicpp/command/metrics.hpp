@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace basicpp::command {
+
+// Log-bucketed latency histogram in nanoseconds (HDR style): values below 8 get exact buckets, larger
+// values get 8 sub-buckets per power of two, so any recorded value is known to within 12.5%.
+// Values of 2^40 ns (~18 minutes) and above share the last bucket.
+class latency_histogram {
+public:
+    static constexpr unsigned sub_bits = 3;
+    static constexpr std::uint64_t sub_count = 1u << sub_bits;
+    static constexpr unsigned max_bits = 40;
+    static constexpr std::size_t bucket_count = (max_bits - sub_bits + 1) * sub_count;
+
+    static constexpr std::size_t bucket_of(std::uint64_t ns) noexcept {
+        if (ns < sub_count) {
+            return static_cast<std::size_t>(ns);
+        }
+        ns = std::min<std::uint64_t>(ns, (std::uint64_t{1} << max_bits) - 1);
+        const auto msb = static_cast<unsigned>(std::bit_width(ns)) - 1;
+        const auto shift = msb - sub_bits;
+        return static_cast<std::size_t>((shift + 1) * sub_count + ((ns >> shift) & (sub_count - 1)));
+    }
+
+    // Largest value that maps to `bucket`.
+    static constexpr std::uint64_t bucket_upper(std::size_t bucket) noexcept {
+        if (bucket < sub_count) {
+            return bucket;
+        }
+        const auto shift = bucket / sub_count - 1;
+        const auto lower = (sub_count + bucket % sub_count) << shift;
+        return lower + (std::uint64_t{1} << shift) - 1;
+    }
+
+    void record(std::uint64_t ns, std::uint64_t count = 1) noexcept {
+        counts_[bucket_of(ns)] += count;
+        total_ += count;
+    }
+
+    void merge(const latency_histogram& other) noexcept {
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+    }
+
+    std::uint64_t count() const noexcept {
+        return total_;
+    }
+
+    std::uint64_t bucket(std::size_t index) const noexcept {
+        return counts_[index];
+    }
+
+    // Upper bound of the bucket holding the q-quantile (0 <= q <= 1); 0 when empty.
+    std::uint64_t percentile(double q) const noexcept {
+        if (total_ == 0) {
+            return 0;
+        }
+        const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * static_cast<double>(total_) + 0.5));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return bucket_upper(i);
+            }
+        }
+        return bucket_upper(bucket_count - 1);
+    }
+
+private:
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t total_ = 0;
+};
+
+// Merged statistics of one registered key.
+struct key_metrics {
+    std::string key;
+    std::uint64_t calls = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+    latency_histogram latency;
+
+    double mean_ns() const noexcept {
+        return calls == 0 ? 0.0 : static_cast<double>(total_ns) / static_cast<double>(calls);
+    }
+
+    // Histogram quantile, clamped to the exact maximum.
+    std::uint64_t percentile_ns(double q) const noexcept {
+        return std::min(latency.percentile(q), max_ns);
+    }
+};
+
+// Point-in-time copy of a registry's metrics, one entry per registered key, sorted by key.
+struct metrics_snapshot {
+    std::vector<key_metrics> keys;
+
+    const key_metrics* find(std::string_view key) const noexcept {
+        const auto it = std::lower_bound(keys.begin(), keys.end(), key,
+                                         [](const key_metrics& item, std::string_view value) { return item.key < value; });
+        return it != keys.end() && it->key == key ? &*it : nullptr;
+    }
+
+    // One line per key: calls, errors, mean / p50 / p90 / p99 / max latency in nanoseconds.
+    std::string to_text() const {
+        std::string out = "key calls errors mean_ns p50_ns p90_ns p99_ns max_ns\n";
+        for (const auto& item : keys) {
+            out += item.key;
+            for (const auto value : {item.calls, item.errors, static_cast<std::uint64_t>(item.mean_ns()),
+                                     item.percentile_ns(0.5), item.percentile_ns(0.9), item.percentile_ns(0.99),
+                                     item.max_ns}) {
+                out += ' ';
+                out += std::to_string(value);
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+    std::string to_json() const {
+        std::string out = "{\"commands\":[";
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const auto& item = keys[i];
+            out += i == 0 ? "{" : ",{";
+            out += "\"key\":";
+            append_json_string(out, item.key);
+            append_json_field(out, "calls", item.calls);
+            append_json_field(out, "errors", item.errors);
+            append_json_field(out, "mean_ns", static_cast<std::uint64_t>(item.mean_ns()));
+            append_json_field(out, "p50_ns", item.percentile_ns(0.5));
+            append_json_field(out, "p90_ns", item.percentile_ns(0.9));
+            append_json_field(out, "p99_ns", item.percentile_ns(0.99));
+            append_json_field(out, "max_ns", item.max_ns);
+            out += '}';
+        }
+        out += "]}";
+        return out;
+    }
+
+private:
+    static void append_json_field(std::string& out, const char* name, std::uint64_t value) {
+        out += ",\"";
+        out += name;
+        out += "\":";
+        out += std::to_string(value);
+    }
+
+    static void append_json_string(std::string& out, std::string_view value) {
+        static constexpr char hex[] = "0123456789abcdef";
+        out += '"';
+        for (const char c : value) {
+            const auto byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (byte < 0x20) {
+                out += "\\u00";
+                out += hex[byte >> 4];
+                out += hex[byte & 0xF];
+            } else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+};
+
+// Default metrics hook: records nothing, and basic_registry compiles every use of it away.
+struct no_metrics {
+    static constexpr bool enabled = false;
+};
+
+// Per-key call counts, error counts and latency histograms for basic_registry.
+//
+// Each slot keeps one statistics block per shard; a thread always writes the shard picked for it on first
+// use, with relaxed atomic increments and no locks. Blocks are allocated on a shard's first record for a
+// key, so keys dispatched from few threads stay small (a block is ~2.5 KB). collect() merges the shards.
+// reset() runs on the mutating thread while no dispatch is in progress, matching basic_registry's rules.
+class dispatch_metrics {
+public:
+    static constexpr bool enabled = true;
+    static constexpr std::size_t shard_count = 16;
+
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point start() const noexcept {
+        return clock::now();
+    }
+
+    void record(std::uint32_t slot, clock::time_point started, bool ok) const {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - started).count();
+        const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(0, elapsed));
+
+        auto& cell = slots_[slot]->shards[this_thread_shard()];
+        auto* block = cell.load(std::memory_order_acquire);
+        if (!block) {
+            auto fresh = std::make_unique<shard_block>();
+            if (cell.compare_exchange_strong(block, fresh.get(), std::memory_order_acq_rel)) {
+                block = fresh.release();
+            }
+        }
+
+        block->calls.fetch_add(1, std::memory_order_relaxed);
+        if (!ok) {
+            block->errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        block->total_ns.fetch_add(ns, std::memory_order_relaxed);
+        block->buckets[latency_histogram::bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        for (auto seen = block->max_ns.load(std::memory_order_relaxed);
+             ns > seen && !block->max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed);) {
+        }
+    }
+
+    // Starts `slot` from zero; called when a key is bound to it.
+    void reset(std::uint32_t slot) {
+        if (slot >= slots_.size()) {
+            slots_.resize(slot + 1);
+        }
+        slots_[slot] = std::make_unique<slot_stats>();
+    }
+
+    key_metrics collect(std::uint32_t slot, std::string_view key) const {
+        key_metrics result;
+        result.key = std::string(key);
+        if (slot >= slots_.size() || !slots_[slot]) {
+            return result;
+        }
+        for (const auto& cell : slots_[slot]->shards) {
+            const auto* block = cell.load(std::memory_order_acquire);
+            if (!block) {
+                continue;
+            }
+            result.calls += block->calls.load(std::memory_order_relaxed);
+            result.errors += block->errors.load(std::memory_order_relaxed);
+            result.total_ns += block->total_ns.load(std::memory_order_relaxed);
+            result.max_ns = std::max(result.max_ns, block->max_ns.load(std::memory_order_relaxed));
+            for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i) {
+                if (const auto count = block->buckets[i].load(std::memory_order_relaxed)) {
+                    result.latency.record(latency_histogram::bucket_upper(i), count);
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    struct shard_block {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> errors{0};
+        std::atomic<std::uint64_t> total_ns{0};
+        std::atomic<std::uint64_t> max_ns{0};
+        std::array<std::atomic<std::uint64_t>, latency_histogram::bucket_count> buckets{};
+    };
+
+    struct slot_stats {
+        std::array<std::atomic<shard_block*>, shard_count> shards{};
+
+        ~slot_stats() {
+            for (auto& cell : shards) {
+                delete cell.load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    static std::size_t this_thread_shard() noexcept {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t shard = next.fetch_add(1, std::memory_order_relaxed) % shard_count;
+        return shard;
+    }
+
+    std::vector<std::unique_ptr<slot_stats>> slots_;
+};
+
+// Adds metrics to a registry policy: basic_registry<with_metrics<registry_policy<>>, R, Args...>.
+template <typename TPolicy, typename TMetrics = dispatch_metrics>
+struct with_metrics : TPolicy {
+    using metrics_type = TMetrics;
+};
+
+namespace detail {
+    template <typename TPolicy>
+    struct policy_metrics {
+        using type = no_metrics;
+    };
+
+    template <typename TPolicy>
+        requires requires { typename TPolicy::metrics_type; }
+    struct policy_metrics<TPolicy> {
+        using type = typename TPolicy::metrics_type;
+    };
+} // namespace detail
+
+} // namespace basicpp::command
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace basicpp::command {
+
+// What queue::push does when the ring is full.
+enum class backpressure {
+    block,     // wait for the consumer to make room
+    drop,      // reject the new command
+    overwrite, // evict the oldest pending command
+};
+
+// Bounded ring of (key, args) commands posted by any number of producer threads and executed by one
+// consumer thread that owns the application state (a UI or game loop).
+//
+// Each cell carries a sequence number (Vyukov's bounded queue): producers claim a cell with one CAS on
+// the tail and publish it by bumping the sequence, so pushes never take a lock. The consumer side runs
+// on a single thread and moves each entry out of its cell before dispatching it through any registry
+// exposing dispatch(std::string_view, TArgs...), so a slow handler never holds a slot. In overwrite mode
+// producers also pop, so the consumer then claims entries with a CAS as well. Keys are copied into the entry; args are stored by value.
+template <typename... TArgs>
+class queue {
+public:
+    static constexpr std::size_t unlimited = static_cast<std::size_t>(-1);
+
+    // Capacity is rounded up to a power of two (at least 2).
+    explicit queue(std::size_t capacity, backpressure mode = backpressure::block)
+        : mode_(mode) {
+        std::size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        capacity_ = rounded;
+        mask_ = rounded - 1;
+        cells_ = std::make_unique<cell[]>(rounded);
+        for (std::size_t i = 0; i < rounded; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    queue(const queue&) = delete;
+    queue& operator=(const queue&) = delete;
+
+    ~queue() {
+        std::size_t pos;
+        while (claim(pos)) {
+            release(pos);
+        }
+    }
+
+    // Returns false when the command was rejected (drop mode only).
+    bool push(std::string_view key, TArgs... args) {
+        // Built before a cell is claimed, so an allocation failure cannot leave a claimed cell unpublished.
+        entry pending{std::string(key), std::tuple<TArgs...>(std::move(args)...)};
+        for (unsigned spins = 0;; ++spins) {
+            if (try_enqueue(pending)) {
+                // Only the first producer to find the consumer asleep pays for the wake-up.
+                if (sleeping_.load(std::memory_order_seq_cst) && sleeping_.exchange(false, std::memory_order_seq_cst)) {
+                    wake_.fetch_add(1, std::memory_order_seq_cst);
+                    wake_.notify_one();
+                }
+                return true;
+            }
+            if (mode_ == backpressure::drop) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (mode_ == backpressure::overwrite && evict_blocking_entry()) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            backoff(spins);
+        }
+    }
+
+    // Dispatches up to `max` pending commands through `registry`, passing each outcome to
+    // on_result(key, result). Returns the number dispatched. Consumer thread only.
+    template <typename Registry, typename F>
+        requires std::invocable<F&, std::string_view,
+                                decltype(std::declval<Registry&>().dispatch(std::string_view{}, std::declval<TArgs>()...))>
+    std::size_t drain(Registry& registry, F&& on_result, std::size_t max = unlimited) {
+        std::size_t count = 0;
+        std::size_t pos;
+        while (count < max && claim(pos)) {
+            auto item = take(pos);
+            on_result(std::string_view(item.key),
+                      std::apply([&](auto&... args) { return registry.dispatch(item.key, std::move(args)...); },
+                                 item.args));
+            ++count;
+        }
+        return count;
+    }
+
+    template <typename Registry>
+    std::size_t drain(Registry& registry, std::size_t max = unlimited) {
+        return drain(registry, discard_result{}, max);
+    }
+
+    // Consumer loop: drains in batches of `batch`, sleeping while the queue is empty, until `stop` is
+    // requested; commands already visible at that point are still dispatched before returning.
+    template <typename Registry, typename F>
+    void run(Registry& registry, std::stop_token stop, F&& on_result, std::size_t batch = 256) {
+        std::stop_callback wake_on_stop(stop, [this] {
+            wake_.fetch_add(1, std::memory_order_seq_cst);
+            wake_.notify_all();
+        });
+
+        while (!stop.stop_requested()) {
+            if (drain(registry, on_result, batch) != 0) {
+                continue;
+            }
+            if (spin_until_ready()) {
+                continue;
+            }
+            // Publish `sleeping_` before re-checking for work; producers read it after publishing an
+            // entry, so either we see their entry or they see us asleep and bump `wake_`.
+            const auto ticket = wake_.load(std::memory_order_seq_cst);
+            sleeping_.store(true, std::memory_order_seq_cst);
+            if (empty() && !stop.stop_requested()) {
+                wake_.wait(ticket, std::memory_order_seq_cst);
+            }
+            sleeping_.store(false, std::memory_order_relaxed);
+        }
+        drain(registry, on_result);
+    }
+
+    template <typename Registry>
+    void run(Registry& registry, std::stop_token stop) {
+        run(registry, std::move(stop), discard_result{});
+    }
+
+    // True when no published command is waiting at the head. Exact only on the consumer thread.
+    bool empty() const noexcept {
+        const auto pos = head_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].sequence.load(std::memory_order_seq_cst) != pos + 1;
+    }
+
+    std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    backpressure mode() const noexcept {
+        return mode_;
+    }
+
+    // Commands rejected (drop) or evicted (overwrite) so far.
+    std::uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct entry {
+        std::string key;
+        std::tuple<TArgs...> args;
+    };
+
+    static_assert(std::is_nothrow_move_constructible_v<entry>, "queue arguments must be nothrow move constructible");
+
+    // One cache line per cell keeps producers writing neighbouring cells from invalidating each other.
+    struct alignas(64) cell {
+        std::atomic<std::size_t> sequence{0};
+        alignas(entry) unsigned char bytes[sizeof(entry)];
+    };
+
+    struct alignas(64) padded_index {
+        std::atomic<std::size_t> value{0};
+    };
+
+    struct discard_result {
+        template <typename R>
+        void operator()(std::string_view, R&&) const noexcept {
+        }
+    };
+
+    entry& entry_at(std::size_t pos) noexcept {
+        return *std::launder(reinterpret_cast<entry*>(cells_[pos & mask_].bytes));
+    }
+
+    bool try_enqueue(entry& pending) noexcept {
+        auto pos = tail_.value.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& item = cells_[pos & mask_];
+            const auto sequence = item.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        auto& item = cells_[pos & mask_];
+        ::new (static_cast<void*>(item.bytes)) entry(std::move(pending));
+        // seq_cst (not just release) so the later load of `sleeping_` cannot move ahead of the publish.
+        item.sequence.store(pos + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Takes ownership of the oldest published entry; release(pos) must follow.
+    bool claim(std::size_t& pos) noexcept {
+        pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            const auto sequence = cells_[pos & mask_].sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (mode_ != backpressure::overwrite) {
+                    head_.store(pos + 1, std::memory_order_relaxed);
+                    return true;
+                }
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void release(std::size_t pos) noexcept {
+        std::destroy_at(&entry_at(pos));
+        cells_[pos & mask_].sequence.store(pos + capacity_, std::memory_order_release);
+    }
+
+    // Moves a claimed entry out and frees its cell.
+    entry take(std::size_t pos) noexcept {
+        entry item(std::move(entry_at(pos)));
+        release(pos);
+        return item;
+    }
+
+    // Evicts the entry in the cell the tail needs next, if that entry is published and still at the head.
+    // Each eviction frees exactly the cell a producer is waiting for; when the cell is instead being
+    // consumed or evicted by someone else, nothing is dropped and the caller retries.
+    bool evict_blocking_entry() noexcept {
+        auto pos = tail_.value.load(std::memory_order_relaxed) - capacity_;
+        if (cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1 ||
+            !head_.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)) {
+            return false;
+        }
+        release(pos);
+        return true;
+    }
+
+    bool spin_until_ready() const noexcept {
+        for (unsigned spins = 0; spins < 128; ++spins) {
+            if (!empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void backoff(unsigned spins) noexcept {
+        if (spins > 64) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::unique_ptr<cell[]> cells_;
+    std::size_t capacity_ = 0;
+    std::size_t mask_ = 0;
+    backpressure mode_;
+    // Producer-written, consumer-written and rarely-written state live on separate cache lines.
+    padded_index tail_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<bool> sleeping_{false};
+    std::atomic<std::uint32_t> wake_{0};
+    alignas(64) std::atomic<std::uint64_t> dropped_{0};
+};
+
+} // namespace basicpp::command
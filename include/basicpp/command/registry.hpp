@@ -1,65 +1,401 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include <basicpp/command/metrics.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/flat_hash_map.hpp>
+#include <basicpp/core/function_ref.hpp>
+#include <basicpp/core/inplace_function.hpp>
+#include <basicpp/core/perfect_hash.hpp>
 #include <basicpp/core/result.hpp>
 
 namespace basicpp::command {
 
+// Selects the error type reported by basic_registry and the wrapper used to store handlers.
+// Lookup failures are built through core::error_factory<E>, so registry_policy<core::error> reports
+// them without allocating.
+template <typename E = std::string>
+struct registry_policy {
+    using error_type = E;
+
+    template <typename Sig>
+    using function_type = std::function<Sig>;
+};
+
+// Stores handlers in core::inplace_function: registering never allocates for the handler itself,
+// handlers may be move-only, and captures larger than `Capacity` bytes are rejected at compile time.
+template <typename E = core::error, std::size_t Capacity = 32>
+struct inplace_registry_policy {
+    using error_type = E;
+
+    template <typename Sig>
+    using function_type = core::inplace_function<Sig, Capacity>;
+};
+
+// Stable reference to a registered handler, obtained from resolve().
+// A handle stays valid across other registrations and removals; once its own key is unregistered
+// the handle goes stale and dispatching through it fails, even if the key is registered again.
+struct handler_handle {
+    static constexpr std::uint32_t invalid_index = 0xFFFFFFFFu;
+
+    std::uint32_t index = invalid_index;
+    std::uint32_t generation = 0;
+
+    explicit operator bool() const noexcept {
+        return index != invalid_index;
+    }
+
+    friend bool operator==(const handler_handle&, const handler_handle&) = default;
+};
+
+// Execution policy for dispatch_batch: spreads independent invocations over `threads` threads
+// (0 = hardware concurrency), using no more threads than leaves each at least `min_chunk` requests.
+struct parallel_dispatch {
+    unsigned threads = 0;
+    std::size_t min_chunk = 1024;
+};
+
 // Registry that maps string identifiers to command handlers returning basicpp::core::result.
-// Handlers are stored as std::function to keep integration friction low.
-template <typename TResult, typename... TArgs>
-class registry {
+// Handlers are stored as std::function by default to keep integration friction low; the policy can swap it out.
+// Keys are indexed by a core::flat_hash_map with transparent hashing, so lookups by string_view or
+// const char* do not build a std::string; resolve() turns a key into a handle for repeated dispatch.
+// freeze() additionally compiles the current keys into a core::perfect_hash for read-mostly phases;
+// any later registration or removal drops it again, so mutation keeps working at the old speed.
+// A policy wrapped in with_metrics<> also records per-key counts and latencies (see metrics()); without
+// it the metrics hooks are compiled out.
+template <typename TPolicy, typename TResult, typename... TArgs>
+class basic_registry {
 public:
-    using handler_result = core::result<TResult, std::string>;
-    using handler_type = std::function<handler_result(TArgs...)>;
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using handler_result = core::result<TResult, error_type>;
+    using handler_type = typename TPolicy::template function_type<handler_result(TArgs...)>;
+    using handle = handler_handle;
+    using metrics_type = typename detail::policy_metrics<TPolicy>::type;
+
+    struct batch_request {
+        std::string_view key;
+        std::tuple<TArgs...> args;
+    };
 
     bool register_handler(std::string key, handler_type handler) {
-        auto it = handlers_.find(key);
-        if (it == handlers_.end()) {
-            handlers_.emplace(std::move(key), std::move(handler));
-            return true;
+        if (auto* index = index_.find(key)) {
+            // Replacing a handler keeps the key set, so a frozen table stays valid.
+            entries_[*index].handler = std::move(handler);
+            return false;
+        }
+
+        std::uint32_t slot;
+        if (!free_.empty()) {
+            slot = free_.back();
+            free_.pop_back();
+        } else {
+            slot = static_cast<std::uint32_t>(entries_.size());
+            entries_.emplace_back();
+        }
+
+        thaw();
+        if constexpr (metrics_type::enabled) {
+            metrics_.reset(slot);
         }
+        auto& item = entries_[slot];
+        item.key = key;
+        item.handler = std::move(handler);
+        item.live = true;
+        index_.try_emplace(std::move(key), slot);
+        return true;
+    }
+
+    void unregister_handler(std::string_view key) {
+        auto* index = index_.find(key);
+        if (!index) {
+            return;
+        }
+
+        thaw();
+        const auto slot = *index;
+        index_.erase(key);
+        auto& item = entries_[slot];
+        item.key.clear();
+        item.handler = nullptr;
+        item.live = false;
+        ++item.generation;
+        free_.push_back(slot);
+    }
 
-        it->second = std::move(handler);
-        return false;
+    bool contains(std::string_view key) const {
+        return find_slot(key) != core::perfect_hash::npos;
     }
 
-    void unregister_handler(const std::string& key) {
-        handlers_.erase(key);
+    // Returns an invalid handle when the key is not registered.
+    handle resolve(std::string_view key) const {
+        const auto slot = find_slot(key);
+        if (slot == core::perfect_hash::npos) {
+            return handle{};
+        }
+        return handle{slot, entries_[slot].generation};
     }
 
-    bool contains(const std::string& key) const {
-        return handlers_.find(key) != handlers_.end();
+    bool contains(handle h) const noexcept {
+        return h.index < entries_.size() && entries_[h.index].live && entries_[h.index].generation == h.generation;
+    }
+
+    handler_result dispatch(std::string_view key, TArgs... args) const {
+        const auto slot = find_slot(key);
+        if (slot == core::perfect_hash::npos) {
+            return handler_result::err(
+                core::error_factory<error_type>::make(core::errc::command_not_found, "command not found", key));
+        }
+        return invoke(slot, std::forward<TArgs>(args)...);
     }
 
-    handler_result dispatch(const std::string& key, TArgs... args) const {
-        auto it = handlers_.find(key);
-        if (it == handlers_.end()) {
-            return handler_result::err("command not found: " + key);
+    handler_result dispatch(handle h, TArgs... args) const {
+        if (!contains(h)) {
+            return handler_result::err(
+                core::error_factory<error_type>::make(core::errc::command_not_found, "command handle is stale"));
+        }
+        return invoke(h.index, std::forward<TArgs>(args)...);
+    }
+
+    // Dispatches every request, writing its outcome to `results` at the same index.
+    // Keys are hashed and their slots prefetched a window at a time, then invocations run grouped by
+    // handler (in request order within a handler) for instruction-cache locality.
+    void dispatch_batch(std::span<const batch_request> requests, std::span<handler_result> results) const {
+        const auto order = plan_batch(requests, results);
+        invoke_batch(requests, results, order, 0, order.size());
+    }
+
+    // Parallel form: handlers may run concurrently with each other (including with themselves), so they
+    // must be safe to call from several threads. The first exception thrown by a handler is rethrown.
+    void dispatch_batch(std::span<const batch_request> requests, std::span<handler_result> results,
+                        parallel_dispatch policy) const {
+        const auto order = plan_batch(requests, results);
+
+        std::size_t threads = policy.threads != 0 ? policy.threads : std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, std::max<std::size_t>(1, order.size() / std::max<std::size_t>(1, policy.min_chunk)));
+        if (threads <= 1) {
+            invoke_batch(requests, results, order, 0, order.size());
+            return;
+        }
+
+        const auto chunk = (order.size() + threads - 1) / threads;
+        std::vector<std::exception_ptr> failures(threads);
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (std::size_t t = 1; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                try {
+                    invoke_batch(requests, results, order, t * chunk, std::min(order.size(), (t + 1) * chunk));
+                } catch (...) {
+                    failures[t] = std::current_exception();
+                }
+            });
+        }
+        try {
+            invoke_batch(requests, results, order, 0, std::min(order.size(), chunk));
+        } catch (...) {
+            failures[0] = std::current_exception();
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (const auto& failure : failures) {
+            if (failure) {
+                std::rethrow_exception(failure);
+            }
         }
-        return it->second(std::forward<TArgs>(args)...);
     }
 
     std::vector<std::string> keys() const {
         std::vector<std::string> result;
-        result.reserve(handlers_.size());
-        for (const auto& [key, _] : handlers_) {
-            result.push_back(key);
+        result.reserve(index_.size());
+        for (const auto& item : entries_) {
+            if (item.live) {
+                result.push_back(item.key);
+            }
         }
         return result;
     }
 
+    // Visits registered keys without copying them; keys() is the allocating convenience form.
+    void for_each_key(core::function_ref<void(std::string_view)> visit) const {
+        for (const auto& item : entries_) {
+            if (item.live) {
+                visit(item.key);
+            }
+        }
+    }
+
     std::size_t size() const noexcept {
-        return handlers_.size();
+        return index_.size();
+    }
+
+    // Builds a perfect-hash table of the registered keys; string lookups use it until the next
+    // register_handler (for a new key) or unregister_handler call.
+    void freeze() {
+        std::vector<std::string_view> keys;
+        std::vector<std::uint32_t> slots;
+        keys.reserve(index_.size());
+        slots.reserve(index_.size());
+        for (std::uint32_t slot = 0; slot < entries_.size(); ++slot) {
+            if (entries_[slot].live) {
+                keys.push_back(entries_[slot].key);
+                slots.push_back(slot);
+            }
+        }
+        // Registered keys are distinct, so the build only fails on pathological hash collisions;
+        // the registry then simply stays on the flat map.
+        frozen_valid_ = frozen_.build(keys, slots);
+    }
+
+    bool frozen() const noexcept {
+        return frozen_valid_;
+    }
+
+    void thaw() noexcept {
+        if (frozen_valid_) {
+            frozen_.clear();
+            frozen_valid_ = false;
+        }
+    }
+
+    // Merges the per-thread statistics of every registered key. May run while other threads dispatch;
+    // counts recorded concurrently may or may not be included.
+    metrics_snapshot metrics() const
+        requires metrics_type::enabled
+    {
+        metrics_snapshot snapshot;
+        snapshot.keys.reserve(index_.size());
+        for (std::uint32_t slot = 0; slot < entries_.size(); ++slot) {
+            if (entries_[slot].live) {
+                snapshot.keys.push_back(metrics_.collect(slot, entries_[slot].key));
+            }
+        }
+        std::sort(snapshot.keys.begin(), snapshot.keys.end(),
+                  [](const key_metrics& lhs, const key_metrics& rhs) { return lhs.key < rhs.key; });
+        return snapshot;
     }
 
 private:
-    std::unordered_map<std::string, handler_type> handlers_;
+    // Resolves every request, fails unknown keys in place, and returns (slot << 32 | request index)
+    // for the rest, sorted so that requests for the same handler are adjacent. The plan is owned by the
+    // call, so a handler may itself dispatch a batch on the same thread.
+    std::vector<std::uint64_t> plan_batch(std::span<const batch_request> requests,
+                                                 std::span<handler_result> results) const {
+        if (results.size() < requests.size()) {
+            throw std::invalid_argument("dispatch_batch: results span is smaller than requests");
+        }
+
+        std::vector<std::uint64_t> order;
+        order.reserve(requests.size());
+
+        constexpr std::size_t window = 16;
+        std::array<std::uint64_t, window> hashes{};
+        for (std::size_t base = 0; base < requests.size(); base += window) {
+            const auto count = std::min(window, requests.size() - base);
+            if (!frozen_valid_) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    hashes[i] = index_.hash_key(requests[base + i].key);
+                    index_.prefetch(hashes[i]);
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto key = requests[base + i].key;
+                std::uint32_t slot = core::perfect_hash::npos;
+                if (frozen_valid_) {
+                    slot = frozen_.find(key);
+                } else if (const auto* found = index_.find(key, hashes[i])) {
+                    slot = *found;
+                }
+
+                if (slot == core::perfect_hash::npos) {
+                    results[base + i] = handler_result::err(
+                        core::error_factory<error_type>::make(core::errc::command_not_found, "command not found", key));
+                } else {
+                    order.push_back((static_cast<std::uint64_t>(slot) << 32) | (base + i));
+                }
+            }
+        }
+
+        // Stable LSD radix sort on the slot bits only; entries start in request order, so requests for the
+        // same handler keep their relative order. Linear in the batch size, unlike a comparison sort.
+        std::vector<std::uint64_t> scratch(order.size());
+        std::uint64_t highest_slot = entries_.empty() ? 0 : entries_.size() - 1;
+        for (unsigned shift = 32; highest_slot != 0; shift += 8, highest_slot >>= 8) {
+            std::array<std::size_t, 257> offsets{};
+            for (const auto item : order) {
+                ++offsets[((item >> shift) & 0xFFu) + 1];
+            }
+            for (std::size_t digit = 1; digit < offsets.size(); ++digit) {
+                offsets[digit] += offsets[digit - 1];
+            }
+            for (const auto item : order) {
+                scratch[offsets[(item >> shift) & 0xFFu]++] = item;
+            }
+            order.swap(scratch);
+        }
+        return order;
+    }
+
+    void invoke_batch(std::span<const batch_request> requests, std::span<handler_result> results,
+                      const std::vector<std::uint64_t>& order, std::size_t begin, std::size_t end) const {
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto slot = static_cast<std::uint32_t>(order[i] >> 32);
+            const auto index = static_cast<std::size_t>(order[i] & 0xFFFFFFFFu);
+            results[index] = std::apply([&](const auto&... args) { return invoke(slot, args...); }, requests[index].args);
+        }
+    }
+
+    template <typename... Ts>
+    handler_result invoke(std::uint32_t slot, Ts&&... args) const {
+        if constexpr (metrics_type::enabled) {
+            const auto started = metrics_.start();
+            auto result = entries_[slot].handler(std::forward<Ts>(args)...);
+            metrics_.record(slot, started, static_cast<bool>(result));
+            return result;
+        } else {
+            return entries_[slot].handler(std::forward<Ts>(args)...);
+        }
+    }
+
+    std::uint32_t find_slot(std::string_view key) const noexcept {
+        if (frozen_valid_) {
+            return frozen_.find(key);
+        }
+        const auto* index = index_.find(key);
+        return index ? *index : core::perfect_hash::npos;
+    }
+
+    struct entry {
+        std::string key;
+        handler_type handler;
+        std::uint32_t generation = 0;
+        bool live = false;
+    };
+
+    core::flat_hash_map<std::string, std::uint32_t, core::string_hash, std::equal_to<>> index_;
+    std::vector<entry> entries_;
+    std::vector<std::uint32_t> free_;
+    core::perfect_hash frozen_;
+    bool frozen_valid_ = false;
+    [[no_unique_address]] metrics_type metrics_;
 };
 
+template <typename TResult, typename... TArgs>
+using registry = basic_registry<registry_policy<>, TResult, TArgs...>;
+
 } // namespace basicpp::command
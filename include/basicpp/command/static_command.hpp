@@ -0,0 +1,103 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <basicpp/command/command.hpp>
+
+namespace basicpp::command {
+
+// Any type whose execute(const TContext&) yields command<TContext>::result_type. No base class needed;
+// classes deriving from static_command satisfy it as well.
+template <typename T, typename TContext>
+concept command_for = requires(T& item, const TContext& context) {
+    { item.execute(context) } -> std::convertible_to<typename command<TContext>::result_type>;
+};
+
+// CRTP counterpart of command<TContext> for commands known at compile time: the same member types and
+// call shape, with calls resolved statically (and inlinable) instead of through a vtable.
+template <typename TDerived, typename TContext>
+class static_command {
+public:
+    using context_type = TContext;
+    using result_type = typename command<TContext>::result_type;
+
+    result_type operator()(const context_type& context) {
+        return static_cast<TDerived&>(*this).execute(context);
+    }
+
+protected:
+    static_command() = default;
+};
+
+// Closed set of command types stored by value in one contiguous vector of std::variant.
+// Invocation goes through std::visit (a jump table on the variant index), so there is no per-command
+// allocation and no virtual call; each alternative's execute() can be inlined into the loop.
+template <typename TContext, command_for<TContext>... Ts>
+class command_set {
+public:
+    using context_type = TContext;
+    using result_type = typename command<TContext>::result_type;
+    using value_type = std::variant<Ts...>;
+
+    template <typename T, typename... Args>
+        requires(std::is_same_v<T, Ts> || ...)
+    T& emplace(Args&&... args) {
+        return std::get<T>(commands_.emplace_back(std::in_place_type<T>, std::forward<Args>(args)...));
+    }
+
+    template <typename T>
+        requires(std::is_same_v<std::remove_cvref_t<T>, Ts> || ...)
+    void push_back(T&& item) {
+        commands_.emplace_back(std::forward<T>(item));
+    }
+
+    result_type execute(std::size_t index, const context_type& context) {
+        return std::visit([&](auto& item) -> result_type { return item.execute(context); }, commands_[index]);
+    }
+
+    // Runs every command in insertion order and stops at the first failure, which is returned.
+    result_type execute_all(const context_type& context) {
+        for (auto& entry : commands_) {
+            auto result = std::visit([&](auto& item) -> result_type { return item.execute(context); }, entry);
+            if (!result) {
+                return result;
+            }
+        }
+        return result_type::ok();
+    }
+
+    // Visits every stored command as fn(T&) with its concrete type.
+    template <typename F>
+    void for_each(F&& fn) {
+        for (auto& entry : commands_) {
+            std::visit(fn, entry);
+        }
+    }
+
+    void reserve(std::size_t count) {
+        commands_.reserve(count);
+    }
+
+    void clear() noexcept {
+        commands_.clear();
+    }
+
+    std::size_t size() const noexcept {
+        return commands_.size();
+    }
+
+    bool empty() const noexcept {
+        return commands_.empty();
+    }
+
+private:
+    std::vector<value_type> commands_;
+};
+
+} // namespace basicpp::command
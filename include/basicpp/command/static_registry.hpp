@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/perfect_hash.hpp>
+#include <basicpp/core/result.hpp>
+
+namespace basicpp::command {
+
+// Fixed registry for command sets known at compile time. Keys are compiled into a
+// core::static_perfect_hash and handlers are plain function pointers, so a constexpr instance lives
+// entirely in read-only data and dispatch can run in constant evaluation.
+template <typename TPolicy, std::size_t N, typename TResult, typename... TArgs>
+class basic_static_registry {
+public:
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using handler_result = core::result<TResult, error_type>;
+    using handler_type = handler_result (*)(TArgs...);
+
+    struct entry {
+        std::string_view key;
+        handler_type handler;
+    };
+
+    constexpr explicit basic_static_registry(const std::array<entry, N>& entries)
+        : index_(keys_of(entries)), handlers_(handlers_of(entries)) {
+    }
+
+    static constexpr std::size_t size() noexcept {
+        return N;
+    }
+
+    constexpr bool contains(std::string_view key) const noexcept {
+        return index_.find(key) != index_.npos;
+    }
+
+    constexpr handler_result dispatch(std::string_view key, TArgs... args) const {
+        const auto index = index_.find(key);
+        if (index == index_.npos) {
+            return handler_result::err(
+                core::error_factory<error_type>::make(core::errc::command_not_found, "command not found", key));
+        }
+        return handlers_[index](std::forward<TArgs>(args)...);
+    }
+
+private:
+    static constexpr std::array<std::string_view, N> keys_of(const std::array<entry, N>& entries) {
+        std::array<std::string_view, N> keys{};
+        for (std::size_t i = 0; i < N; ++i) {
+            keys[i] = entries[i].key;
+        }
+        return keys;
+    }
+
+    static constexpr std::array<handler_type, N> handlers_of(const std::array<entry, N>& entries) {
+        std::array<handler_type, N> handlers{};
+        for (std::size_t i = 0; i < N; ++i) {
+            handlers[i] = entries[i].handler;
+        }
+        return handlers;
+    }
+
+    core::static_perfect_hash<N> index_;
+    std::array<handler_type, N> handlers_;
+};
+
+// core::error keeps lookup failures constexpr-friendly.
+template <std::size_t N, typename TResult, typename... TArgs>
+using static_registry = basic_static_registry<registry_policy<core::error>, N, TResult, TArgs...>;
+
+} // namespace basicpp::command
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace basicpp::core {
+
+// Failure categories reported by the runtime.
+enum class errc : std::uint16_t {
+    none = 0,
+    command_not_found,
+    transition_not_found,
+    handler_failed,
+    invalid_argument,
+    user = 0x100, // first value free for application-defined codes
+};
+
+// Allocation-free error value for result-returning hot paths.
+// Holds a code, a pointer to a static message and a short payload copied inline (e.g. the missing key).
+// Payloads longer than `payload_capacity` are truncated. The text form is only built by to_string().
+class error {
+public:
+    static constexpr std::size_t payload_capacity = 46;
+
+    constexpr error() noexcept = default;
+
+    // `message` must outlive the error; string literals are the intended use.
+    constexpr error(errc code, const char* message, std::string_view payload = {}) noexcept
+        : message_(message), code_(code) {
+        const auto length = std::min(payload.size(), payload_capacity);
+        for (std::size_t i = 0; i < length; ++i) {
+            payload_[i] = payload[i];
+        }
+        payload_size_ = static_cast<std::uint8_t>(length);
+        truncated_ = payload.size() > payload_capacity;
+    }
+
+    constexpr errc code() const noexcept {
+        return code_;
+    }
+
+    constexpr std::string_view message() const noexcept {
+        return message_ ? std::string_view(message_) : std::string_view();
+    }
+
+    constexpr std::string_view payload() const noexcept {
+        return std::string_view(payload_, payload_size_);
+    }
+
+    constexpr bool truncated() const noexcept {
+        return truncated_;
+    }
+
+    // "message: payload", with "..." appended when the payload was cut short.
+    std::string to_string() const {
+        std::string out(message());
+        if (payload_size_ != 0 || truncated_) {
+            out += ": ";
+            out += payload();
+            if (truncated_) {
+                out += "...";
+            }
+        }
+        return out;
+    }
+
+    friend constexpr bool operator==(const error& lhs, errc rhs) noexcept {
+        return lhs.code_ == rhs;
+    }
+
+private:
+    const char* message_ = nullptr;
+    errc code_ = errc::none;
+    std::uint8_t payload_size_ = 0;
+    bool truncated_ = false;
+    char payload_[payload_capacity] = {};
+};
+
+// Builds an error value of type E for failures detected inside the runtime.
+// Specialise for custom error types to use them with registry_policy / state_machine_policy.
+template <typename E>
+struct error_factory;
+
+template <>
+struct error_factory<std::string> {
+    static std::string make(errc, const char* message, std::string_view payload = {}) {
+        std::string out(message);
+        if (!payload.empty()) {
+            out += ": ";
+            out += payload;
+        }
+        return out;
+    }
+};
+
+template <>
+struct error_factory<error> {
+    static constexpr error make(errc code, const char* message, std::string_view payload = {}) noexcept {
+        return error(code, message, payload);
+    }
+};
+
+inline std::string to_string(const error& value) {
+    return value.to_string();
+}
+
+} // namespace basicpp::core
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace basicpp::core {
+
+// Runs coroutine resumptions. post() may be called from any thread, including from inside a resumption.
+class executor {
+public:
+    virtual ~executor() = default;
+    virtual void post(std::coroutine_handle<> continuation) = 0;
+};
+
+// Resumes immediately on the posting thread.
+class inline_executor final : public executor {
+public:
+    void post(std::coroutine_handle<> continuation) override {
+        continuation.resume();
+    }
+
+    static inline_executor& instance() noexcept {
+        static inline_executor shared;
+        return shared;
+    }
+};
+
+// Fixed set of worker threads draining one FIFO queue. The destructor finishes every queued resumption
+// before joining, so coroutines still scheduled on the pool are not leaked.
+class thread_pool_executor final : public executor {
+public:
+    // 0 threads means hardware concurrency.
+    explicit thread_pool_executor(unsigned threads = 0) {
+        const auto count = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+        workers_.reserve(count);
+        for (unsigned i = 0; i < count; ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+
+    thread_pool_executor(const thread_pool_executor&) = delete;
+    thread_pool_executor& operator=(const thread_pool_executor&) = delete;
+
+    ~thread_pool_executor() override {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    void post(std::coroutine_handle<> continuation) override {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(continuation);
+        }
+        ready_.notify_one();
+    }
+
+    std::size_t thread_count() const noexcept {
+        return workers_.size();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::coroutine_handle<> next;
+            {
+                std::unique_lock lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+                if (queue_.empty()) {
+                    return;
+                }
+                next = queue_.front();
+                queue_.pop_front();
+            }
+            next.resume();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<std::coroutine_handle<>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+// Awaitable that moves the awaiting coroutine onto `target`: `co_await core::schedule(pool);`.
+// Scheduling onto the inline executor completes without suspending.
+inline auto schedule(executor& target) noexcept {
+    struct awaiter {
+        executor& target;
+
+        bool await_ready() const noexcept {
+            return &target == &inline_executor::instance();
+        }
+
+        void await_suspend(std::coroutine_handle<> continuation) const {
+            target.post(continuation);
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+    return awaiter{target};
+}
+
+} // namespace basicpp::core
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <basicpp/core/prefetch.hpp>
+
+namespace basicpp::core {
+
+// Transparent string hash: lets maps keyed by std::string be queried with string_view or const char*.
+struct string_hash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view value) const noexcept {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+// Open-addressing hash map with linear probing and backward-shift deletion.
+// Keys and values live inline in one slot array next to a parallel array of mixed hashes (0 marks
+// an empty slot), so a lookup touches one cache line for the hash and, on a match, one for the entry.
+// When Hash and KeyEqual both define is_transparent, lookups accept any type they can hash/compare.
+// Pointers to values stay valid until the next insertion or erase.
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class flat_hash_map {
+public:
+    using key_type = K;
+    using mapped_type = V;
+
+    struct entry {
+        K key;
+        V value;
+    };
+
+    flat_hash_map() = default;
+
+    flat_hash_map(const flat_hash_map& other)
+        : hash_(other.hash_), equal_(other.equal_) {
+        reserve(other.size_);
+        other.for_each([this](const K& key, const V& value) { try_emplace(key, value); });
+    }
+
+    flat_hash_map(flat_hash_map&& other) noexcept
+        : hashes_(std::move(other.hashes_)),
+          slots_(std::move(other.slots_)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          shift_(std::exchange(other.shift_, 64)),
+          hash_(std::move(other.hash_)),
+          equal_(std::move(other.equal_)) {
+    }
+
+    flat_hash_map& operator=(const flat_hash_map& other) {
+        if (this != &other) {
+            flat_hash_map copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    flat_hash_map& operator=(flat_hash_map&& other) noexcept {
+        if (this != &other) {
+            flat_hash_map moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~flat_hash_map() {
+        destroy_all();
+    }
+
+    void swap(flat_hash_map& other) noexcept {
+        using std::swap;
+        swap(hashes_, other.hashes_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(shift_, other.shift_);
+        swap(hash_, other.hash_);
+        swap(equal_, other.equal_);
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    void clear() noexcept {
+        destroy_all();
+        size_ = 0;
+    }
+
+    // Ensures `count` elements fit without rehashing.
+    void reserve(std::size_t count) {
+        std::size_t wanted = min_capacity;
+        while (wanted - wanted / 8 < count) {
+            wanted *= 2;
+        }
+        if (wanted > capacity_) {
+            rehash(wanted);
+        }
+    }
+
+    template <typename Q>
+    V* find(const Q& key) noexcept {
+        const auto index = find_index(key);
+        return index == npos ? nullptr : &entry_at(index).value;
+    }
+
+    template <typename Q>
+    const V* find(const Q& key) const noexcept {
+        const auto index = find_index(key);
+        return index == npos ? nullptr : &entry_at(index).value;
+    }
+
+    // Split lookup for batched callers: hash many keys and prefetch their home slots first, then
+    // resolve them with find(key, hashed) once the cache lines have had time to arrive.
+    template <typename Q>
+    std::uint64_t hash_key(const Q& key) const noexcept {
+        return mix(hash_(key));
+    }
+
+    void prefetch(std::uint64_t hashed) const noexcept {
+        if (capacity_ != 0) {
+            const auto index = home(hashed);
+            core::prefetch(&hashes_[index]);
+            core::prefetch(slots_[index].bytes);
+        }
+    }
+
+    template <typename Q>
+    const V* find(const Q& key, std::uint64_t hashed) const noexcept {
+        if (size_ == 0) {
+            return nullptr;
+        }
+        const auto index = find_index(key, hashed);
+        return index == npos ? nullptr : &entry_at(index).value;
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const noexcept {
+        return find_index(key) != npos;
+    }
+
+    // Inserts (key, V(args...)) when the key is absent. Returns the value and whether it was inserted.
+    template <typename Q, typename... Args>
+    std::pair<V*, bool> try_emplace(Q&& key, Args&&... args) {
+        const auto hashed = mix(hash_(key));
+        if (capacity_ != 0) {
+            if (auto index = find_index(key, hashed); index != npos) {
+                return {&entry_at(index).value, false};
+            }
+        }
+
+        if (size_ + 1 > capacity_ - capacity_ / 8) {
+            rehash(capacity_ == 0 ? min_capacity : capacity_ * 2);
+        }
+
+        auto index = home(hashed);
+        while (hashes_[index] != 0) {
+            index = (index + 1) & (capacity_ - 1);
+        }
+        ::new (static_cast<void*>(slots_[index].bytes))
+            entry{K(std::forward<Q>(key)), V(std::forward<Args>(args)...)};
+        hashes_[index] = hashed;
+        ++size_;
+        return {&entry_at(index).value, true};
+    }
+
+    template <typename Q, typename U>
+    std::pair<V*, bool> insert_or_assign(Q&& key, U&& value) {
+        auto [slot, inserted] = try_emplace(std::forward<Q>(key), std::forward<U>(value));
+        if (!inserted) {
+            *slot = std::forward<U>(value);
+        }
+        return {slot, inserted};
+    }
+
+    template <typename Q>
+    bool erase(const Q& key) {
+        auto index = find_index(key);
+        if (index == npos) {
+            return false;
+        }
+
+        std::destroy_at(&entry_at(index));
+        hashes_[index] = 0;
+        --size_;
+
+        // Backward-shift: pull later members of the probe run into the hole so lookups never need tombstones.
+        const auto mask = capacity_ - 1;
+        auto hole = index;
+        for (auto next = (hole + 1) & mask; hashes_[next] != 0; next = (next + 1) & mask) {
+            const auto distance_from_home = (next - home(hashes_[next])) & mask;
+            const auto distance_to_hole = (next - hole) & mask;
+            if (distance_from_home >= distance_to_hole) {
+                ::new (static_cast<void*>(slots_[hole].bytes)) entry(std::move(entry_at(next)));
+                std::destroy_at(&entry_at(next));
+                hashes_[hole] = std::exchange(hashes_[next], 0);
+                hole = next;
+            }
+        }
+        return true;
+    }
+
+    // Visits every element as fn(const K&, V&) in unspecified order.
+    template <typename F>
+    void for_each(F&& fn) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (hashes_[i] != 0) {
+                auto& item = entry_at(i);
+                fn(std::as_const(item.key), item.value);
+            }
+        }
+    }
+
+    template <typename F>
+    void for_each(F&& fn) const {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (hashes_[i] != 0) {
+                const auto& item = entry_at(i);
+                fn(item.key, item.value);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    static constexpr std::size_t min_capacity = 8;
+
+    struct slot {
+        alignas(entry) unsigned char bytes[sizeof(entry)];
+    };
+
+    // Fibonacci mixing; the top bits pick the home slot and bit 0 is forced so that 0 can mean "empty".
+    static std::uint64_t mix(std::size_t hash) noexcept {
+        return (static_cast<std::uint64_t>(hash) * 0x9e3779b97f4a7c15ULL) | 1u;
+    }
+
+    std::size_t home(std::uint64_t hashed) const noexcept {
+        return static_cast<std::size_t>(hashed >> shift_);
+    }
+
+    entry& entry_at(std::size_t index) noexcept {
+        return *std::launder(reinterpret_cast<entry*>(slots_[index].bytes));
+    }
+
+    const entry& entry_at(std::size_t index) const noexcept {
+        return *std::launder(reinterpret_cast<const entry*>(slots_[index].bytes));
+    }
+
+    template <typename Q>
+    std::size_t find_index(const Q& key) const noexcept {
+        if (size_ == 0) {
+            return npos;
+        }
+        return find_index(key, mix(hash_(key)));
+    }
+
+    template <typename Q>
+    std::size_t find_index(const Q& key, std::uint64_t hashed) const noexcept {
+        const auto mask = capacity_ - 1;
+        for (auto index = home(hashed); hashes_[index] != 0; index = (index + 1) & mask) {
+            if (hashes_[index] == hashed && equal_(entry_at(index).key, key)) {
+                return index;
+            }
+        }
+        return npos;
+    }
+
+    void rehash(std::size_t new_capacity) {
+        auto old_hashes = std::move(hashes_);
+        auto old_slots = std::move(slots_);
+        const auto old_capacity = capacity_;
+
+        hashes_ = std::make_unique<std::uint64_t[]>(new_capacity);
+        slots_.reset(new slot[new_capacity]);
+        capacity_ = new_capacity;
+        shift_ = 64;
+        for (auto bits = new_capacity; bits > 1; bits >>= 1) {
+            --shift_;
+        }
+
+        const auto mask = capacity_ - 1;
+        for (std::size_t i = 0; i < old_capacity; ++i) {
+            if (old_hashes[i] == 0) {
+                continue;
+            }
+            auto& old_entry = *std::launder(reinterpret_cast<entry*>(old_slots[i].bytes));
+            auto index = home(old_hashes[i]);
+            while (hashes_[index] != 0) {
+                index = (index + 1) & mask;
+            }
+            ::new (static_cast<void*>(slots_[index].bytes)) entry(std::move(old_entry));
+            std::destroy_at(&old_entry);
+            hashes_[index] = old_hashes[i];
+        }
+    }
+
+    void destroy_all() noexcept {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            if (hashes_[i] != 0) {
+                std::destroy_at(&entry_at(i));
+                hashes_[i] = 0;
+            }
+        }
+    }
+
+    std::unique_ptr<std::uint64_t[]> hashes_;
+    std::unique_ptr<slot[]> slots_;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    unsigned shift_ = 64;
+    [[no_unique_address]] Hash hash_{};
+    [[no_unique_address]] KeyEqual equal_{};
+};
+
+} // namespace basicpp::core
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace basicpp::core {
+
+template <typename Sig>
+class function_ref;
+
+// Non-owning reference to a callable: two pointers, never allocates.
+// The referenced callable must outlive the function_ref; use it for parameters, not for storage.
+template <typename R, typename... Args>
+class function_ref<R(Args...)> {
+public:
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, function_ref> &&
+                 !std::is_function_v<std::remove_reference_t<F>> &&
+                 std::is_invocable_r_v<R, std::remove_reference_t<F>&, Args...>)
+    function_ref(F&& fn) noexcept
+        : invoke_(&invoke_object<std::remove_reference_t<F>>) {
+        target_.object = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+    }
+
+    function_ref(R (*fn)(Args...)) noexcept
+        : invoke_(&invoke_function) {
+        target_.function = fn;
+    }
+
+    R operator()(Args... args) const {
+        return invoke_(target_, std::forward<Args>(args)...);
+    }
+
+private:
+    union target {
+        void* object;
+        R (*function)(Args...);
+    };
+
+    template <typename T>
+    static R invoke_object(target self, Args&&... args) {
+        if constexpr (std::is_void_v<R>) {
+            std::invoke(*static_cast<T*>(self.object), std::forward<Args>(args)...);
+        } else {
+            return std::invoke(*static_cast<T*>(self.object), std::forward<Args>(args)...);
+        }
+    }
+
+    static R invoke_function(target self, Args&&... args) {
+        if constexpr (std::is_void_v<R>) {
+            self.function(std::forward<Args>(args)...);
+        } else {
+            return self.function(std::forward<Args>(args)...);
+        }
+    }
+
+    target target_{};
+    R (*invoke_)(target, Args&&...);
+};
+
+} // namespace basicpp::core
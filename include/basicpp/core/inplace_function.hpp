@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace basicpp::core {
+
+template <typename Sig, std::size_t Capacity = 32, std::size_t Alignment = alignof(std::max_align_t)>
+class inplace_function;
+
+// Move-only std::function replacement that stores the callable in an inline buffer of `Capacity` bytes.
+// There is no heap fallback: a callable that does not fit is rejected at compile time.
+// Calling an empty inplace_function throws std::bad_function_call, like std::function.
+template <typename R, typename... Args, std::size_t Capacity, std::size_t Alignment>
+class inplace_function<R(Args...), Capacity, Alignment> {
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    inplace_function() noexcept = default;
+
+    inplace_function(std::nullptr_t) noexcept {
+    }
+
+    template <typename F>
+        requires(!std::is_same_v<std::remove_cvref_t<F>, inplace_function> &&
+                 std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    inplace_function(F&& fn) {
+        using stored = std::decay_t<F>;
+        static_assert(sizeof(stored) <= Capacity, "callable does not fit in inplace_function capacity");
+        static_assert(Alignment % alignof(stored) == 0, "callable alignment exceeds inplace_function alignment");
+        static_assert(std::is_nothrow_move_constructible_v<stored>,
+                      "inplace_function requires nothrow move-constructible callables");
+
+        if constexpr (std::is_pointer_v<stored> || std::is_member_pointer_v<stored>) {
+            if (fn == nullptr) {
+                return;
+            }
+        }
+        ::new (static_cast<void*>(storage_)) stored(std::forward<F>(fn));
+        invoke_ = &invoke_impl<stored>;
+        vtable_ = &vtable_for<stored>;
+    }
+
+    inplace_function(inplace_function&& other) noexcept {
+        take(other);
+    }
+
+    inplace_function& operator=(inplace_function&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    inplace_function& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    inplace_function(const inplace_function&) = delete;
+    inplace_function& operator=(const inplace_function&) = delete;
+
+    ~inplace_function() {
+        reset();
+    }
+
+    explicit operator bool() const noexcept {
+        return vtable_ != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return invoke_(storage_, std::forward<Args>(args)...);
+    }
+
+private:
+    using invoke_fn = R (*)(void*, Args&&...);
+
+    // Lifetime operations live behind one pointer; the invoker is kept inline so a call is a single
+    // indirect jump, and the empty state uses an invoker that throws instead of a null check.
+    struct vtable {
+        void (*relocate)(void* destination, void* source) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    [[noreturn]] static R invoke_empty(void*, Args&&...) {
+        throw std::bad_function_call();
+    }
+
+    template <typename T>
+    static R invoke_impl(void* object, Args&&... args) {
+        if constexpr (std::is_void_v<R>) {
+            std::invoke(*static_cast<T*>(object), std::forward<Args>(args)...);
+        } else {
+            return std::invoke(*static_cast<T*>(object), std::forward<Args>(args)...);
+        }
+    }
+
+    template <typename T>
+    static void relocate_impl(void* destination, void* source) noexcept {
+        auto* from = static_cast<T*>(source);
+        ::new (destination) T(std::move(*from));
+        from->~T();
+    }
+
+    template <typename T>
+    static void destroy_impl(void* object) noexcept {
+        static_cast<T*>(object)->~T();
+    }
+
+    template <typename T>
+    static constexpr vtable vtable_for{&relocate_impl<T>, &destroy_impl<T>};
+
+    void take(inplace_function& other) noexcept {
+        if (other.vtable_) {
+            other.vtable_->relocate(storage_, other.storage_);
+            vtable_ = std::exchange(other.vtable_, nullptr);
+            invoke_ = std::exchange(other.invoke_, &invoke_empty);
+        }
+    }
+
+    void reset() noexcept {
+        if (vtable_) {
+            vtable_->destroy(storage_);
+            vtable_ = nullptr;
+            invoke_ = &invoke_empty;
+        }
+    }
+
+    invoke_fn invoke_ = &invoke_empty;
+    const vtable* vtable_ = nullptr;
+    alignas(Alignment) mutable unsigned char storage_[Capacity];
+};
+
+} // namespace basicpp::core
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace basicpp::core {
+
+namespace detail {
+    inline constexpr std::uint32_t phf_direct = 0x80000000u;
+    inline constexpr std::uint32_t phf_max_group = 32;
+    inline constexpr std::uint32_t phf_max_seed = 1u << 16;
+    inline constexpr std::uint32_t phf_max_salt = 16;
+    inline constexpr std::uint32_t phf_free = 0xFFFFFFFFu;
+
+    constexpr std::uint64_t phf_mix(std::uint64_t value) noexcept {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+    // Word-at-a-time string hash. Words are assembled with shifts in constant evaluation and loaded
+    // with memcpy at run time; both give the same value on little-endian targets.
+    constexpr std::uint64_t phf_hash(std::string_view key, std::uint64_t salt) noexcept {
+        std::uint64_t hash = 0x9e3779b97f4a7c15ULL ^ (salt * 0xff51afd7ed558ccdULL) ^ key.size();
+        std::size_t index = 0;
+        while (index < key.size()) {
+            std::uint64_t word = 0;
+            const auto chunk = std::min<std::size_t>(8, key.size() - index);
+            if (!std::is_constant_evaluated() && chunk == 8 && std::endian::native == std::endian::little) {
+                std::memcpy(&word, key.data() + index, 8);
+            } else {
+                for (std::size_t byte = 0; byte < chunk; ++byte) {
+                    word |= static_cast<std::uint64_t>(static_cast<unsigned char>(key[index + byte])) << (8 * byte);
+                }
+            }
+            hash = (hash ^ word) * 0x9fb21c651e98df25ULL;
+            hash ^= hash >> 29;
+            index += chunk;
+        }
+        return phf_mix(hash);
+    }
+
+    // Multiply-shift range reduction of a 32-bit hash into [0, range); avoids a division per lookup.
+    constexpr std::uint32_t phf_reduce(std::uint64_t hash32, std::size_t range) noexcept {
+        return static_cast<std::uint32_t>(((hash32 & 0xFFFFFFFFu) * static_cast<std::uint64_t>(range)) >> 32);
+    }
+
+    constexpr std::uint32_t phf_bucket(std::uint64_t hash, std::size_t buckets) noexcept {
+        return phf_reduce(hash >> 32, buckets);
+    }
+
+    constexpr std::uint32_t phf_slot(std::uint64_t hash, std::uint32_t seed, std::size_t slots) noexcept {
+        if (seed & phf_direct) {
+            return seed & ~phf_direct;
+        }
+        const auto mixed = (hash ^ (seed * 0x9e3779b97f4a7c15ULL)) * 0xd6e8feb86659fd93ULL;
+        return phf_reduce(mixed >> 32, slots);
+    }
+
+    // Hash-and-displace construction (CHD without the compression step) of a minimal perfect hash.
+    // Keys are grouped into buckets of ~4; buckets are placed largest first by searching for a seed that
+    // sends every key of the bucket to a free slot. Single-key buckets store their slot directly.
+    // Containers are anything indexable with size(): std::array in constant evaluation, std::vector at run time.
+    // Returns false when some bucket cannot be placed (a hash collision); the caller retries with another salt.
+    template <typename Hashes, typename Seeds, typename SlotKeys, typename Order, typename Sizes>
+    constexpr bool phf_build(const Hashes& hashes, std::size_t count, Seeds& seeds, SlotKeys& slot_keys,
+                             Order& order, Sizes& bucket_sizes) {
+        const auto buckets = seeds.size();
+        for (std::size_t b = 0; b < buckets; ++b) {
+            seeds[b] = 0;
+            bucket_sizes[b] = 0;
+        }
+        for (std::size_t slot = 0; slot < count; ++slot) {
+            slot_keys[slot] = phf_free;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            ++bucket_sizes[phf_bucket(hashes[i], buckets)];
+            order[i] = static_cast<std::uint32_t>(i);
+        }
+
+        std::sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(count),
+                  [&](std::uint32_t lhs, std::uint32_t rhs) {
+                      const auto lb = phf_bucket(hashes[lhs], buckets);
+                      const auto rb = phf_bucket(hashes[rhs], buckets);
+                      if (bucket_sizes[lb] != bucket_sizes[rb]) {
+                          return bucket_sizes[lb] > bucket_sizes[rb];
+                      }
+                      return lb != rb ? lb < rb : lhs < rhs;
+                  });
+
+        std::size_t start = 0;
+        while (start < count) {
+            const auto bucket = phf_bucket(hashes[order[start]], buckets);
+            const auto size = bucket_sizes[bucket];
+            if (size == 1) {
+                break;
+            }
+            if (size > phf_max_group) {
+                return false;
+            }
+
+            for (std::size_t i = start; i < start + size; ++i) {
+                for (std::size_t j = i + 1; j < start + size; ++j) {
+                    if (hashes[order[i]] == hashes[order[j]]) {
+                        return false;
+                    }
+                }
+            }
+
+            std::array<std::uint32_t, phf_max_group> chosen{};
+            bool placed = false;
+            for (std::uint32_t seed = 1; seed < phf_max_seed && !placed; ++seed) {
+                placed = true;
+                for (std::size_t k = 0; k < size && placed; ++k) {
+                    const auto slot = phf_slot(hashes[order[start + k]], seed, count);
+                    if (slot_keys[slot] != phf_free) {
+                        placed = false;
+                    }
+                    for (std::size_t prior = 0; prior < k && placed; ++prior) {
+                        placed = chosen[prior] != slot;
+                    }
+                    chosen[k] = slot;
+                }
+                if (placed) {
+                    seeds[bucket] = seed;
+                    for (std::size_t k = 0; k < size; ++k) {
+                        slot_keys[chosen[k]] = order[start + k];
+                    }
+                }
+            }
+            if (!placed) {
+                return false;
+            }
+            start += size;
+        }
+
+        std::size_t free_slot = 0;
+        for (; start < count; ++start) {
+            while (slot_keys[free_slot] != phf_free) {
+                ++free_slot;
+            }
+            const auto key = order[start];
+            seeds[phf_bucket(hashes[key], buckets)] = phf_direct | static_cast<std::uint32_t>(free_slot);
+            slot_keys[free_slot] = key;
+        }
+        return true;
+    }
+
+    constexpr std::size_t phf_bucket_count(std::size_t keys) noexcept {
+        return keys < 4 ? 1 : (keys + 3) / 4;
+    }
+} // namespace detail
+
+// Immutable minimal perfect hash over a set of distinct strings, built at run time.
+// Keys are copied into one contiguous buffer laid out in slot order; each slot also carries a
+// caller-provided 32-bit value. A lookup hashes the key once, reads one seed and one slot record,
+// and compares the stored key to reject strings outside the set.
+class perfect_hash {
+public:
+    static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+    // `values[i]` is returned for `keys[i]`; when `values` is empty the input index is used.
+    // Returns false (leaving the table empty) if keys contain duplicates.
+    bool build(std::span<const std::string_view> keys, std::span<const std::uint32_t> values = {}) {
+        clear();
+        if (keys.empty()) {
+            return true;
+        }
+
+        std::vector<std::uint64_t> hashes(keys.size());
+        std::vector<std::uint32_t> seeds(detail::phf_bucket_count(keys.size()));
+        std::vector<std::uint32_t> slot_keys(keys.size());
+        std::vector<std::uint32_t> order(keys.size());
+        std::vector<std::uint32_t> bucket_sizes(seeds.size());
+
+        for (std::uint32_t salt = 0; salt < detail::phf_max_salt; ++salt) {
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                hashes[i] = detail::phf_hash(keys[i], salt);
+            }
+            if (!detail::phf_build(hashes, keys.size(), seeds, slot_keys, order, bucket_sizes)) {
+                continue;
+            }
+
+            std::size_t total = 0;
+            for (auto key : keys) {
+                total += key.size();
+            }
+            blob_.reserve(total);
+            records_.resize(keys.size());
+            for (std::size_t slot = 0; slot < keys.size(); ++slot) {
+                const auto key_index = slot_keys[slot];
+                const auto key = keys[key_index];
+                records_[slot] = record{static_cast<std::uint32_t>(blob_.size()), static_cast<std::uint32_t>(key.size()),
+                                        values.empty() ? key_index : values[key_index]};
+                blob_.append(key);
+            }
+            seeds_ = std::move(seeds);
+            salt_ = salt;
+            return true;
+        }
+        return false;
+    }
+
+    void clear() noexcept {
+        seeds_.clear();
+        records_.clear();
+        blob_.clear();
+        salt_ = 0;
+    }
+
+    std::size_t size() const noexcept {
+        return records_.size();
+    }
+
+    // Returns the value stored for `key`, or npos when the key is not in the set.
+    std::uint32_t find(std::string_view key) const noexcept {
+        if (records_.empty()) {
+            return npos;
+        }
+        const auto hash = detail::phf_hash(key, salt_);
+        const auto seed = seeds_[detail::phf_bucket(hash, seeds_.size())];
+        const auto& slot = records_[detail::phf_slot(hash, seed, records_.size())];
+        if (std::string_view(blob_.data() + slot.offset, slot.length) != key) {
+            return npos;
+        }
+        return slot.value;
+    }
+
+private:
+    struct record {
+        std::uint32_t offset;
+        std::uint32_t length;
+        std::uint32_t value;
+    };
+
+    std::vector<std::uint32_t> seeds_;
+    std::vector<record> records_;
+    std::string blob_;
+    std::uint32_t salt_ = 0;
+};
+
+// Compile-time counterpart of perfect_hash for N keys known up front (typically string literals).
+// Construction fails to compile (throws in constant evaluation) if the keys contain duplicates.
+template <std::size_t N>
+class static_perfect_hash {
+public:
+    static constexpr std::size_t npos = N;
+
+    constexpr explicit static_perfect_hash(const std::array<std::string_view, N>& keys) {
+        if constexpr (N != 0) {
+            std::array<std::uint64_t, N> hashes{};
+            std::array<std::uint32_t, N> order{};
+            std::array<std::uint32_t, bucket_count> bucket_sizes{};
+            for (std::uint32_t salt = 0; salt < detail::phf_max_salt; ++salt) {
+                for (std::size_t i = 0; i < N; ++i) {
+                    hashes[i] = detail::phf_hash(keys[i], salt);
+                }
+                if (detail::phf_build(hashes, N, seeds_, slot_keys_, order, bucket_sizes)) {
+                    salt_ = salt;
+                    for (std::size_t slot = 0; slot < N; ++slot) {
+                        slot_names_[slot] = keys[slot_keys_[slot]];
+                    }
+                    return;
+                }
+            }
+            throw std::logic_error("static_perfect_hash: duplicate keys");
+        }
+    }
+
+    static constexpr std::size_t size() noexcept {
+        return N;
+    }
+
+    // Returns the index of `key` in the constructor's array, or npos.
+    constexpr std::size_t find(std::string_view key) const noexcept {
+        if constexpr (N == 0) {
+            return npos;
+        } else {
+            const auto hash = detail::phf_hash(key, salt_);
+            const auto slot = detail::phf_slot(hash, seeds_[detail::phf_bucket(hash, bucket_count)], N);
+            return slot_names_[slot] == key ? slot_keys_[slot] : npos;
+        }
+    }
+
+private:
+    static constexpr std::size_t bucket_count = detail::phf_bucket_count(N);
+
+    std::array<std::uint32_t, bucket_count> seeds_{};
+    std::array<std::uint32_t, N> slot_keys_{};
+    std::array<std::string_view, N> slot_names_{};
+    std::uint32_t salt_ = 0;
+};
+
+} // namespace basicpp::core
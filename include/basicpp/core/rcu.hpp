@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace basicpp::core {
+
+// Sleepable-RCU style read-side protection with sharded reader counters.
+//
+// Readers call read_lock()/read_unlock() around any access to RCU-published data: one relaxed load of the
+// current parity plus one fetch_add on a per-thread shard, so reads never wait (wait-free). A writer that has
+// unpublished an object calls synchronize(), which returns once every reader that could still see that object
+// has left its critical section; the object can then be destroyed.
+//
+// synchronize() flips the active parity twice and drains the counters of the parity it left each time
+// (the SRCU scheme), so a steady stream of new readers cannot starve a writer.
+// A reader must not call synchronize() on the same domain from inside its critical section.
+class rcu_domain {
+public:
+    struct read_token {
+        std::uint32_t shard;
+        std::uint32_t parity;
+    };
+
+    read_token read_lock() const noexcept {
+        const auto shard = this_thread_shard();
+        const auto parity = parity_.load(std::memory_order_relaxed);
+        // seq_cst orders the increment before the reader's subsequent load of the protected pointer,
+        // pairing with the writer's seq_cst publish / counter scan.
+        shards_[shard].readers[parity].fetch_add(1, std::memory_order_seq_cst);
+        return read_token{shard, parity};
+    }
+
+    void read_unlock(read_token token) const noexcept {
+        shards_[token.shard].readers[token.parity].fetch_sub(1, std::memory_order_release);
+    }
+
+    // Waits for all pre-existing readers. Callers must serialise synchronize() (e.g. under a writer mutex).
+    void synchronize() const noexcept {
+        for (int phase = 0; phase < 2; ++phase) {
+            const auto drained = parity_.load(std::memory_order_relaxed);
+            parity_.store(drained ^ 1u, std::memory_order_seq_cst);
+            wait_for_readers(drained);
+        }
+    }
+
+    // RAII helper for read_lock()/read_unlock().
+    class read_guard {
+    public:
+        explicit read_guard(const rcu_domain& domain) noexcept
+            : domain_(domain), token_(domain.read_lock()) {
+        }
+
+        read_guard(const read_guard&) = delete;
+        read_guard& operator=(const read_guard&) = delete;
+
+        ~read_guard() {
+            domain_.read_unlock(token_);
+        }
+
+    private:
+        const rcu_domain& domain_;
+        read_token token_;
+    };
+
+private:
+    static constexpr std::size_t shard_count = 32;
+
+    struct alignas(64) shard {
+        std::atomic<std::int64_t> readers[2] = {0, 0};
+    };
+
+    static std::uint32_t this_thread_shard() noexcept {
+        static std::atomic<std::uint32_t> next{0};
+        thread_local const std::uint32_t shard =
+            next.fetch_add(1, std::memory_order_relaxed) % static_cast<std::uint32_t>(shard_count);
+        return shard;
+    }
+
+    void wait_for_readers(std::uint32_t parity) const noexcept {
+        for (const auto& item : shards_) {
+            // seq_cst pairs with the caller's seq_cst unpublish and the readers' increments (store-load order).
+            for (unsigned spins = 0; item.readers[parity].load(std::memory_order_seq_cst) != 0; ++spins) {
+                if (spins > 64) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    mutable std::array<shard, shard_count> shards_{};
+    mutable std::atomic<std::uint32_t> parity_{0};
+};
+
+} // namespace basicpp::core
@@ -1,101 +1,334 @@
 #pragma once
 
-#include <optional>
+#include <functional>
+#include <memory>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace basicpp::core {
 
+template <typename T, typename E>
+class result;
+
+namespace detail {
+    template <typename R>
+    struct is_result : std::false_type {};
+
+    template <typename T, typename E>
+    struct is_result<result<T, E>> : std::true_type {};
+
+    // Constraints for the special members below. trivial_member subsumes the copy concepts, so the
+    // defaulted (trivial) overloads win over the hand-written ones whenever both are viable.
+    template <typename T>
+    concept copy_constructible_member = std::is_copy_constructible_v<T>;
+
+    template <typename T>
+    concept copy_assignable_member = copy_constructible_member<T> && std::is_copy_assignable_v<T>;
+
+    template <typename T>
+    concept trivial_member =
+        copy_assignable_member<T> && std::is_trivially_copy_constructible_v<T> &&
+        std::is_trivially_move_constructible_v<T> && std::is_trivially_copy_assignable_v<T> &&
+        std::is_trivially_move_assignable_v<T> && std::is_trivially_destructible_v<T>;
+
+    // Builds result<U, E> from the return value of a transform() callable, including U = void.
+    template <typename E, typename F, typename... Args>
+    constexpr auto invoke_into_result(F&& fn, Args&&... args) {
+        using value_type = std::remove_cv_t<std::invoke_result_t<F, Args...>>;
+        if constexpr (std::is_void_v<value_type>) {
+            std::invoke(std::forward<F>(fn), std::forward<Args>(args)...);
+            return result<void, E>::ok();
+        } else {
+            return result<value_type, E>::ok(std::invoke(std::forward<F>(fn), std::forward<Args>(args)...));
+        }
+    }
+} // namespace detail
+
 // Lightweight success/error carrier similar to std::expected
 // Provides basic accessors and value_or helpers; throws std::logic_error on misuse.
+// Storage is a discriminated union, so the object is as large as the bigger of T and E plus a flag,
+// and it is trivially copyable/destructible whenever T and E are.
 template <typename T, typename E>
 class result {
 public:
     using value_type = T;
     using error_type = E;
 
-    static result ok(T value) {
+    static constexpr result ok(T value) {
         return result(ok_tag{}, std::move(value));
     }
 
-    static result err(E error) {
+    static constexpr result err(E error) {
         return result(err_tag{}, std::move(error));
     }
 
-    bool has_value() const noexcept {
-        return value_.has_value();
+    // Like std::expected, a default-constructed result holds a value-initialised T.
+    constexpr result() requires std::is_default_constructible_v<T>
+        : value_(), has_value_(true) {
+    }
+
+    constexpr result(const result&) requires detail::trivial_member<T> && detail::trivial_member<E> = default;
+
+    constexpr result(const result& other) noexcept(std::is_nothrow_copy_constructible_v<T> &&
+                                                   std::is_nothrow_copy_constructible_v<E>)
+        requires detail::copy_constructible_member<T> && detail::copy_constructible_member<E>
+        : has_value_(other.has_value_) {
+        if (has_value_) {
+            std::construct_at(std::addressof(value_), other.value_);
+        } else {
+            std::construct_at(std::addressof(error_), other.error_);
+        }
+    }
+
+    constexpr result(result&&) requires detail::trivial_member<T> && detail::trivial_member<E> = default;
+
+    constexpr result(result&& other) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                              std::is_nothrow_move_constructible_v<E>)
+        : has_value_(other.has_value_) {
+        if (has_value_) {
+            std::construct_at(std::addressof(value_), std::move(other.value_));
+        } else {
+            std::construct_at(std::addressof(error_), std::move(other.error_));
+        }
+    }
+
+    constexpr result& operator=(const result&) requires detail::trivial_member<T> && detail::trivial_member<E> = default;
+
+    constexpr result& operator=(const result& other)
+        requires detail::copy_assignable_member<T> && detail::copy_assignable_member<E> {
+        if (this != std::addressof(other)) {
+            assign(other);
+        }
+        return *this;
+    }
+
+    constexpr result& operator=(result&&) requires detail::trivial_member<T> && detail::trivial_member<E> = default;
+
+    constexpr result& operator=(result&& other) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                         std::is_nothrow_move_constructible_v<E> &&
+                                                         std::is_nothrow_move_assignable_v<T> &&
+                                                         std::is_nothrow_move_assignable_v<E>) {
+        if (this != std::addressof(other)) {
+            assign(std::move(other));
+        }
+        return *this;
+    }
+
+    constexpr ~result() requires std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E> = default;
+
+    constexpr ~result() {
+        destroy();
+    }
+
+    constexpr bool has_value() const noexcept {
+        return has_value_;
     }
 
-    explicit operator bool() const noexcept {
+    constexpr explicit operator bool() const noexcept {
         return has_value();
     }
 
-    const T& value() const& {
+    constexpr const T& value() const& {
         ensure_value();
-        return *value_;
+        return value_;
     }
 
-    T& value() & {
+    constexpr T& value() & {
         ensure_value();
-        return *value_;
+        return value_;
     }
 
-    T&& value() && {
+    constexpr T&& value() && {
         ensure_value();
-        return std::move(*value_);
+        return std::move(value_);
     }
 
-    const E& error() const& {
+    constexpr const E& error() const& {
         ensure_error();
-        return *error_;
+        return error_;
     }
 
-    E& error() & {
+    constexpr E& error() & {
         ensure_error();
-        return *error_;
+        return error_;
     }
 
-    E&& error() && {
+    constexpr E&& error() && {
         ensure_error();
-        return std::move(*error_);
+        return std::move(error_);
     }
 
     template <typename U>
-    T value_or(U&& fallback) const& {
-        return value_.has_value() ? *value_ : static_cast<T>(std::forward<U>(fallback));
+    constexpr T value_or(U&& fallback) const& {
+        return has_value_ ? value_ : static_cast<T>(std::forward<U>(fallback));
     }
 
     template <typename U>
-    T value_or(U&& fallback) && {
-        return value_.has_value() ? std::move(*value_) : static_cast<T>(std::forward<U>(fallback));
+    constexpr T value_or(U&& fallback) && {
+        return has_value_ ? std::move(value_) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    // Monadic helpers. The rvalue overloads move the held value or error into the continuation,
+    // so chains such as parse().and_then(check).transform(lower) do not copy intermediates.
+
+    // fn(value) -> result<U, E>; errors propagate unchanged.
+    template <typename F>
+    constexpr auto and_then(F&& fn) & {
+        return and_then_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto and_then(F&& fn) const& {
+        return and_then_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto and_then(F&& fn) && {
+        return and_then_impl(std::move(*this), std::forward<F>(fn));
+    }
+
+    // fn(value) -> U, wrapped as result<U, E> (U may be void).
+    template <typename F>
+    constexpr auto transform(F&& fn) & {
+        return transform_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& fn) const& {
+        return transform_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& fn) && {
+        return transform_impl(std::move(*this), std::forward<F>(fn));
+    }
+
+    // fn(error) -> result<T, G>; values propagate unchanged.
+    template <typename F>
+    constexpr auto or_else(F&& fn) & {
+        return or_else_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto or_else(F&& fn) const& {
+        return or_else_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto or_else(F&& fn) && {
+        return or_else_impl(std::move(*this), std::forward<F>(fn));
+    }
+
+    // fn(error) -> G, wrapped as result<T, G>.
+    template <typename F>
+    constexpr auto transform_error(F&& fn) const& {
+        return transform_error_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto transform_error(F&& fn) && {
+        return transform_error_impl(std::move(*this), std::forward<F>(fn));
     }
 
 private:
     struct ok_tag {};
     struct err_tag {};
 
-    result(ok_tag, T value)
-        : value_(std::move(value)) {
+    constexpr result(ok_tag, T&& value)
+        : value_(std::move(value)), has_value_(true) {
+    }
+
+    constexpr result(err_tag, E&& error)
+        : error_(std::move(error)), has_value_(false) {
+    }
+
+    constexpr void destroy() noexcept {
+        if (has_value_) {
+            std::destroy_at(std::addressof(value_));
+        } else {
+            std::destroy_at(std::addressof(error_));
+        }
     }
 
-    result(err_tag, E error)
-        : error_(std::move(error)) {
+    template <typename Other>
+    constexpr void assign(Other&& other) {
+        if (has_value_ && other.has_value_) {
+            value_ = std::forward<Other>(other).value_;
+        } else if (!has_value_ && !other.has_value_) {
+            error_ = std::forward<Other>(other).error_;
+        } else if (other.has_value_) {
+            T replacement(std::forward<Other>(other).value_);
+            std::destroy_at(std::addressof(error_));
+            std::construct_at(std::addressof(value_), std::move(replacement));
+            has_value_ = true;
+        } else {
+            E replacement(std::forward<Other>(other).error_);
+            std::destroy_at(std::addressof(value_));
+            std::construct_at(std::addressof(error_), std::move(replacement));
+            has_value_ = false;
+        }
     }
 
-    void ensure_value() const {
-        if (!value_) {
+    constexpr void ensure_value() const {
+        if (!has_value_) {
             throw std::logic_error("basicpp::core::result accessed without value");
         }
     }
 
-    void ensure_error() const {
-        if (!error_) {
+    constexpr void ensure_error() const {
+        if (has_value_) {
             throw std::logic_error("basicpp::core::result accessed without error");
         }
     }
 
-    std::optional<T> value_;
-    std::optional<E> error_;
+    template <typename Self, typename F>
+    static constexpr auto and_then_impl(Self&& self, F&& fn) {
+        using next_type = std::remove_cvref_t<std::invoke_result_t<F, decltype(std::forward<Self>(self).value_)>>;
+        static_assert(detail::is_result<next_type>::value, "and_then continuation must return a result");
+        if (self.has_value_) {
+            return std::invoke(std::forward<F>(fn), std::forward<Self>(self).value_);
+        }
+        return next_type::err(std::forward<Self>(self).error_);
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_impl(Self&& self, F&& fn) {
+        using next_type = decltype(detail::invoke_into_result<E>(std::forward<F>(fn), std::forward<Self>(self).value_));
+        if (self.has_value_) {
+            return detail::invoke_into_result<E>(std::forward<F>(fn), std::forward<Self>(self).value_);
+        }
+        return next_type::err(std::forward<Self>(self).error_);
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto or_else_impl(Self&& self, F&& fn) {
+        using next_type = std::remove_cvref_t<std::invoke_result_t<F, decltype(std::forward<Self>(self).error_)>>;
+        static_assert(detail::is_result<next_type>::value, "or_else continuation must return a result");
+        if (!self.has_value_) {
+            return std::invoke(std::forward<F>(fn), std::forward<Self>(self).error_);
+        }
+        return next_type::ok(std::forward<Self>(self).value_);
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_error_impl(Self&& self, F&& fn) {
+        using next_error = std::remove_cv_t<std::invoke_result_t<F, decltype(std::forward<Self>(self).error_)>>;
+        using next_type = result<T, next_error>;
+        if (!self.has_value_) {
+            return next_type::err(std::invoke(std::forward<F>(fn), std::forward<Self>(self).error_));
+        }
+        return next_type::ok(std::forward<Self>(self).value_);
+    }
+
+    template <typename, typename>
+    friend class result;
+
+    union {
+        T value_;
+        E error_;
+    };
+    bool has_value_;
 };
 
 // Partial specialization for void success type.
@@ -105,63 +338,217 @@ public:
     using value_type = void;
     using error_type = E;
 
-    static result ok() {
+    static constexpr result ok() {
         return result(ok_tag{});
     }
 
-    static result err(E error) {
+    static constexpr result err(E error) {
         return result(err_tag{}, std::move(error));
     }
 
-    bool has_value() const noexcept {
+    constexpr result() noexcept
+        : empty_(), has_value_(true) {
+    }
+
+    constexpr result(const result&) requires detail::trivial_member<E> = default;
+
+    constexpr result(const result& other) noexcept(std::is_nothrow_copy_constructible_v<E>)
+        requires detail::copy_constructible_member<E>
+        : empty_(), has_value_(other.has_value_) {
+        if (!has_value_) {
+            std::construct_at(std::addressof(error_), other.error_);
+        }
+    }
+
+    constexpr result(result&&) requires detail::trivial_member<E> = default;
+
+    constexpr result(result&& other) noexcept(std::is_nothrow_move_constructible_v<E>)
+        : empty_(), has_value_(other.has_value_) {
+        if (!has_value_) {
+            std::construct_at(std::addressof(error_), std::move(other.error_));
+        }
+    }
+
+    constexpr result& operator=(const result&) requires detail::trivial_member<E> = default;
+
+    constexpr result& operator=(const result& other)
+        requires detail::copy_assignable_member<E> {
+        if (this != std::addressof(other)) {
+            assign(other);
+        }
+        return *this;
+    }
+
+    constexpr result& operator=(result&&) requires detail::trivial_member<E> = default;
+
+    constexpr result& operator=(result&& other) noexcept(std::is_nothrow_move_constructible_v<E> &&
+                                                         std::is_nothrow_move_assignable_v<E>) {
+        if (this != std::addressof(other)) {
+            assign(std::move(other));
+        }
+        return *this;
+    }
+
+    constexpr ~result() requires std::is_trivially_destructible_v<E> = default;
+
+    constexpr ~result() {
+        if (!has_value_) {
+            std::destroy_at(std::addressof(error_));
+        }
+    }
+
+    constexpr bool has_value() const noexcept {
         return has_value_;
     }
 
-    explicit operator bool() const noexcept {
+    constexpr explicit operator bool() const noexcept {
         return has_value();
     }
 
-    void value() const {
+    constexpr void value() const {
         if (!has_value_) {
             throw std::logic_error("basicpp::core::result<void, E> accessed without value");
         }
     }
 
-    const E& error() const& {
+    constexpr const E& error() const& {
         ensure_error();
-        return *error_;
+        return error_;
     }
 
-    E& error() & {
+    constexpr E& error() & {
         ensure_error();
-        return *error_;
+        return error_;
     }
 
-    E&& error() && {
+    constexpr E&& error() && {
         ensure_error();
-        return std::move(*error_);
+        return std::move(error_);
+    }
+
+    // fn() -> result<U, E>; errors propagate unchanged.
+    template <typename F>
+    constexpr auto and_then(F&& fn) const& {
+        return and_then_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto and_then(F&& fn) && {
+        return and_then_impl(std::move(*this), std::forward<F>(fn));
+    }
+
+    // fn() -> U, wrapped as result<U, E>.
+    template <typename F>
+    constexpr auto transform(F&& fn) const& {
+        return transform_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto transform(F&& fn) && {
+        return transform_impl(std::move(*this), std::forward<F>(fn));
+    }
+
+    // fn(error) -> result<void, G>; success propagates unchanged.
+    template <typename F>
+    constexpr auto or_else(F&& fn) const& {
+        return or_else_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto or_else(F&& fn) && {
+        return or_else_impl(std::move(*this), std::forward<F>(fn));
+    }
+
+    // fn(error) -> G, wrapped as result<void, G>.
+    template <typename F>
+    constexpr auto transform_error(F&& fn) const& {
+        return transform_error_impl(*this, std::forward<F>(fn));
+    }
+
+    template <typename F>
+    constexpr auto transform_error(F&& fn) && {
+        return transform_error_impl(std::move(*this), std::forward<F>(fn));
     }
 
 private:
     struct ok_tag {};
     struct err_tag {};
+    struct empty_type {};
 
-    explicit result(ok_tag)
-        : has_value_(true) {
+    explicit constexpr result(ok_tag)
+        : empty_(), has_value_(true) {
     }
 
-    result(err_tag, E error)
-        : has_value_(false), error_(std::move(error)) {
+    constexpr result(err_tag, E&& error)
+        : error_(std::move(error)), has_value_(false) {
     }
 
-    void ensure_error() const {
-        if (!error_) {
+    template <typename Other>
+    constexpr void assign(Other&& other) {
+        if (!has_value_ && !other.has_value_) {
+            error_ = std::forward<Other>(other).error_;
+        } else if (!has_value_) {
+            std::destroy_at(std::addressof(error_));
+            has_value_ = true;
+        } else if (!other.has_value_) {
+            std::construct_at(std::addressof(error_), std::forward<Other>(other).error_);
+            has_value_ = false;
+        }
+    }
+
+    constexpr void ensure_error() const {
+        if (has_value_) {
             throw std::logic_error("basicpp::core::result<void, E> accessed without error");
         }
     }
 
-    bool has_value_ = false;
-    std::optional<E> error_;
+    template <typename Self, typename F>
+    static constexpr auto and_then_impl(Self&& self, F&& fn) {
+        using next_type = std::remove_cvref_t<std::invoke_result_t<F>>;
+        static_assert(detail::is_result<next_type>::value, "and_then continuation must return a result");
+        if (self.has_value_) {
+            return std::invoke(std::forward<F>(fn));
+        }
+        return next_type::err(std::forward<Self>(self).error_);
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_impl(Self&& self, F&& fn) {
+        using next_type = decltype(detail::invoke_into_result<E>(std::forward<F>(fn)));
+        if (self.has_value_) {
+            return detail::invoke_into_result<E>(std::forward<F>(fn));
+        }
+        return next_type::err(std::forward<Self>(self).error_);
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto or_else_impl(Self&& self, F&& fn) {
+        using next_type = std::remove_cvref_t<std::invoke_result_t<F, decltype(std::forward<Self>(self).error_)>>;
+        static_assert(detail::is_result<next_type>::value, "or_else continuation must return a result");
+        if (!self.has_value_) {
+            return std::invoke(std::forward<F>(fn), std::forward<Self>(self).error_);
+        }
+        return next_type::ok();
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto transform_error_impl(Self&& self, F&& fn) {
+        using next_error = std::remove_cv_t<std::invoke_result_t<F, decltype(std::forward<Self>(self).error_)>>;
+        using next_type = result<void, next_error>;
+        if (!self.has_value_) {
+            return next_type::err(std::invoke(std::forward<F>(fn), std::forward<Self>(self).error_));
+        }
+        return next_type::ok();
+    }
+
+    template <typename, typename>
+    friend class result;
+
+    union {
+        empty_type empty_;
+        E error_;
+    };
+    bool has_value_;
 };
 
 } // namespace basicpp::core
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace basicpp::core {
+
+template <typename T = void>
+class task;
+
+namespace detail {
+    struct task_promise_base {
+        struct final_awaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            // Symmetric transfer to whoever awaited the task, so long await chains do not grow the stack.
+            template <typename TPromise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> handle) const noexcept {
+                return handle.promise().continuation;
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        final_awaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+        std::exception_ptr exception;
+    };
+
+    template <typename T>
+    struct task_promise : task_promise_base {
+        task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U&& value) {
+            result.emplace(std::forward<U>(value));
+        }
+
+        T take() {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+            return std::move(*result);
+        }
+
+        std::optional<T> result;
+    };
+
+    template <>
+    struct task_promise<void> : task_promise_base {
+        task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {
+        }
+
+        void take() const {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+} // namespace detail
+
+// Lazily started coroutine returning T. Nothing runs until the task is co_awaited (or passed to
+// sync_wait); completion resumes the awaiting coroutine directly. A task is move-only and may be awaited once.
+template <typename T>
+class task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using value_type = T;
+
+    task() noexcept = default;
+
+    explicit task(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle) {
+    }
+
+    task(task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    ~task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool valid() const noexcept {
+        return static_cast<bool>(handle_);
+    }
+
+    auto operator co_await() && noexcept {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept {
+                return handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() {
+                return handle.promise().take();
+            }
+        };
+        return awaiter{handle_};
+    }
+
+    auto operator co_await() & noexcept {
+        return std::move(*this).operator co_await();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+    template <typename T>
+    task<T> task_promise<T>::get_return_object() noexcept {
+        return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+    }
+
+    inline task<void> task_promise<void>::get_return_object() noexcept {
+        return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+    }
+
+    // Eagerly started coroutine that frees itself on completion; used to drive tasks from plain code.
+    struct detached_task {
+        struct promise_type {
+            detached_task get_return_object() const noexcept {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            std::suspend_never final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    struct blocking_signal {
+        void set() {
+            // Notify under the lock: the waiter owns this object and may destroy it as soon as it sees `done`.
+            std::lock_guard lock(mutex);
+            done = true;
+            ready.notify_one();
+        }
+
+        void wait() {
+            std::unique_lock lock(mutex);
+            ready.wait(lock, [this] { return done; });
+        }
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        bool done = false;
+    };
+
+    template <typename T>
+    detached_task run_blocking(task<T>& work, std::optional<std::conditional_t<std::is_void_v<T>, bool, T>>& result,
+                               std::exception_ptr& error, blocking_signal& signal) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await work;
+                result.emplace(true);
+            } else {
+                result.emplace(co_await work);
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+        signal.set();
+    }
+
+    struct when_all_state {
+        explicit when_all_state(std::size_t count) noexcept
+            : remaining(count + 1) {
+        }
+
+        // The extra count held by the awaiter stops a task that finishes during start-up from resuming
+        // the parent before every task has been launched.
+        bool arrive() noexcept {
+            return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        std::atomic<std::size_t> remaining;
+        std::coroutine_handle<> continuation;
+    };
+
+    template <typename T>
+    detached_task when_all_item(task<T>& work, std::optional<T>& result, std::exception_ptr& error,
+                                when_all_state& state) {
+        try {
+            result.emplace(co_await work);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        if (state.arrive()) {
+            state.continuation.resume();
+        }
+    }
+} // namespace detail
+
+// Blocks the calling thread until `work` completes and returns its value (or rethrows its exception).
+template <typename T>
+T sync_wait(task<T> work) {
+    std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+    std::exception_ptr error;
+    detail::blocking_signal signal;
+    detail::run_blocking(work, result, error, signal);
+    signal.wait();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*result);
+    }
+}
+
+// Runs all tasks concurrently (each continues on whatever executor it schedules itself on) and completes
+// once every one has finished, yielding their values in input order. The first exception is rethrown.
+template <typename T>
+task<std::vector<T>> when_all(std::vector<task<T>> tasks) {
+    std::vector<std::optional<T>> results(tasks.size());
+    std::vector<std::exception_ptr> errors(tasks.size());
+    detail::when_all_state state(tasks.size());
+
+    struct start_all {
+        std::vector<task<T>>& tasks;
+        std::vector<std::optional<T>>& results;
+        std::vector<std::exception_ptr>& errors;
+        detail::when_all_state& state;
+
+        bool await_ready() const noexcept {
+            return tasks.empty();
+        }
+
+        bool await_suspend(std::coroutine_handle<> parent) {
+            state.continuation = parent;
+            for (std::size_t i = 0; i < tasks.size(); ++i) {
+                detail::when_all_item(tasks[i], results[i], errors[i], state);
+            }
+            return !state.arrive();
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    co_await start_all{tasks, results, errors, state};
+
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    std::vector<T> values;
+    values.reserve(results.size());
+    for (auto& result : results) {
+        values.push_back(std::move(*result));
+    }
+    co_return values;
+}
+
+} // namespace basicpp::core
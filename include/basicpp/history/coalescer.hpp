@@ -3,20 +3,24 @@
 #include <chrono>
 #include <functional>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace basicpp::history {
 
 // Coalesces a stream of values inside a fixed time window.
 // Useful to collapse frequent updates (e.g., edits) before pushing to history stacks.
-template <typename TValue, typename TClock = std::chrono::steady_clock>
+// TCombine defaults to std::function; pass a lambda type (see make_coalescer) or core::inplace_function
+// to avoid type erasure or heap-allocated captures.
+template <typename TValue, typename TClock = std::chrono::steady_clock,
+          typename TCombine = std::function<TValue(const TValue&, const TValue&)>>
 class coalescer {
 public:
     using value_type = TValue;
     using clock_type = TClock;
     using time_point = typename clock_type::time_point;
     using duration = typename clock_type::duration;
-    using combine_fn = std::function<value_type(const value_type&, const value_type&)>;
+    using combine_fn = TCombine;
 
     coalescer(duration window, combine_fn combine)
         : window_(window), combine_(std::move(combine)) {
@@ -77,4 +81,10 @@ private:
     std::optional<time_point> first_timestamp_;
 };
 
+// Builds a coalescer that stores `combine` by its own type, so calls can be inlined.
+template <typename TValue, typename TClock = std::chrono::steady_clock, typename TCombine>
+coalescer<TValue, TClock, std::decay_t<TCombine>> make_coalescer(typename TClock::duration window, TCombine&& combine) {
+    return coalescer<TValue, TClock, std::decay_t<TCombine>>(window, std::forward<TCombine>(combine));
+}
+
 } // namespace basicpp::history
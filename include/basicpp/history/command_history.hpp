@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/history/undo_stack.hpp>
+
+namespace basicpp::history {
+
+// Undo/redo for commands dispatched through a command::basic_registry.
+//
+// Each command is registered with its inverse, which takes the same arguments. execute() dispatches the
+// command and, when it succeeds, records the two resolved handles and a copy of the arguments in the same
+// ring undo_stack uses (bounded by history_limits; each record is charged its size plus the heap footprint
+// of its arguments). undo() dispatches the inverse of the newest record and redo() the command again; when
+// either fails the history is left unchanged and the error is returned. Executing a command that has no
+// inverse succeeds but clears the history, since nothing before it can be undone any more.
+template <typename TPolicy, typename TResult, typename... TArgs>
+class basic_command_history {
+public:
+    using registry_type = command::basic_registry<TPolicy, TResult, TArgs...>;
+    using handler_type = typename registry_type::handler_type;
+    using handler_result = typename registry_type::handler_result;
+    using error_type = typename registry_type::error_type;
+
+    explicit basic_command_history(history_limits limits = {})
+        : ring_(limits) {
+    }
+
+    // Registers (or replaces) `key` with `inverse` as its undo; returns true when the key is new.
+    bool register_command(std::string key, handler_type execute, handler_type inverse) {
+        inverses_.register_handler(key, std::move(inverse));
+        return commands_.register_handler(std::move(key), std::move(execute));
+    }
+
+    // A command without an inverse; executing it clears the history.
+    bool register_command(std::string key, handler_type execute) {
+        inverses_.unregister_handler(key);
+        return commands_.register_handler(std::move(key), std::move(execute));
+    }
+
+    void unregister_command(std::string_view key) {
+        commands_.unregister_handler(key);
+        inverses_.unregister_handler(key);
+    }
+
+    handler_result execute(std::string_view key, TArgs... args) {
+        const auto command = commands_.resolve(key);
+        if (!command) {
+            return commands_.dispatch(key, std::move(args)...);
+        }
+        auto result = commands_.dispatch(command, args...);
+        if (!result) {
+            return result;
+        }
+        const auto inverse = inverses_.resolve(key);
+        if (!inverse) {
+            ring_.clear();
+            return result;
+        }
+        const auto entry_bytes = sizeof(record) + (heap_bytes(args) + ... + 0);
+        ring_.push(record{command, inverse, arguments(std::move(args)...)}, entry_bytes);
+        return result;
+    }
+
+    handler_result undo() {
+        if (ring_.undo_count() == 0) {
+            return nothing_to("nothing to undo");
+        }
+        auto& entry = ring_.undo_entry();
+        auto result =
+            std::apply([&](auto&... args) { return inverses_.dispatch(entry.inverse, args...); }, entry.args);
+        if (result) {
+            ring_.step_back();
+        }
+        return result;
+    }
+
+    handler_result redo() {
+        if (ring_.redo_count() == 0) {
+            return nothing_to("nothing to redo");
+        }
+        auto& entry = ring_.redo_entry();
+        auto result =
+            std::apply([&](auto&... args) { return commands_.dispatch(entry.command, args...); }, entry.args);
+        if (result) {
+            ring_.step_forward();
+        }
+        return result;
+    }
+
+    bool can_undo() const noexcept {
+        return ring_.undo_count() != 0;
+    }
+
+    bool can_redo() const noexcept {
+        return ring_.redo_count() != 0;
+    }
+
+    std::size_t undo_count() const noexcept {
+        return ring_.undo_count();
+    }
+
+    std::size_t redo_count() const noexcept {
+        return ring_.redo_count();
+    }
+
+    void clear() noexcept {
+        ring_.clear();
+    }
+
+    // The forward commands, e.g. for dispatching without recording history.
+    const registry_type& commands() const noexcept {
+        return commands_;
+    }
+
+private:
+    using arguments = std::tuple<std::decay_t<TArgs>...>;
+
+    struct record {
+        command::handler_handle command;
+        command::handler_handle inverse;
+        arguments args;
+    };
+
+    // What an argument owns beyond its inline size, which sizeof(record) already counts.
+    template <typename T>
+    static std::size_t heap_bytes(const T& value) noexcept {
+        return detail::footprint(value) - sizeof(T);
+    }
+
+    static handler_result nothing_to(const char* message) {
+        return handler_result::err(core::error_factory<error_type>::make(core::errc::invalid_argument, message));
+    }
+
+    registry_type commands_;
+    registry_type inverses_;
+    detail::history_ring<record> ring_;
+};
+
+template <typename TResult, typename... TArgs>
+using command_history = basic_command_history<command::registry_policy<>, TResult, TArgs...>;
+
+} // namespace basicpp::history
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace basicpp::history {
+
+namespace detail {
+    // Per-thread starting slot, so producers on different threads usually land on different slots.
+    inline std::size_t producer_hint() noexcept {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t hint = next.fetch_add(1, std::memory_order_relaxed);
+        return hint;
+    }
+} // namespace detail
+
+// Coalescer that any number of threads may push to without a lock; one thread consumes.
+//
+// Window semantics match coalescer: the window starts at the earliest push since the last emitted value and
+// consume(now) returns the combined value once `now - start >= window`. Producers combine into one of
+// NSlots cache-line-sized slots (each thread starts at its own slot and moves on if another thread holds it),
+// so pushes from different threads do not share a value or a cache line. consume merges the slots.
+//
+// Each slot has two buffers selected by an epoch. consume advances the epoch, waits for pushes still writing
+// to the old buffers (a combine call at most) and merges them; pushes never wait. TCombine is stored by
+// type so it can be inlined. Values from one thread are combined in push order; values from different
+// threads are merged in slot order, so the combine function should not depend on cross-thread order.
+template <typename TValue, typename TCombine, typename TClock = std::chrono::steady_clock, std::size_t NSlots = 16>
+class concurrent_coalescer {
+public:
+    static_assert(NSlots != 0, "concurrent_coalescer: at least one slot is required");
+
+    using value_type = TValue;
+    using clock_type = TClock;
+    using time_point = typename clock_type::time_point;
+    using duration = typename clock_type::duration;
+    using combine_fn = TCombine;
+
+    static constexpr std::size_t slot_count = NSlots;
+
+    explicit concurrent_coalescer(duration window, combine_fn combine = combine_fn{})
+        : window_(window), combine_(std::move(combine)) {
+    }
+
+    concurrent_coalescer(const concurrent_coalescer&) = delete;
+    concurrent_coalescer& operator=(const concurrent_coalescer&) = delete;
+
+    // Safe to call from any thread.
+    void push(const value_type& value, time_point now = clock_type::now()) {
+        push_impl(value, now);
+    }
+
+    void push(value_type&& value, time_point now = clock_type::now()) {
+        push_impl(std::move(value), now);
+    }
+
+    bool has_pending() const noexcept {
+        return starts_[epoch_.load(std::memory_order_acquire) & 1].load(std::memory_order_acquire) != no_start;
+    }
+
+    // Consumer thread only.
+    std::optional<value_type> consume(time_point now = clock_type::now()) {
+        const auto epoch = epoch_.load(std::memory_order_relaxed);
+        const auto start = starts_[epoch & 1].load(std::memory_order_acquire);
+        if (start == no_start || now.time_since_epoch().count() - start < window_.count()) {
+            return std::nullopt;
+        }
+        return drain(epoch);
+    }
+
+    // Consumer thread only: drops everything pushed so far.
+    void reset() {
+        drain(epoch_.load(std::memory_order_relaxed));
+    }
+
+private:
+    using rep = typename duration::rep;
+
+    static constexpr rep no_start = std::numeric_limits<rep>::max();
+
+    struct alignas(64) slot {
+        // 0 when free, otherwise 1 + the epoch of the push writing to the slot.
+        std::atomic<std::uint64_t> owner{0};
+        std::array<std::optional<value_type>, 2> buffers;
+    };
+
+    template <typename U>
+    void push_impl(U&& value, time_point now) {
+        const auto stamp = now.time_since_epoch().count();
+        auto index = detail::producer_hint();
+        for (;;) {
+            auto& target = slots_[index % NSlots];
+            const auto epoch = epoch_.load(std::memory_order_seq_cst);
+            std::uint64_t expected = 0;
+            if (!target.owner.compare_exchange_strong(expected, epoch + 1, std::memory_order_seq_cst)) {
+                ++index; // held by another producer
+                continue;
+            }
+            // The consumer may have advanced the epoch between the load and the claim, in which case the buffer
+            // for `epoch` could be draining; try again against the new one.
+            if (epoch_.load(std::memory_order_seq_cst) != epoch) {
+                target.owner.store(0, std::memory_order_release);
+                continue;
+            }
+
+            // Released even if combine_ throws, so a drain never waits on an abandoned slot.
+            struct release_slot {
+                std::atomic<std::uint64_t>& owner;
+                ~release_slot() {
+                    owner.store(0, std::memory_order_release);
+                }
+            } guard{target.owner};
+
+            note_start(starts_[epoch & 1], stamp);
+            auto& pending = target.buffers[epoch & 1];
+            if (!pending) {
+                pending = std::forward<U>(value);
+            } else {
+                pending = combine_(*pending, std::forward<U>(value));
+            }
+            return;
+        }
+    }
+
+    static void note_start(std::atomic<rep>& start, rep stamp) noexcept {
+        auto current = start.load(std::memory_order_relaxed);
+        while (stamp < current && !start.compare_exchange_weak(current, stamp, std::memory_order_release,
+                                                               std::memory_order_relaxed)) {
+        }
+    }
+
+    std::optional<value_type> drain(std::uint64_t epoch) {
+        epoch_.store(epoch + 1, std::memory_order_seq_cst);
+
+        std::optional<value_type> result;
+        for (auto& target : slots_) {
+            while (target.owner.load(std::memory_order_acquire) == epoch + 1) {
+                std::this_thread::yield();
+            }
+            auto& pending = target.buffers[epoch & 1];
+            if (!pending) {
+                continue;
+            }
+            if (!result) {
+                result = std::move(pending);
+            } else {
+                result = combine_(*result, std::move(*pending));
+            }
+            pending.reset();
+        }
+        starts_[epoch & 1].store(no_start, std::memory_order_relaxed);
+        return result;
+    }
+
+    duration window_;
+    combine_fn combine_;
+    alignas(64) std::atomic<std::uint64_t> epoch_{0};
+    std::array<std::atomic<rep>, 2> starts_{no_start, no_start};
+    std::array<slot, NSlots> slots_{};
+};
+
+// Builds a concurrent_coalescer that stores `combine` by its own type.
+template <typename TValue, typename TClock = std::chrono::steady_clock, std::size_t NSlots = 16, typename TCombine>
+concurrent_coalescer<TValue, std::decay_t<TCombine>, TClock, NSlots> make_concurrent_coalescer(
+    typename TClock::duration window, TCombine&& combine) {
+    return concurrent_coalescer<TValue, std::decay_t<TCombine>, TClock, NSlots>(window, std::forward<TCombine>(combine));
+}
+
+} // namespace basicpp::history
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <basicpp/core/flat_hash_map.hpp>
+
+namespace basicpp::history {
+
+// Coalesces an independent value stream per key, each with its own window.
+//
+// The first push for a key starts its window; later pushes are combined into the pending value, and
+// poll(now) hands out every key whose window has elapsed. Pending entries live in a node pool indexed by a
+// core::flat_hash_map, and deadlines are kept in a four-level hierarchical timing wheel of 64 slots per
+// level, so push and expiry are O(1) and a poll touches only the slots it passes, never the idle keys.
+// Deadlines are rounded up to `resolution`, so a key is emitted no earlier than its window and at most one
+// resolution later (the default resolution is window / 64).
+template <typename K, typename V, typename TClock = std::chrono::steady_clock,
+          typename TCombine = std::function<V(const V&, const V&)>, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class keyed_coalescer {
+public:
+    using key_type = K;
+    using value_type = V;
+    using clock_type = TClock;
+    using time_point = typename clock_type::time_point;
+    using duration = typename clock_type::duration;
+    using combine_fn = TCombine;
+
+    keyed_coalescer(duration window, combine_fn combine, duration resolution = duration::zero())
+        : window_(window),
+          resolution_(resolution > duration::zero() ? resolution : std::max(window / 64, duration{1})),
+          combine_(std::move(combine)) {
+        for (auto& level : heads_) {
+            level.fill(none);
+        }
+    }
+
+    std::size_t size() const noexcept {
+        return index_.size();
+    }
+
+    bool empty() const noexcept {
+        return index_.empty();
+    }
+
+    template <typename Q>
+    bool contains(const Q& key) const noexcept {
+        return index_.contains(key);
+    }
+
+    void reserve(std::size_t count) {
+        index_.reserve(count);
+        nodes_.reserve(count);
+    }
+
+    void push(const key_type& key, const value_type& value, time_point now = clock_type::now()) {
+        push_impl(key, value, now);
+    }
+
+    void push(const key_type& key, value_type&& value, time_point now = clock_type::now()) {
+        push_impl(key, std::move(value), now);
+    }
+
+    // Calls fn(const K&, V&) for every key whose window elapsed by `now`, earliest deadline first, and drops
+    // those keys; returns how many were emitted. fn may push (a key it receives starts a new window) but must
+    // not call erase or clear.
+    template <typename F>
+    std::size_t poll(time_point now, F&& fn) {
+        const auto target = to_tick(now);
+        std::size_t emitted = 0;
+        while (current_ <= target) {
+            if (index_.empty()) {
+                current_ = target + 1;
+                break;
+            }
+            if ((current_ & slot_mask) == 0) {
+                cascade();
+            }
+
+            const auto slot = static_cast<unsigned>(current_ & slot_mask);
+            auto head = std::exchange(heads_[0][slot], none);
+            occupied_[0] &= ~(std::uint64_t{1} << slot);
+
+            current_ = std::min(next_busy_tick(), target + 1);
+
+            while (head != none) {
+                auto& expired = nodes_[head];
+                const auto following = expired.next;
+                index_.erase(expired.key);
+                auto key = std::move(expired.key);
+                auto value = std::move(expired.value);
+                release(head);
+                fn(std::as_const(key), value);
+                ++emitted;
+                head = following;
+            }
+        }
+        return emitted;
+    }
+
+    // Same as poll(now, fn), collecting the expired entries.
+    std::vector<std::pair<key_type, value_type>> poll(time_point now = clock_type::now()) {
+        std::vector<std::pair<key_type, value_type>> expired;
+        poll(now, [&expired](const key_type& key, value_type& value) { expired.emplace_back(key, std::move(value)); });
+        return expired;
+    }
+
+    // Drops the pending value of `key` without emitting it.
+    template <typename Q>
+    bool erase(const Q& key) {
+        const auto* id = index_.find(key);
+        if (!id) {
+            return false;
+        }
+        const auto node = *id;
+        unlink(node);
+        index_.erase(key);
+        release(node);
+        return true;
+    }
+
+    void clear() noexcept {
+        index_.clear();
+        nodes_.clear();
+        free_ = none;
+        for (auto& level : heads_) {
+            level.fill(none);
+        }
+        occupied_.fill(0);
+    }
+
+private:
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+    static constexpr unsigned levels = 4;
+    static constexpr unsigned slot_bits = 6;
+    static constexpr std::uint64_t slot_mask = (std::uint64_t{1} << slot_bits) - 1;
+
+    struct node {
+        key_type key;
+        value_type value;
+        std::uint64_t deadline = 0;
+        std::uint32_t prev = none;
+        std::uint32_t next = none; // also links the free list
+        std::uint8_t level = 0;
+        std::uint8_t slot = 0;
+    };
+
+    template <typename U>
+    void push_impl(const key_type& key, U&& value, time_point now) {
+        auto [id, inserted] = index_.try_emplace(key, none);
+        if (!inserted) {
+            auto& pending = nodes_[*id].value;
+            pending = combine_(pending, std::forward<U>(value));
+            return;
+        }
+
+        *id = acquire(key, std::forward<U>(value));
+        if (index_.size() == 1) {
+            // Nothing is scheduled, so the wheel can jump straight to the present.
+            current_ = std::max(current_, to_tick(now));
+        }
+        const auto start = now.time_since_epoch() < duration::zero() ? duration::zero() : now.time_since_epoch();
+        const auto end = static_cast<std::uint64_t>((start + window_).count());
+        const auto step = static_cast<std::uint64_t>(resolution_.count());
+        nodes_[*id].deadline = std::max(end / step + (end % step != 0 ? 1 : 0), current_);
+        schedule(*id);
+    }
+
+    std::uint64_t to_tick(time_point now) const noexcept {
+        const auto count = now.time_since_epoch().count();
+        return count <= 0 ? 0 : static_cast<std::uint64_t>(count) / static_cast<std::uint64_t>(resolution_.count());
+    }
+
+    template <typename U>
+    std::uint32_t acquire(const key_type& key, U&& value) {
+        if (free_ != none) {
+            const auto id = free_;
+            auto& reused = nodes_[id];
+            free_ = reused.next;
+            reused.key = key;
+            reused.value = std::forward<U>(value);
+            return id;
+        }
+        if (nodes_.size() == none) {
+            throw std::length_error("keyed_coalescer: too many pending keys");
+        }
+        nodes_.push_back(node{key, std::forward<U>(value)});
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void release(std::uint32_t id) noexcept {
+        nodes_[id].next = free_;
+        free_ = id;
+    }
+
+    // Files a node under the lowest level whose span covers its deadline, measured from current_.
+    void schedule(std::uint32_t id) noexcept {
+        auto& item = nodes_[id];
+        const auto delta = item.deadline - current_;
+        unsigned level = 0;
+        while (level + 1 < levels && delta >> (slot_bits * (level + 1)) != 0) {
+            ++level;
+        }
+        // Beyond the top level's span: park in its last slot and reschedule when that slot cascades.
+        const auto position = delta >> (slot_bits * levels) != 0 ? (current_ >> (slot_bits * level)) + slot_mask
+                                                                    : item.deadline >> (slot_bits * level);
+        const auto slot = static_cast<unsigned>(position & slot_mask);
+
+        item.level = static_cast<std::uint8_t>(level);
+        item.slot = static_cast<std::uint8_t>(slot);
+        item.prev = none;
+        item.next = heads_[level][slot];
+        if (item.next != none) {
+            nodes_[item.next].prev = id;
+        }
+        heads_[level][slot] = id;
+        occupied_[level] |= std::uint64_t{1} << slot;
+    }
+
+    void unlink(std::uint32_t id) noexcept {
+        const auto& item = nodes_[id];
+        if (item.prev != none) {
+            nodes_[item.prev].next = item.next;
+        } else {
+            heads_[item.level][item.slot] = item.next;
+            if (item.next == none) {
+                occupied_[item.level] &= ~(std::uint64_t{1} << item.slot);
+            }
+        }
+        if (item.next != none) {
+            nodes_[item.next].prev = item.prev;
+        }
+    }
+
+    // The first tick after current_ at which a slot of some level is due: a level-0 slot expires, or an
+    // occupied upper slot cascades. Ticks in between have nothing to do and are skipped.
+    std::uint64_t next_busy_tick() const noexcept {
+        auto next = std::numeric_limits<std::uint64_t>::max();
+        for (unsigned level = 0; level < levels; ++level) {
+            if (occupied_[level] == 0) {
+                continue;
+            }
+            const auto shift = slot_bits * level;
+            const auto base = current_ >> shift;
+            const auto from = static_cast<int>((base + 1) & slot_mask);
+            const auto distance = 1 + static_cast<std::uint64_t>(std::countr_zero(std::rotr(occupied_[level], from)));
+            next = std::min(next, (base + distance) << shift);
+        }
+        return next;
+    }
+
+    // At a multiple of 64 ticks, moves the slots that current_ has just reached on the upper levels down,
+    // highest level first.
+    void cascade() noexcept {
+        unsigned top = 1;
+        while (top + 1 < levels && (current_ & ((std::uint64_t{1} << (slot_bits * (top + 1))) - 1)) == 0) {
+            ++top;
+        }
+        for (auto level = top; level >= 1; --level) {
+            const auto slot = static_cast<unsigned>((current_ >> (slot_bits * level)) & slot_mask);
+            auto head = std::exchange(heads_[level][slot], none);
+            occupied_[level] &= ~(std::uint64_t{1} << slot);
+            while (head != none) {
+                const auto following = nodes_[head].next;
+                schedule(head);
+                head = following;
+            }
+        }
+    }
+
+    duration window_;
+    duration resolution_;
+    combine_fn combine_;
+    core::flat_hash_map<key_type, std::uint32_t, Hash, KeyEqual> index_;
+    std::vector<node> nodes_;
+    std::uint32_t free_ = none;
+    std::uint64_t current_ = 0;
+    std::array<std::array<std::uint32_t, std::size_t{1} << slot_bits>, levels> heads_{};
+    std::array<std::uint64_t, levels> occupied_{};
+};
+
+// Builds a keyed_coalescer that stores `combine` by its own type.
+template <typename K, typename V, typename TClock = std::chrono::steady_clock, typename TCombine>
+keyed_coalescer<K, V, TClock, std::decay_t<TCombine>> make_keyed_coalescer(typename TClock::duration window,
+                                                                          TCombine&& combine) {
+    return keyed_coalescer<K, V, TClock, std::decay_t<TCombine>>(window, std::forward<TCombine>(combine));
+}
+
+} // namespace basicpp::history
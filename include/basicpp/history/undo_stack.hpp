@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace basicpp::history {
+
+// Bounds for undo_stack and command_history. The oldest entries are dropped once either limit is exceeded;
+// max_bytes == 0 means no byte limit. The newest entry is always kept, even if it alone exceeds max_bytes.
+struct history_limits {
+    std::size_t max_entries = 1024;
+    std::size_t max_bytes = 0;
+};
+
+namespace detail {
+    // Approximate heap footprint of a value: its own size plus the elements of a sized container.
+    template <typename T>
+    std::size_t footprint(const T& value) noexcept {
+        if constexpr (requires { value.size(); typename T::value_type; }) {
+            return sizeof(T) + value.size() * sizeof(typename T::value_type);
+        } else {
+            return sizeof(T);
+        }
+    }
+
+    // Undo/redo entries in a ring allocated once at max_entries slots. Entries [0, cursor) can be undone
+    // and [cursor, count) redone, oldest first; pushing drops the redo entries, then evicts from the front
+    // until the limits hold.
+    template <typename E>
+    class history_ring {
+    public:
+        explicit history_ring(history_limits limits)
+            : limits_(limits), slots_(std::max<std::size_t>(1, limits.max_entries)) {
+        }
+
+        std::size_t undo_count() const noexcept {
+            return cursor_;
+        }
+
+        std::size_t redo_count() const noexcept {
+            return count_ - cursor_;
+        }
+
+        std::size_t bytes() const noexcept {
+            return bytes_;
+        }
+
+        const history_limits& limits() const noexcept {
+            return limits_;
+        }
+
+        // The entry undo would apply; requires undo_count() != 0.
+        E& undo_entry() noexcept {
+            return *slots_[index(cursor_ - 1)].entry;
+        }
+
+        // The entry redo would apply; requires redo_count() != 0.
+        E& redo_entry() noexcept {
+            return *slots_[index(cursor_)].entry;
+        }
+
+        void step_back() noexcept {
+            --cursor_;
+        }
+
+        void step_forward() noexcept {
+            ++cursor_;
+        }
+
+        void push(E entry, std::size_t entry_bytes) {
+            while (count_ > cursor_) {
+                release(index(--count_));
+            }
+            if (count_ == slots_.size()) {
+                evict_oldest();
+            }
+            auto& target = slots_[index(count_)];
+            target.entry.emplace(std::move(entry));
+            target.bytes = entry_bytes;
+            bytes_ += entry_bytes;
+            cursor_ = ++count_;
+            while (limits_.max_bytes != 0 && bytes_ > limits_.max_bytes && count_ > 1) {
+                evict_oldest();
+            }
+        }
+
+        void clear() noexcept {
+            while (count_ != 0) {
+                release(index(--count_));
+            }
+            head_ = 0;
+            cursor_ = 0;
+        }
+
+    private:
+        struct slot {
+            std::optional<E> entry;
+            std::size_t bytes = 0;
+        };
+
+        std::size_t index(std::size_t position) const noexcept {
+            const auto raw = head_ + position;
+            return raw < slots_.size() ? raw : raw - slots_.size();
+        }
+
+        void release(std::size_t at) noexcept {
+            bytes_ -= slots_[at].bytes;
+            slots_[at].entry.reset();
+            slots_[at].bytes = 0;
+        }
+
+        void evict_oldest() noexcept {
+            release(head_);
+            head_ = index(1);
+            --count_;
+            --cursor_;
+        }
+
+        history_limits limits_;
+        std::vector<slot> slots_;
+        std::size_t head_ = 0;
+        std::size_t count_ = 0;
+        std::size_t cursor_ = 0;
+        std::size_t bytes_ = 0;
+    };
+} // namespace detail
+
+// Delta policy that keeps whole states: each entry holds the state on the other side of one push, and
+// undo/redo swap it with the current state.
+//
+// A delta policy provides delta_type and four members:
+//   delta_type record(T& current, T&& next)       sets current to next, returns what undo needs
+//   void undo(T& current, delta_type& delta)      steps current back across the delta
+//   void redo(T& current, delta_type& delta)      steps current forward again
+//   std::size_t bytes(const delta_type& delta)    charge against history_limits::max_bytes
+// undo and redo may rewrite the delta, as the swap here does.
+template <typename T>
+struct snapshot_delta {
+    using delta_type = T;
+
+    delta_type record(T& current, T&& next) const {
+        return std::exchange(current, std::move(next));
+    }
+
+    void undo(T& current, delta_type& delta) const {
+        using std::swap;
+        swap(current, delta);
+    }
+
+    void redo(T& current, delta_type& delta) const {
+        using std::swap;
+        swap(current, delta);
+    }
+
+    std::size_t bytes(const delta_type& delta) const noexcept {
+        return detail::footprint(delta);
+    }
+};
+
+// Delta policy for contiguous sequences (std::string, std::vector): stores only the span that changed,
+// found by trimming the common prefix and suffix, so a small edit to a large document costs bytes in
+// proportion to the edit.
+template <typename TSequence>
+struct splice_delta {
+    struct delta_type {
+        std::size_t offset = 0;
+        TSequence removed;
+        TSequence inserted;
+    };
+
+    delta_type record(TSequence& current, TSequence&& next) const {
+        const auto shorter = std::min(current.size(), next.size());
+        const auto prefix = common_run(current, next, shorter, false);
+        const auto suffix = common_run(current, next, shorter - prefix, true);
+
+        const auto first = static_cast<std::ptrdiff_t>(prefix);
+        delta_type delta{prefix,
+                         TSequence(std::next(current.begin(), first),
+                                   std::next(current.begin(), static_cast<std::ptrdiff_t>(current.size() - suffix))),
+                         TSequence(std::next(next.begin(), first),
+                                   std::next(next.begin(), static_cast<std::ptrdiff_t>(next.size() - suffix)))};
+        current = std::move(next);
+        return delta;
+    }
+
+    void undo(TSequence& current, delta_type& delta) const {
+        splice(current, delta.offset, delta.inserted.size(), delta.removed);
+    }
+
+    void redo(TSequence& current, delta_type& delta) const {
+        splice(current, delta.offset, delta.removed.size(), delta.inserted);
+    }
+
+    std::size_t bytes(const delta_type& delta) const noexcept {
+        const auto elements = delta.removed.size() + delta.inserted.size();
+        return sizeof(delta_type) + elements * sizeof(typename TSequence::value_type);
+    }
+
+private:
+    // Length of the run of equal elements, at most `limit` long, at the front (or back) of both sequences.
+    // Contiguous trivially-copyable elements are compared a block at a time.
+    static std::size_t common_run(const TSequence& a, const TSequence& b, std::size_t limit, bool from_back) {
+        auto at = [from_back](const TSequence& s, std::size_t i) -> decltype(auto) {
+            return from_back ? s[s.size() - 1 - i] : s[i];
+        };
+        std::size_t run = 0;
+        if constexpr (std::ranges::contiguous_range<TSequence> &&
+                      std::is_trivially_copyable_v<typename TSequence::value_type>) {
+            constexpr std::size_t block = std::max<std::size_t>(1, 256 / sizeof(typename TSequence::value_type));
+            while (run + block <= limit) {
+                const auto* left = from_back ? &at(a, run + block - 1) : &at(a, run);
+                const auto* right = from_back ? &at(b, run + block - 1) : &at(b, run);
+                if (std::memcmp(left, right, block * sizeof(typename TSequence::value_type)) != 0) {
+                    break;
+                }
+                run += block;
+            }
+        }
+        while (run < limit && at(a, run) == at(b, run)) {
+            ++run;
+        }
+        return run;
+    }
+
+    static void splice(TSequence& current, std::size_t offset, std::size_t erase, const TSequence& insert) {
+        const auto at = std::next(current.begin(), static_cast<std::ptrdiff_t>(offset));
+        if (erase == insert.size()) {
+            std::copy(insert.begin(), insert.end(), at);
+            return;
+        }
+        const auto tail = current.erase(at, std::next(at, static_cast<std::ptrdiff_t>(erase)));
+        current.insert(tail, insert.begin(), insert.end());
+    }
+};
+
+// Linear undo/redo history of a value of type T.
+//
+// The stack owns the current state; push(next) makes `next` current and records a delta through TDelta
+// (snapshot_delta by default, or e.g. splice_delta to store only what changed). Deltas live in a ring
+// allocated once at history_limits::max_entries slots, so pushing never reallocates, and undo()/redo()
+// apply one delta each, independent of the history length. Pushing after an undo discards the redo
+// entries. push_if(std::optional<T>) ignores an empty value, so coalesced edits can be fed straight in:
+//
+//     stack.push_if(edits.consume(now));
+template <typename T, typename TDelta = snapshot_delta<T>>
+class undo_stack {
+public:
+    using value_type = T;
+    using delta_policy = TDelta;
+    using delta_type = typename TDelta::delta_type;
+
+    explicit undo_stack(T initial, history_limits limits = {}, TDelta delta = TDelta{})
+        : current_(std::move(initial)), delta_(std::move(delta)), ring_(limits) {
+    }
+
+    const T& current() const noexcept {
+        return current_;
+    }
+
+    void push(T next) {
+        auto delta = delta_.record(current_, std::move(next));
+        const auto delta_bytes = delta_.bytes(delta);
+        ring_.push(std::move(delta), delta_bytes);
+    }
+
+    void push_if(std::optional<T> next) {
+        if (next) {
+            push(std::move(*next));
+        }
+    }
+
+    // Each returns false, changing nothing, when there is no step to take.
+    bool undo() {
+        if (ring_.undo_count() == 0) {
+            return false;
+        }
+        delta_.undo(current_, ring_.undo_entry());
+        ring_.step_back();
+        return true;
+    }
+
+    bool redo() {
+        if (ring_.redo_count() == 0) {
+            return false;
+        }
+        delta_.redo(current_, ring_.redo_entry());
+        ring_.step_forward();
+        return true;
+    }
+
+    bool can_undo() const noexcept {
+        return ring_.undo_count() != 0;
+    }
+
+    bool can_redo() const noexcept {
+        return ring_.redo_count() != 0;
+    }
+
+    std::size_t undo_count() const noexcept {
+        return ring_.undo_count();
+    }
+
+    std::size_t redo_count() const noexcept {
+        return ring_.redo_count();
+    }
+
+    // Bytes charged by the retained deltas, as reported by TDelta::bytes.
+    std::size_t bytes() const noexcept {
+        return ring_.bytes();
+    }
+
+    // Forgets the history and keeps the current state.
+    void clear() noexcept {
+        ring_.clear();
+    }
+
+private:
+    T current_;
+    TDelta delta_;
+    detail::history_ring<delta_type> ring_;
+};
+
+} // namespace basicpp::history
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/result.hpp>
+#include <basicpp/state/dense_state_machine.hpp>
+#include <basicpp/state/state_machine.hpp>
+
+namespace basicpp::state {
+
+// How concurrent_state_machine delivers transition callbacks.
+enum class callback_order {
+    sequenced, // one at a time, in the order the transitions took effect
+    unordered, // on the dispatching thread right after its transition; may overlap and reorder
+};
+
+// Dense state machine that any number of threads may dispatch to without a lock.
+//
+// The current state and a transition sequence number share one atomic word; dispatch reads it, looks the
+// event up in the immutable table and installs the successor with a CAS, retrying if another thread moved
+// first. Every accepted event is applied exactly once, and each dispatch takes effect atomically at its
+// successful CAS (or, when rejected, at the load that saw no transition), so the machine is linearizable.
+//
+// With callback_order::sequenced, callbacks run one at a time in sequence order, each seeing the transition
+// that followed the previous one. Dispatchers publish their transition to a ring and whichever thread holds
+// the delivery flag runs every callback that is ready, so a callback may run on another dispatching thread
+// and after its own dispatch has returned; nobody waits for a preempted predecessor. A dispatcher only waits
+// when `delivery_capacity` callbacks are pending. If a callback throws, the exception leaves the dispatch
+// that was delivering it and the remaining callbacks are delivered by the next dispatch.
+// With callback_order::unordered each dispatcher runs its callback immediately, concurrently with others.
+// Configure the callback before sharing the machine.
+template <dense_id TStateId, dense_id TEvent, std::size_t NStates, std::size_t NEvents,
+          typename TPolicy = state_machine_policy<>>
+class concurrent_state_machine {
+public:
+    using state_id = TStateId;
+    using event_type = TEvent;
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using table_type = dense_transition_table<TStateId, TEvent, NStates, NEvents>;
+    using dispatch_result = core::result<state_id, error_type>;
+    using transition_callback =
+        typename TPolicy::template function_type<void(const state_id&, const state_id&, const event_type&)>;
+
+    static constexpr std::uint32_t delivery_capacity = 1024;
+
+    concurrent_state_machine(state_id initial, const table_type& table)
+        : table_(table), word_(pack(0, checked_cell(initial))) {
+    }
+
+    concurrent_state_machine(const concurrent_state_machine&) = delete;
+    concurrent_state_machine& operator=(const concurrent_state_machine&) = delete;
+
+    // Not thread-safe: set before other threads start dispatching.
+    void on_transition(transition_callback callback, callback_order order = callback_order::sequenced) {
+        transition_callback_ = std::move(callback);
+        order_ = order;
+        if (order == callback_order::sequenced && !pending_) {
+            pending_ = std::make_unique<pending_transition[]>(delivery_capacity);
+        }
+        // Sequenced delivery resumes from the transitions already applied.
+        delivered_.store(sequence(), std::memory_order_release);
+    }
+
+    state_id current_state() const noexcept {
+        return table_type::to_state(cell_of(word_.load(std::memory_order_acquire)));
+    }
+
+    // Number of transitions applied so far (wraps at 2^32).
+    std::uint32_t sequence() const noexcept {
+        return sequence_of(word_.load(std::memory_order_acquire));
+    }
+
+    const table_type& table() const noexcept {
+        return table_;
+    }
+
+    dispatch_result dispatch(const event_type& event) {
+        auto word = word_.load(std::memory_order_acquire);
+        std::uint64_t desired;
+        cell_type next;
+        do {
+            next = table_.next(cell_of(word), event);
+            if (next == table_type::no_transition) {
+                return dispatch_result::err(
+                    core::error_factory<error_type>::make(core::errc::transition_not_found, "transition not found"));
+            }
+            desired = pack(sequence_of(word) + 1, next);
+        } while (!word_.compare_exchange_weak(word, desired, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        if (transition_callback_) {
+            if (order_ == callback_order::sequenced) {
+                publish(sequence_of(desired), cell_of(word), next, event);
+                deliver_pending();
+            } else {
+                transition_callback_(table_type::to_state(cell_of(word)), table_type::to_state(next), event);
+            }
+        }
+        return dispatch_result::ok(table_type::to_state(next));
+    }
+
+private:
+    using cell_type = typename table_type::cell_type;
+
+    // A transition waiting for its callback; `published` holds its sequence number once the fields are set.
+    struct pending_transition {
+        std::atomic<std::uint32_t> published{0};
+        cell_type from{};
+        cell_type to{};
+        event_type event{};
+    };
+
+    static constexpr std::uint32_t delivery_mask = delivery_capacity - 1;
+    static_assert((delivery_capacity & delivery_mask) == 0, "delivery_capacity must be a power of two");
+
+    static constexpr std::uint64_t pack(std::uint32_t sequence, cell_type cell) noexcept {
+        return (static_cast<std::uint64_t>(sequence) << 32) | cell;
+    }
+
+    static constexpr cell_type cell_of(std::uint64_t word) noexcept {
+        return static_cast<cell_type>(word & 0xFFFFFFFFu);
+    }
+
+    static constexpr std::uint32_t sequence_of(std::uint64_t word) noexcept {
+        return static_cast<std::uint32_t>(word >> 32);
+    }
+
+    static cell_type checked_cell(state_id id) {
+        const auto cell = table_type::to_cell(id);
+        if (cell == table_type::no_transition) {
+            throw std::out_of_range("concurrent_state_machine: initial state out of range");
+        }
+        return cell;
+    }
+
+    void publish(std::uint32_t sequence, cell_type from, cell_type to, const event_type& event) {
+        // The slot is reused `delivery_capacity` transitions later; wait until its previous callback has run.
+        while (sequence - delivered_.load(std::memory_order_acquire) > delivery_capacity) {
+            deliver_pending();
+            std::this_thread::yield();
+        }
+        auto& slot = pending_[sequence & delivery_mask];
+        slot.from = from;
+        slot.to = to;
+        slot.event = event;
+        slot.published.store(sequence, std::memory_order_seq_cst);
+    }
+
+    // Runs ready callbacks in sequence order while holding the delivery flag. After dropping the flag the
+    // next slot is checked again: a transition published meanwhile may have seen the flag still held.
+    void deliver_pending() {
+        while (!delivering_.exchange(true, std::memory_order_seq_cst)) {
+            auto next = delivered_.load(std::memory_order_relaxed) + 1;
+            {
+                struct release_flag {
+                    std::atomic<bool>& delivering;
+                    ~release_flag() {
+                        delivering.store(false, std::memory_order_seq_cst);
+                    }
+                } flag{delivering_};
+
+                for (;;) {
+                    auto& slot = pending_[next & delivery_mask];
+                    if (slot.published.load(std::memory_order_acquire) != next) {
+                        break;
+                    }
+                    const auto from = table_type::to_state(slot.from);
+                    const auto to = table_type::to_state(slot.to);
+                    const auto event = slot.event;
+                    delivered_.store(next, std::memory_order_release);
+                    ++next;
+                    transition_callback_(from, to, event);
+                }
+            }
+            if (pending_[next & delivery_mask].published.load(std::memory_order_seq_cst) != next) {
+                return;
+            }
+        }
+    }
+
+    const table_type table_;
+    alignas(64) std::atomic<std::uint64_t> word_;
+    alignas(64) std::atomic<std::uint32_t> delivered_{0};
+    std::atomic<bool> delivering_{false};
+    std::unique_ptr<pending_transition[]> pending_;
+    transition_callback transition_callback_;
+    callback_order order_ = callback_order::sequenced;
+};
+
+} // namespace basicpp::state
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/result.hpp>
+#include <basicpp/state/observer_list.hpp>
+#include <basicpp/state/state_machine.hpp>
+
+namespace basicpp::state {
+
+// State and event ids usable as dense table indices: integers or enums numbered from 0.
+template <typename T>
+concept dense_id = std::integral<T> || std::is_enum_v<T>;
+
+namespace detail {
+    // Smallest unsigned type that can hold 0..N (N itself is the "no transition" sentinel).
+    template <std::size_t N>
+    using dense_index_t =
+        std::conditional_t<(N < std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+                           std::conditional_t<(N < std::numeric_limits<std::uint16_t>::max()), std::uint16_t,
+                                              std::uint32_t>>;
+
+    template <dense_id T>
+    constexpr std::size_t dense_index(T id) noexcept {
+        if constexpr (std::is_enum_v<T>) {
+            return static_cast<std::size_t>(static_cast<std::underlying_type_t<T>>(id));
+        } else {
+            return static_cast<std::size_t>(id);
+        }
+    }
+} // namespace detail
+
+// NStates x NEvents transition table stored row-major in one array of the smallest index type that fits.
+// Lookups are a single indexed load; cells without a transition hold `no_transition`.
+// Usable in constant expressions, so a table can be built once at compile time and shared.
+template <dense_id TStateId, dense_id TEvent, std::size_t NStates, std::size_t NEvents>
+class dense_transition_table {
+public:
+    using state_id = TStateId;
+    using event_type = TEvent;
+    using cell_type = detail::dense_index_t<NStates>;
+
+    static constexpr std::size_t state_count = NStates;
+    static constexpr std::size_t event_count = NEvents;
+    static constexpr cell_type no_transition = static_cast<cell_type>(NStates);
+
+    constexpr dense_transition_table() noexcept {
+        cells_.fill(no_transition);
+    }
+
+    // Returns true when the (from, event) cell was empty. Throws std::out_of_range for ids outside the table.
+    constexpr bool add_transition(state_id from, event_type event, state_id to) {
+        const auto target = detail::dense_index(to);
+        if (detail::dense_index(from) >= NStates || target >= NStates || detail::dense_index(event) >= NEvents) {
+            throw std::out_of_range("dense_transition_table: id out of range");
+        }
+        auto& cell = cells_[detail::dense_index(from) * NEvents + detail::dense_index(event)];
+        const bool inserted = cell == no_transition;
+        cell = static_cast<cell_type>(target);
+        return inserted;
+    }
+
+    constexpr void remove_transition(state_id from, event_type event) {
+        if (detail::dense_index(from) < NStates && detail::dense_index(event) < NEvents) {
+            cells_[detail::dense_index(from) * NEvents + detail::dense_index(event)] = no_transition;
+        }
+    }
+
+    // Index of the target state, or no_transition (also for out-of-range ids).
+    constexpr cell_type next(cell_type from, event_type event) const noexcept {
+        const auto column = detail::dense_index(event);
+        if (from >= NStates || column >= NEvents) {
+            return no_transition;
+        }
+        return cells_[static_cast<std::size_t>(from) * NEvents + column];
+    }
+
+    constexpr bool contains(state_id from, event_type event) const noexcept {
+        return next(to_cell(from), event) != no_transition;
+    }
+
+    static constexpr cell_type to_cell(state_id id) noexcept {
+        const auto index = detail::dense_index(id);
+        return index < NStates ? static_cast<cell_type>(index) : no_transition;
+    }
+
+    static constexpr state_id to_state(cell_type cell) noexcept {
+        return static_cast<state_id>(cell);
+    }
+
+private:
+    std::array<cell_type, NStates * NEvents> cells_{};
+};
+
+// state_machine for small integral or enum ids: same interface, error reporting and callbacks, but
+// transitions live in a dense_transition_table, so dispatch is one bounds check and one indexed load with
+// no hashing, allocation or state copies. The current state is held as a table index.
+template <dense_id TStateId, dense_id TEvent, std::size_t NStates, std::size_t NEvents,
+          typename TPolicy = state_machine_policy<>>
+class dense_state_machine {
+public:
+    using state_id = TStateId;
+    using event_type = TEvent;
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using table_type = dense_transition_table<TStateId, TEvent, NStates, NEvents>;
+    using dispatch_result = core::result<state_id, error_type>;
+    using transition_callback =
+        typename TPolicy::template function_type<void(const state_id&, const state_id&, const event_type&)>;
+    using observer_list_type = observer_list<void(const state_id&, const state_id&, const event_type&)>;
+
+    explicit dense_state_machine(state_id initial)
+        : current_(checked_cell(initial)) {
+    }
+
+    // Starts from a prebuilt (possibly constexpr) table.
+    dense_state_machine(state_id initial, const table_type& table)
+        : table_(table), current_(checked_cell(initial)) {
+    }
+
+    bool add_transition(state_id from, event_type event, state_id to) {
+        return table_.add_transition(from, event, to);
+    }
+
+    void on_transition(transition_callback callback) {
+        transition_callback_ = std::move(callback);
+    }
+
+    // Additional non-owning observers (e.g. a transition_trace), notified after the callback; see observer_list.
+    // Returns false when observer_list_type::capacity observers are already attached.
+    template <typename F>
+    bool add_observer(F& observer) noexcept {
+        return observers_.add(observer);
+    }
+
+    template <typename F>
+    bool remove_observer(const F& observer) noexcept {
+        return observers_.remove(observer);
+    }
+
+    state_id current_state() const noexcept {
+        return table_type::to_state(current_);
+    }
+
+    const table_type& table() const noexcept {
+        return table_;
+    }
+
+    dispatch_result dispatch(const event_type& event) {
+        const auto next = table_.next(current_, event);
+        if (next == table_type::no_transition) {
+            return dispatch_result::err(
+                core::error_factory<error_type>::make(core::errc::transition_not_found, "transition not found"));
+        }
+
+        const auto previous = current_;
+        current_ = next;
+
+        if (transition_callback_) {
+            transition_callback_(table_type::to_state(previous), table_type::to_state(current_), event);
+        }
+        if (!observers_.empty()) {
+            observers_(table_type::to_state(previous), table_type::to_state(current_), event);
+        }
+
+        return dispatch_result::ok(table_type::to_state(current_));
+    }
+
+private:
+    static typename table_type::cell_type checked_cell(state_id id) {
+        const auto cell = table_type::to_cell(id);
+        if (cell == table_type::no_transition) {
+            throw std::out_of_range("dense_state_machine: initial state out of range");
+        }
+        return cell;
+    }
+
+    table_type table_;
+    typename table_type::cell_type current_;
+    transition_callback transition_callback_;
+    observer_list_type observers_;
+};
+
+} // namespace basicpp::state
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace basicpp::state {
+
+template <typename Sig, std::size_t N = 4>
+class observer_list;
+
+// Up to N non-owning observers called in the order they were added. Each entry is two pointers, so adding
+// one never allocates and notifying is one indirect call per observer. Observers are held by reference:
+// only lvalues can be added, and each must outlive the list or be removed first.
+template <typename... Args, std::size_t N>
+class observer_list<void(Args...), N> {
+public:
+    static constexpr std::size_t capacity = N;
+
+    // Returns false when the list is full.
+    template <typename F>
+        requires std::is_invocable_v<F&, Args...>
+    bool add(F& observer) noexcept {
+        if (size_ == N) {
+            return false;
+        }
+        entries_[size_++] = entry{const_cast<void*>(static_cast<const void*>(std::addressof(observer))),
+                                  &call<std::remove_const_t<F>>};
+        return true;
+    }
+
+    template <typename F>
+        requires(!std::is_lvalue_reference_v<F>)
+    bool add(F&& observer) = delete;
+
+    // Removes the first entry referring to `observer`; returns false when it was not added.
+    template <typename F>
+    bool remove(const F& observer) noexcept {
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (entries_[i].object == static_cast<const void*>(std::addressof(observer))) {
+                for (std::size_t j = i + 1; j < size_; ++j) {
+                    entries_[j - 1] = entries_[j];
+                }
+                --size_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() noexcept {
+        size_ = 0;
+    }
+
+    std::size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Kept out of line so the empty check is all an inlined dispatch carries.
+#if defined(__GNUC__) || defined(__clang__)
+    [[gnu::noinline]]
+#endif
+    void operator()(Args... args) const {
+        for (std::size_t i = 0; i < size_; ++i) {
+            entries_[i].invoke(entries_[i].object, args...);
+        }
+    }
+
+private:
+    struct entry {
+        void* object = nullptr;
+        void (*invoke)(void*, Args...) = nullptr;
+    };
+
+    template <typename F>
+    static void call(void* object, Args... args) {
+        (*static_cast<F*>(object))(args...);
+    }
+
+    std::array<entry, N> entries_{};
+    std::size_t size_ = 0;
+};
+
+} // namespace basicpp::state
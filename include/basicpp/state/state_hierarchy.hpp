@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+#include <basicpp/state/dense_state_machine.hpp>
+
+namespace basicpp::state {
+
+// Describes a hierarchical machine over dense ids and flattens it into a dense_transition_table.
+//
+// A state may have one parent. A transition declared on a parent applies to every descendant that has no
+// transition for that event of its own (the nearest ancestor wins), and a transition whose target is a
+// composite state enters that state's first child, recursively. build() resolves all of this ahead of time,
+// so a dense_state_machine over the result dispatches with a single lookup at any nesting depth:
+//
+//     constexpr auto table = [] {
+//         state_hierarchy<conn, conn_event, 4, 3> hierarchy;
+//         hierarchy.set_parent(conn::idle, conn::online);
+//         hierarchy.set_parent(conn::busy, conn::online);
+//         hierarchy.add_transition(conn::online, conn_event::drop, conn::offline);
+//         return hierarchy.build();
+//     }();
+template <dense_id TStateId, dense_id TEvent, std::size_t NStates, std::size_t NEvents>
+class state_hierarchy {
+public:
+    using state_id = TStateId;
+    using event_type = TEvent;
+    using table_type = dense_transition_table<TStateId, TEvent, NStates, NEvents>;
+    using cell_type = typename table_type::cell_type;
+
+    static constexpr cell_type no_state = table_type::no_transition;
+
+    constexpr state_hierarchy() noexcept {
+        parents_.fill(no_state);
+        first_children_.fill(no_state);
+    }
+
+    // Makes `child` a substate of `parent`; the first child added to a parent is its initial substate.
+    // Throws std::out_of_range for ids outside the table and std::invalid_argument when `child` already has a
+    // parent or the edge would make `child` its own ancestor.
+    constexpr void set_parent(state_id child, state_id parent) {
+        const auto child_cell = checked_cell(child);
+        const auto parent_cell = checked_cell(parent);
+        if (parents_[child_cell] != no_state) {
+            throw std::invalid_argument("state_hierarchy: state already has a parent");
+        }
+        for (auto ancestor = parent_cell; ancestor != no_state; ancestor = parents_[ancestor]) {
+            if (ancestor == child_cell) {
+                throw std::invalid_argument("state_hierarchy: cycle in state hierarchy");
+            }
+        }
+        parents_[child_cell] = parent_cell;
+        if (first_children_[parent_cell] == no_state) {
+            first_children_[parent_cell] = child_cell;
+        }
+    }
+
+    // Same contract as dense_transition_table::add_transition; `from` and `to` may be composite states.
+    constexpr bool add_transition(state_id from, event_type event, state_id to) {
+        return local_.add_transition(from, event, to);
+    }
+
+    constexpr cell_type parent(state_id state) const noexcept {
+        const auto cell = table_type::to_cell(state);
+        return cell == no_state ? no_state : parents_[cell];
+    }
+
+    // The leaf a transition to `state` ends in: `state` itself, or its initial substate, recursively.
+    constexpr state_id resolve(state_id state) const noexcept {
+        auto cell = table_type::to_cell(state);
+        if (cell == no_state) {
+            return state;
+        }
+        while (first_children_[cell] != no_state) {
+            cell = first_children_[cell];
+        }
+        return table_type::to_state(cell);
+    }
+
+    // One row per state with inherited transitions copied in and composite targets resolved to leaves.
+    constexpr table_type build() const {
+        table_type flat;
+        for (std::size_t state = 0; state < NStates; ++state) {
+            for (std::size_t event = 0; event < NEvents; ++event) {
+                const auto id = static_cast<event_type>(event);
+                for (auto source = static_cast<cell_type>(state); source != no_state; source = parents_[source]) {
+                    const auto target = local_.next(source, id);
+                    if (target != no_state) {
+                        flat.add_transition(table_type::to_state(static_cast<cell_type>(state)), id,
+                                            resolve(table_type::to_state(target)));
+                        break;
+                    }
+                }
+            }
+        }
+        return flat;
+    }
+
+private:
+    static constexpr cell_type checked_cell(state_id id) {
+        const auto cell = table_type::to_cell(id);
+        if (cell == no_state) {
+            throw std::out_of_range("state_hierarchy: state out of range");
+        }
+        return cell;
+    }
+
+    table_type local_;
+    std::array<cell_type, NStates> parents_{};
+    std::array<cell_type, NStates> first_children_{};
+};
+
+} // namespace basicpp::state
@@ -6,7 +6,10 @@
 #include <unordered_map>
 #include <utility>
 
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/inplace_function.hpp>
 #include <basicpp/core/result.hpp>
+#include <basicpp/state/observer_list.hpp>
 
 namespace basicpp::state {
 
@@ -36,13 +39,37 @@ namespace detail {
     };
 } // namespace detail
 
+// Selects the error type returned by state_machine::dispatch (see core::error_factory) and the
+// wrapper used to store the transition callback.
+template <typename E = std::string>
+struct state_machine_policy {
+    using error_type = E;
+
+    template <typename Sig>
+    using function_type = std::function<Sig>;
+};
+
+// Allocation-free variant: core::error failures and a core::inplace_function callback.
+template <typename E = core::error, std::size_t Capacity = 32>
+struct inplace_state_machine_policy {
+    using error_type = E;
+
+    template <typename Sig>
+    using function_type = core::inplace_function<Sig, Capacity>;
+};
+
 // Deterministic finite state machine with explicit transitions and optional callbacks.
-template <typename TStateId, typename TEvent>
+template <typename TStateId, typename TEvent, typename TPolicy = state_machine_policy<>>
 class state_machine {
 public:
     using state_id = TStateId;
     using event_type = TEvent;
-    using transition_callback = std::function<void(const state_id&, const state_id&, const event_type&)>;
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using dispatch_result = core::result<state_id, error_type>;
+    using transition_callback =
+        typename TPolicy::template function_type<void(const state_id&, const state_id&, const event_type&)>;
+    using observer_list_type = observer_list<void(const state_id&, const state_id&, const event_type&)>;
 
     explicit state_machine(state_id initial)
         : current_(std::move(initial)) {
@@ -61,15 +88,28 @@ public:
         transition_callback_ = std::move(callback);
     }
 
+    // Additional non-owning observers (e.g. a transition_trace), notified after the callback; see observer_list.
+    // Returns false when observer_list_type::capacity observers are already attached.
+    template <typename F>
+    bool add_observer(F& observer) noexcept {
+        return observers_.add(observer);
+    }
+
+    template <typename F>
+    bool remove_observer(const F& observer) noexcept {
+        return observers_.remove(observer);
+    }
+
     const state_id& current_state() const noexcept {
         return current_;
     }
 
-    core::result<state_id, std::string> dispatch(const event_type& event) {
+    dispatch_result dispatch(const event_type& event) {
         detail::transition_key<state_id, event_type> key{current_, event};
         auto it = transitions_.find(key);
         if (it == transitions_.end()) {
-            return core::result<state_id, std::string>::err("transition not found");
+            return dispatch_result::err(
+                core::error_factory<error_type>::make(core::errc::transition_not_found, "transition not found"));
         }
 
         state_id previous = current_;
@@ -78,8 +118,11 @@ public:
         if (transition_callback_) {
             transition_callback_(previous, current_, event);
         }
+        if (!observers_.empty()) {
+            observers_(previous, current_, event);
+        }
 
-        return core::result<state_id, std::string>::ok(current_);
+        return dispatch_result::ok(current_);
     }
 
 private:
@@ -91,6 +134,7 @@ private:
     map_type transitions_;
     state_id current_;
     transition_callback transition_callback_;
+    observer_list_type observers_;
 };
 
 } // namespace basicpp::state
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <basicpp/core/error.hpp>
+#include <basicpp/core/result.hpp>
+#include <basicpp/state/dense_state_machine.hpp>
+#include <basicpp/state/state_machine.hpp>
+
+namespace basicpp::state {
+
+// Execution policy for state_machine_pool::dispatch_all: splits instances over `threads` threads
+// (0 = hardware concurrency), keeping at least `min_chunk` instances per thread.
+struct parallel_dispatch {
+    unsigned threads = 0;
+    std::size_t min_chunk = 16384;
+};
+
+// Many instances of one dense state machine: the transition table is stored once per pool and each
+// instance is only its current state, one cell_type (a byte for fewer than 255 states) in a flat array.
+//
+// Batch dispatch runs a branchless kernel over a padded copy of the table: missing transitions map a state
+// to itself and out-of-range events to an extra all-missing column. Each cell packs the next state with an
+// "accepted" bit in one 32-bit word, so an instance costs a single table load and the loop vectorises
+// (as 32-bit gathers where the target has them).
+// Pools do not run transition callbacks.
+template <dense_id TStateId, dense_id TEvent, std::size_t NStates, std::size_t NEvents,
+          typename TPolicy = state_machine_policy<>>
+class state_machine_pool {
+public:
+    using state_id = TStateId;
+    using event_type = TEvent;
+    using policy_type = TPolicy;
+    using error_type = typename TPolicy::error_type;
+    using table_type = dense_transition_table<TStateId, TEvent, NStates, NEvents>;
+    using cell_type = typename table_type::cell_type;
+    using instance_id = std::uint32_t;
+    using dispatch_result = core::result<state_id, error_type>;
+
+    explicit state_machine_pool(const table_type& table)
+        : packed_(NStates * stride) {
+        for (std::size_t from = 0; from < NStates; ++from) {
+            const auto cell = static_cast<cell_type>(from);
+            for (std::size_t event = 0; event <= NEvents; ++event) {
+                const auto next =
+                    event < NEvents ? table.next(cell, static_cast<event_type>(event)) : table_type::no_transition;
+                const auto index = from * stride + event;
+                packed_[index] = next == table_type::no_transition ? cell : (next | accepted_bit);
+            }
+        }
+    }
+
+    state_machine_pool(const table_type& table, std::size_t count, state_id initial)
+        : state_machine_pool(table) {
+        states_.assign(count, checked_cell(initial));
+    }
+
+    instance_id add(state_id initial) {
+        states_.push_back(checked_cell(initial));
+        return static_cast<instance_id>(states_.size() - 1);
+    }
+
+    void reserve(std::size_t count) {
+        states_.reserve(count);
+    }
+
+    std::size_t size() const noexcept {
+        return states_.size();
+    }
+
+    state_id current_state(instance_id id) const noexcept {
+        return table_type::to_state(states_[id]);
+    }
+
+    void set_state(instance_id id, state_id state) {
+        states_[id] = checked_cell(state);
+    }
+
+    // Raw per-instance state indices, e.g. for serialising or histogramming a whole population.
+    std::span<const cell_type> states() const noexcept {
+        return states_;
+    }
+
+    dispatch_result dispatch(instance_id id, const event_type& event) {
+        const auto cell = packed_[slot(states_[id], event)];
+        if (!(cell & accepted_bit)) {
+            return dispatch_result::err(
+                core::error_factory<error_type>::make(core::errc::transition_not_found, "transition not found"));
+        }
+        states_[id] = static_cast<cell_type>(cell);
+        return dispatch_result::ok(table_type::to_state(states_[id]));
+    }
+
+    // Applies events[i] to instance i; instances without a matching transition keep their state.
+    // Returns the number of instances that transitioned. Throws std::invalid_argument on a size mismatch.
+    std::size_t dispatch_all(std::span<const event_type> events) {
+        if (events.size() != states_.size()) {
+            throw std::invalid_argument("state_machine_pool::dispatch_all: one event per instance expected");
+        }
+        return run_range(events.data(), 0, states_.size());
+    }
+
+    // Same as dispatch_all(events), with the instances split over threads.
+    std::size_t dispatch_all(std::span<const event_type> events, parallel_dispatch policy) {
+        if (events.size() != states_.size()) {
+            throw std::invalid_argument("state_machine_pool::dispatch_all: one event per instance expected");
+        }
+
+        std::size_t threads = policy.threads != 0 ? policy.threads : std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, std::max<std::size_t>(1, states_.size() / std::max<std::size_t>(1, policy.min_chunk)));
+        if (threads <= 1) {
+            return run_range(events.data(), 0, states_.size());
+        }
+
+        const auto chunk = (states_.size() + threads - 1) / threads;
+        std::vector<std::size_t> counts(threads, 0);
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (std::size_t t = 1; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                counts[t] = run_range(events.data(), std::min(states_.size(), t * chunk),
+                                      std::min(states_.size(), (t + 1) * chunk));
+            });
+        }
+        counts[0] = run_range(events.data(), 0, std::min(states_.size(), chunk));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        std::size_t total = 0;
+        for (const auto count : counts) {
+            total += count;
+        }
+        return total;
+    }
+
+    // Applies events[i] to instance ids[i], in order (an id may repeat). Returns the number of transitions.
+    std::size_t dispatch(std::span<const instance_id> ids, std::span<const event_type> events) {
+        if (ids.size() != events.size()) {
+            throw std::invalid_argument("state_machine_pool::dispatch: ids and events differ in size");
+        }
+        std::size_t accepted = 0;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            const auto cell = packed_[slot(states_[ids[i]], events[i])];
+            states_[ids[i]] = static_cast<cell_type>(cell);
+            accepted += cell >> accepted_shift;
+        }
+        return accepted;
+    }
+
+private:
+    // One extra column catches out-of-range events.
+    static constexpr std::size_t stride = NEvents + 1;
+    static constexpr unsigned accepted_shift = 31;
+    static constexpr std::uint32_t accepted_bit = std::uint32_t{1} << accepted_shift;
+    static_assert(NStates * (NEvents + 1) <= 0xFFFFFFFFu, "state_machine_pool: table too large");
+
+    static cell_type checked_cell(state_id id) {
+        const auto cell = table_type::to_cell(id);
+        if (cell == table_type::no_transition) {
+            throw std::out_of_range("state_machine_pool: state out of range");
+        }
+        return cell;
+    }
+
+    // 32-bit index arithmetic keeps the batch loop eligible for 32-bit gathers.
+    static std::uint32_t slot(cell_type state, const event_type& event) noexcept {
+        const auto column = static_cast<std::uint32_t>(std::min(detail::dense_index(event), NEvents));
+        return static_cast<std::uint32_t>(state) * static_cast<std::uint32_t>(stride) + column;
+    }
+
+    std::size_t run_range(const event_type* events, std::size_t begin, std::size_t end) noexcept {
+        return run_kernel(states_.data() + begin, events + begin, packed_.data(), end - begin);
+    }
+
+    // The state array, the events and the table never overlap; saying so lets the loop vectorise.
+    static std::size_t run_kernel(cell_type* __restrict states, const event_type* __restrict events,
+                                  const std::uint32_t* __restrict packed, std::size_t count) noexcept {
+        std::size_t accepted = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto cell = packed[slot(states[i], events[i])];
+            states[i] = static_cast<cell_type>(cell);
+            accepted += cell >> accepted_shift;
+        }
+        return accepted;
+    }
+
+    std::vector<std::uint32_t> packed_;
+    std::vector<cell_type> states_;
+};
+
+} // namespace basicpp::state
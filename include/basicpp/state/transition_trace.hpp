@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+#include <basicpp/state/dense_state_machine.hpp>
+
+namespace basicpp::state {
+
+// Tick source for transition_trace that avoids a clock syscall: the CPU timestamp counter on x86, otherwise
+// steady_clock. Ticks are monotonic on one core but are not calibrated to wall time.
+struct cycle_clock {
+    static std::uint64_t ticks() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+};
+
+namespace detail {
+    template <typename TClock>
+    std::uint64_t trace_ticks() noexcept {
+        if constexpr (requires { TClock::ticks(); }) {
+            return TClock::ticks();
+        } else {
+            return static_cast<std::uint64_t>(TClock::now().time_since_epoch().count());
+        }
+    }
+
+    template <dense_id T>
+    using trace_id_underlying_t =
+        typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+
+    // Unsigned type as wide as the wider of the state and event id types, so no id is ever truncated.
+    template <dense_id TStateId, dense_id TEvent>
+    using trace_index_t = std::make_unsigned_t<std::conditional_t<
+        (sizeof(trace_id_underlying_t<TStateId>) >= sizeof(trace_id_underlying_t<TEvent>)),
+        trace_id_underlying_t<TStateId>, trace_id_underlying_t<TEvent>>>;
+} // namespace detail
+
+// Fixed-size ring of the last Capacity transitions of a dense machine, recorded as compact ids with a clock
+// tick. Add it as an observer (machine.add_observer(trace)) or call record() directly; recording is a tick
+// read and one small store, and the oldest entries are overwritten once the ring is full.
+//
+// A trace has a single writer: use one per machine, or a thread_local one per thread. Read it (for_each,
+// copy_to, dump) from the writing thread or once writing has stopped, e.g. from a terminate handler.
+// Ids are stored as TIndex, by default an unsigned type as wide as the wider id type (an entry over 8- or
+// 16-bit enums is 16 bytes). A TIndex narrower than the ids does not compile, so ids are never truncated.
+template <dense_id TStateId, dense_id TEvent, std::size_t Capacity = 1024, typename TClock = std::chrono::steady_clock,
+          typename TIndex = detail::trace_index_t<TStateId, TEvent>>
+class transition_trace {
+public:
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "transition_trace: capacity must be a power of two");
+    static_assert(std::is_unsigned_v<TIndex> && sizeof(TIndex) >= sizeof(detail::trace_id_underlying_t<TStateId>) &&
+                      sizeof(TIndex) >= sizeof(detail::trace_id_underlying_t<TEvent>),
+                  "transition_trace: TIndex must be unsigned and hold every state and event id");
+
+    using state_id = TStateId;
+    using event_type = TEvent;
+    using clock_type = TClock;
+    using index_type = TIndex;
+
+    struct entry {
+        std::uint64_t ticks;
+        index_type from;
+        index_type to;
+        index_type event;
+    };
+
+    static constexpr std::size_t capacity = Capacity;
+
+    void record(const state_id& from, const state_id& to, const event_type& event) noexcept {
+        const auto head = head_.load(std::memory_order_relaxed);
+        entries_[head & (Capacity - 1)] =
+            entry{detail::trace_ticks<clock_type>(), static_cast<index_type>(detail::dense_index(from)),
+                  static_cast<index_type>(detail::dense_index(to)), static_cast<index_type>(detail::dense_index(event))};
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Observer signature, so a trace can be passed to add_observer directly.
+    void operator()(const state_id& from, const state_id& to, const event_type& event) noexcept {
+        record(from, to, event);
+    }
+
+    // Transitions recorded since construction or clear(), including overwritten ones.
+    std::uint64_t recorded() const noexcept {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    std::size_t size() const noexcept {
+        const auto head = recorded();
+        return head < Capacity ? static_cast<std::size_t>(head) : Capacity;
+    }
+
+    void clear() noexcept {
+        head_.store(0, std::memory_order_release);
+    }
+
+    // Visits the retained entries oldest first as fn(sequence, entry), sequence counting from 0.
+    template <typename F>
+    void for_each(F&& fn) const {
+        const auto head = recorded();
+        for (auto sequence = head - size(); sequence < head; ++sequence) {
+            fn(sequence, entries_[sequence & (Capacity - 1)]);
+        }
+    }
+
+    // Copies the newest min(out.size(), size()) entries, oldest first; returns how many were copied.
+    std::size_t copy_to(std::span<entry> out) const noexcept {
+        const auto head = recorded();
+        const auto count = out.size() < size() ? out.size() : size();
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = entries_[(head - count + i) & (Capacity - 1)];
+        }
+        return count;
+    }
+
+    // Writes one line per entry, "#<sequence> +<ticks since the oldest entry> <from> -> <to> on <event>",
+    // to sink(std::string_view). Lines are formatted in a stack buffer large enough for any entry; nothing is
+    // allocated.
+    template <typename Sink>
+    void dump(Sink&& sink) const {
+        bool first = true;
+        std::uint64_t origin = 0;
+        for_each([&](std::uint64_t sequence, const entry& e) {
+            if (first) {
+                origin = e.ticks;
+                first = false;
+            }
+            char line[160];
+            char* out = line;
+            char* const end = line + sizeof(line);
+            auto put = [&](std::string_view text) {
+                const auto count = std::min(text.size(), static_cast<std::size_t>(end - out));
+                out = std::copy_n(text.data(), count, out);
+            };
+            auto put_number = [&](std::uint64_t value) {
+                const auto [ptr, ec] = std::to_chars(out, end, value);
+                if (ec == std::errc{}) {
+                    out = ptr;
+                }
+            };
+            put("#");
+            put_number(sequence);
+            put(" +");
+            put_number(e.ticks - origin);
+            put(" ");
+            put_number(e.from);
+            put(" -> ");
+            put_number(e.to);
+            put(" on ");
+            put_number(e.event);
+            put("\n");
+            sink(std::string_view(line, static_cast<std::size_t>(out - line)));
+        });
+    }
+
+    void dump(std::FILE* file) const noexcept {
+        dump([file](std::string_view line) { std::fwrite(line.data(), 1, line.size(), file); });
+        std::fflush(file);
+    }
+
+private:
+    std::array<entry, Capacity> entries_{};
+    std::atomic<std::uint64_t> head_{0};
+};
+
+} // namespace basicpp::state
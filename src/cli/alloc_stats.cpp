@@ -0,0 +1,178 @@
+#include "alloc_stats.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace basicpp::cli {
+
+namespace {
+
+std::atomic<std::uint64_t> allocation_count{0};
+std::atomic<std::uint64_t> allocated_bytes{0};
+std::atomic<std::uint64_t> live_bytes{0};
+std::atomic<std::uint64_t> peak_live_bytes{0};
+
+#if defined(BASICPP_ALLOC_STATS)
+
+// Every block carries its size in a header so deallocation can keep live/peak counts exact
+// without relying on sized delete being called.
+constexpr std::size_t header_size = alignof(std::max_align_t) > sizeof(std::size_t)
+                                        ? alignof(std::max_align_t)
+                                        : sizeof(std::size_t);
+
+void record_allocation(std::size_t size) noexcept {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    const auto live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void* counted_allocate(std::size_t size) noexcept {
+    auto* block = static_cast<unsigned char*>(std::malloc(size + header_size));
+    if (!block) {
+        return nullptr;
+    }
+    *reinterpret_cast<std::size_t*>(block) = size;
+    record_allocation(size);
+    return block + header_size;
+}
+
+void counted_deallocate(void* ptr) noexcept {
+    if (!ptr) {
+        return;
+    }
+    auto* block = static_cast<unsigned char*>(ptr) - header_size;
+    live_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void* throwing_allocate(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        if (void* ptr = counted_allocate(size)) {
+            return ptr;
+        }
+        auto handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+#endif
+
+} // namespace
+
+bool alloc_stats_enabled() noexcept {
+#if defined(BASICPP_ALLOC_STATS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+alloc_counters alloc_snapshot() noexcept {
+    alloc_counters counters;
+    counters.allocations = allocation_count.load(std::memory_order_relaxed);
+    counters.bytes_allocated = allocated_bytes.load(std::memory_order_relaxed);
+    counters.live_bytes = live_bytes.load(std::memory_order_relaxed);
+    counters.peak_live_bytes = peak_live_bytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void reset_alloc_peak() noexcept {
+    peak_live_bytes.store(live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+std::size_t peak_rss_bytes() noexcept {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<std::size_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024u;
+#endif
+#endif
+}
+
+} // namespace basicpp::cli
+
+#if defined(BASICPP_ALLOC_STATS)
+
+// Replaceable global allocation functions; only present in the instrumented build flavour.
+// Over-aligned allocations keep the default implementation and are not counted.
+
+void* operator new(std::size_t size) {
+    return basicpp::cli::throwing_allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return basicpp::cli::throwing_allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return basicpp::cli::throwing_allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return basicpp::cli::throwing_allocate(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* ptr) noexcept {
+    basicpp::cli::counted_deallocate(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    basicpp::cli::counted_deallocate(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    basicpp::cli::counted_deallocate(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    basicpp::cli::counted_deallocate(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    basicpp::cli::counted_deallocate(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    basicpp::cli::counted_deallocate(ptr);
+}
+
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace basicpp::cli {
+
+// Process-wide allocation counters maintained by the replaceable global operator new hook.
+// The hook is only compiled into the instrumented build flavour (BASICPP_ENABLE_ALLOC_STATS=ON);
+// other builds report zeroed counters and alloc_stats_enabled() returns false.
+struct alloc_counters {
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes_allocated = 0;
+    std::uint64_t live_bytes = 0;
+    std::uint64_t peak_live_bytes = 0;
+};
+
+bool alloc_stats_enabled() noexcept;
+
+alloc_counters alloc_snapshot() noexcept;
+
+// Restarts peak tracking from the current live byte count so a phase can measure its own high-water mark.
+void reset_alloc_peak() noexcept;
+
+// Peak resident set size of the process in bytes, or 0 when the platform does not expose it.
+std::size_t peak_rss_bytes() noexcept;
+
+} // namespace basicpp::cli
@@ -0,0 +1,287 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "alloc_stats.hpp"
+#include "codegen/generator.hpp"
+#include "corpus.hpp"
+#include "frontend/lexer.hpp"
+#include "frontend/parser.hpp"
+#include "frontend/session.hpp"
+
+namespace basicpp::cli {
+
+namespace {
+
+struct bench_options {
+    std::vector<corpus_shape> shapes;
+    std::size_t size = 1000;
+    std::size_t warmup = 3;
+    std::size_t repetitions = 10;
+    std::uint64_t seed = 1;
+    std::optional<std::filesystem::path> json_path;
+    std::optional<std::filesystem::path> corpus_directory;
+};
+
+struct phase_result {
+    std::string_view name;
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+    double mb_per_s = 0.0;
+    double tokens_per_s = 0.0;
+    std::uint64_t allocations = 0;
+    std::uint64_t bytes_allocated = 0;
+};
+
+struct corpus_result {
+    corpus_shape shape = corpus_shape::mixed;
+    std::size_t bytes = 0;
+    std::size_t tokens = 0;
+    std::vector<phase_result> phases;
+};
+
+std::size_t parse_count(const std::vector<std::string>& params, std::size_t& index, std::string_view flag) {
+    if (index + 1 >= params.size()) {
+        throw std::runtime_error(std::string(flag) + " requires a numeric argument");
+    }
+    const auto& value = params[++index];
+    try {
+        return static_cast<std::size_t>(std::stoull(value));
+    } catch (const std::exception&) {
+        throw std::runtime_error("invalid value for " + std::string(flag) + ": " + value);
+    }
+}
+
+std::filesystem::path parse_path(const std::vector<std::string>& params, std::size_t& index, std::string_view flag) {
+    if (index + 1 >= params.size()) {
+        throw std::runtime_error(std::string(flag) + " requires a path argument");
+    }
+    return params[++index];
+}
+
+bench_options parse_bench_options(const std::vector<std::string>& params) {
+    bench_options options;
+
+    for (std::size_t index = 0; index < params.size(); ++index) {
+        const auto& param = params[index];
+
+        if (param == "--shape") {
+            if (index + 1 >= params.size()) {
+                throw std::runtime_error("--shape requires a name");
+            }
+            const auto& name = params[++index];
+            if (name == "all") {
+                options.shapes = {corpus_shape::constants, corpus_shape::states, corpus_shape::commands,
+                                  corpus_shape::bodies, corpus_shape::mixed};
+                continue;
+            }
+            auto shape = parse_corpus_shape(name);
+            if (!shape) {
+                throw std::runtime_error("unknown corpus shape: " + name);
+            }
+            options.shapes.push_back(*shape);
+            continue;
+        }
+
+        if (param == "--size") {
+            options.size = parse_count(params, index, param);
+            continue;
+        }
+        if (param == "--warmup") {
+            options.warmup = parse_count(params, index, param);
+            continue;
+        }
+        if (param == "--reps") {
+            options.repetitions = std::max<std::size_t>(1, parse_count(params, index, param));
+            continue;
+        }
+        if (param == "--seed") {
+            options.seed = parse_count(params, index, param);
+            continue;
+        }
+        if (param == "--json") {
+            options.json_path = parse_path(params, index, param);
+            continue;
+        }
+        if (param == "--emit-corpus") {
+            options.corpus_directory = parse_path(params, index, param);
+            continue;
+        }
+
+        throw std::runtime_error("unknown parameter: " + param);
+    }
+
+    if (options.shapes.empty()) {
+        options.shapes.push_back(corpus_shape::mixed);
+    }
+    return options;
+}
+
+// Runs `body` warmup + repetitions times and reports per-iteration timing and allocation figures.
+template <typename Fn>
+phase_result measure(std::string_view name, const bench_options& options, std::size_t bytes, std::size_t tokens,
+                     Fn&& body) {
+    for (std::size_t i = 0; i < options.warmup; ++i) {
+        body();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    const auto before = alloc_snapshot();
+    for (std::size_t i = 0; i < options.repetitions; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    const auto after = alloc_snapshot();
+
+    std::sort(samples.begin(), samples.end());
+    phase_result result;
+    result.name = name;
+    result.min_ns = samples.front();
+    result.median_ns = samples[samples.size() / 2];
+    const double seconds = result.median_ns / 1e9;
+    if (seconds > 0.0) {
+        result.mb_per_s = static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+        result.tokens_per_s = static_cast<double>(tokens) / seconds;
+    }
+    result.allocations = (after.allocations - before.allocations) / options.repetitions;
+    result.bytes_allocated = (after.bytes_allocated - before.bytes_allocated) / options.repetitions;
+    return result;
+}
+
+corpus_result run_corpus(corpus_shape shape, const bench_options& options) {
+    const auto source = generate_corpus(corpus_options{shape, options.size, options.seed});
+
+    if (options.corpus_directory) {
+        std::filesystem::create_directories(*options.corpus_directory);
+        auto path = *options.corpus_directory / ("bench_" + std::string(to_string(shape)) + ".bpp");
+        std::ofstream(path, std::ios::binary) << source;
+    }
+
+    std::vector<frontend::token> tokens;
+    frontend::ast::module_decl module;
+    std::string cpp_source;
+    frontend::transpiler_session session;
+
+    if (auto lexed = frontend::lexer::tokenize(source, tokens); !lexed) {
+        throw std::runtime_error("generated corpus failed to lex: " + lexed.error().message);
+    }
+    if (auto parsed = frontend::parser::parse_module(tokens, module); !parsed) {
+        throw std::runtime_error("generated corpus failed to parse: " + parsed.error().message);
+    }
+
+    corpus_result result;
+    result.shape = shape;
+    result.bytes = source.size();
+    result.tokens = tokens.size();
+
+    // Each phase runs on inputs prepared by the previous one, reusing buffers like a long-lived session.
+    result.phases.push_back(measure("lex", options, result.bytes, result.tokens, [&] {
+        (void)frontend::lexer::tokenize(source, tokens);
+    }));
+    result.phases.push_back(measure("parse", options, result.bytes, result.tokens, [&] {
+        (void)frontend::parser::parse_module(tokens, module);
+    }));
+    result.phases.push_back(measure("codegen", options, result.bytes, result.tokens, [&] {
+        (void)codegen::generate_translation_unit(module, cpp_source);
+    }));
+    result.phases.push_back(measure("pipeline", options, result.bytes, result.tokens, [&] {
+        (void)session.transpile(source);
+    }));
+
+    return result;
+}
+
+void print_results(const std::vector<corpus_result>& results) {
+    for (const auto& corpus : results) {
+        std::cout << "corpus " << to_string(corpus.shape) << ": " << corpus.bytes << " bytes, " << corpus.tokens
+                  << " tokens\n";
+        std::cout << "  " << std::left << std::setw(10) << "phase" << std::right << std::setw(14) << "median_ms"
+                  << std::setw(12) << "MB/s" << std::setw(16) << "tokens/s" << std::setw(12) << "allocs"
+                  << std::setw(14) << "bytes" << '\n';
+        for (const auto& phase : corpus.phases) {
+            std::cout << "  " << std::left << std::setw(10) << phase.name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(14) << phase.median_ns / 1e6 << std::setprecision(1)
+                      << std::setw(12) << phase.mb_per_s << std::setprecision(0) << std::setw(16) << phase.tokens_per_s
+                      << std::setw(12) << phase.allocations << std::setw(14) << phase.bytes_allocated << '\n';
+        }
+    }
+    if (!alloc_stats_enabled()) {
+        std::cout << "(allocation counters unavailable; configure with -DBASICPP_ENABLE_ALLOC_STATS=ON)\n";
+    }
+}
+
+void write_json(std::ostream& out, const bench_options& options, const std::vector<corpus_result>& results) {
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n";
+    out << "  \"tool\": \"bppc\",\n";
+    out << "  \"version\": \"" << BASICPP_VERSION << "\",\n";
+    out << "  \"alloc_stats\": " << (alloc_stats_enabled() ? "true" : "false") << ",\n";
+    out << "  \"config\": {\"size\": " << options.size << ", \"warmup\": " << options.warmup
+        << ", \"repetitions\": " << options.repetitions << ", \"seed\": " << options.seed << "},\n";
+    out << "  \"corpora\": [\n";
+    for (std::size_t c = 0; c < results.size(); ++c) {
+        const auto& corpus = results[c];
+        out << "    {\n";
+        out << "      \"shape\": \"" << to_string(corpus.shape) << "\",\n";
+        out << "      \"bytes\": " << corpus.bytes << ",\n";
+        out << "      \"tokens\": " << corpus.tokens << ",\n";
+        out << "      \"phases\": [\n";
+        for (std::size_t p = 0; p < corpus.phases.size(); ++p) {
+            const auto& phase = corpus.phases[p];
+            out << "        {\"name\": \"" << phase.name << "\", \"median_ns\": " << phase.median_ns
+                << ", \"min_ns\": " << phase.min_ns << ", \"mb_per_s\": " << phase.mb_per_s
+                << ", \"tokens_per_s\": " << phase.tokens_per_s << ", \"allocations\": " << phase.allocations
+                << ", \"bytes_allocated\": " << phase.bytes_allocated << '}'
+                << (p + 1 < corpus.phases.size() ? "," : "") << '\n';
+        }
+        out << "      ]\n";
+        out << "    }" << (c + 1 < results.size() ? "," : "") << '\n';
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+} // namespace
+
+int run_bench(const std::vector<std::string>& params) {
+    bench_options options;
+    std::vector<corpus_result> results;
+    try {
+        options = parse_bench_options(params);
+        for (auto shape : options.shapes) {
+            results.push_back(run_corpus(shape, options));
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+
+    print_results(results);
+
+    if (options.json_path) {
+        std::ofstream json(*options.json_path, std::ios::binary);
+        if (!json) {
+            std::cerr << "failed to write " << options.json_path->string() << '\n';
+            return 1;
+        }
+        write_json(json, options, results);
+        std::cout << "Wrote " << options.json_path->string() << '\n';
+    }
+    return 0;
+}
+
+} // namespace basicpp::cli
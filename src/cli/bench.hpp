@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace basicpp::cli {
+
+int run_bench(const std::vector<std::string>& params);
+
+} // namespace basicpp::cli
@@ -0,0 +1,110 @@
+#include "build_cache.hpp"
+
+#include <fstream>
+#include <ios>
+#include <string>
+
+namespace basicpp::cli {
+
+namespace {
+
+constexpr std::string_view stamp_header = "bppc-stamp 3";
+
+} // namespace
+
+std::uint64_t fingerprint(std::string_view data, std::uint64_t seed) noexcept {
+    std::uint64_t hash = seed;
+    for (unsigned char ch : data) {
+        hash ^= ch;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::uint64_t fingerprint_combine(std::uint64_t seed, std::uint64_t value) noexcept {
+    for (int shift = 0; shift < 64; shift += 8) {
+        seed ^= (value >> shift) & 0xFFu;
+        seed *= 0x100000001b3ULL;
+    }
+    return seed;
+}
+
+std::filesystem::path stamp_path_for(const std::filesystem::path& output_path) {
+    auto path = output_path;
+    path.replace_extension(".stamp");
+    return path;
+}
+
+std::filesystem::path interface_path_for(const std::filesystem::path& output_path) {
+    auto path = output_path;
+    path.replace_extension(".bppi");
+    return path;
+}
+
+std::optional<build_stamp> read_stamp(const std::filesystem::path& path) {
+    std::ifstream input(path);
+    if (!input) {
+        return std::nullopt;
+    }
+
+    std::string header;
+    if (!std::getline(input, header) || header != stamp_header) {
+        return std::nullopt;
+    }
+
+    build_stamp stamp;
+    unsigned fields = 0;
+    std::string field;
+    while (input >> field) {
+        if (field == "warning") {
+            std::string message;
+            std::getline(input, message);
+            stamp.warnings.push_back(message.empty() ? message : message.substr(1));
+            continue;
+        }
+
+        std::uint64_t* target = nullptr;
+        if (field == "source") {
+            target = &stamp.source_hash;
+        } else if (field == "interface") {
+            target = &stamp.interface_hash;
+        } else if (field == "key") {
+            target = &stamp.key;
+        }
+
+        if (!target) {
+            std::string ignored;
+            std::getline(input, ignored);
+            continue;
+        }
+        if (!(input >> std::hex >> *target >> std::dec)) {
+            return std::nullopt;
+        }
+        ++fields;
+    }
+
+    if (fields != 3) {
+        return std::nullopt;
+    }
+    return stamp;
+}
+
+bool write_stamp(const std::filesystem::path& path, const build_stamp& stamp) {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        return false;
+    }
+    output << stamp_header << '\n';
+    output << std::hex;
+    output << "source " << stamp.source_hash << '\n';
+    output << "interface " << stamp.interface_hash << '\n';
+    output << "key " << stamp.key << '\n';
+    output << std::dec;
+    for (const auto& warning : stamp.warnings) {
+        output << "warning " << warning << '\n';
+    }
+    output.close();
+    return static_cast<bool>(output);
+}
+
+} // namespace basicpp::cli
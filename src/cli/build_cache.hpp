@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace basicpp::cli {
+
+inline constexpr std::uint64_t fingerprint_seed = 0xcbf29ce484222325ULL;
+
+// 64-bit FNV-1a; chain calls through `seed` to fingerprint several inputs.
+std::uint64_t fingerprint(std::string_view data, std::uint64_t seed = fingerprint_seed) noexcept;
+
+std::uint64_t fingerprint_combine(std::uint64_t seed, std::uint64_t value) noexcept;
+
+// Sidecar record written next to each generated file. A module is reused when the key computed
+// from its source and its dependencies' interfaces matches the recorded one and the output still exists.
+// The source hash lets importers trust the module's .bppi summary without reparsing the source. Warnings
+// from generating the output are kept so a reused module still reports them.
+struct build_stamp {
+    std::uint64_t source_hash = 0;
+    std::uint64_t interface_hash = 0;
+    std::uint64_t key = 0;
+    std::vector<std::string> warnings;
+};
+
+std::filesystem::path stamp_path_for(const std::filesystem::path& output_path);
+
+std::filesystem::path interface_path_for(const std::filesystem::path& output_path);
+
+std::optional<build_stamp> read_stamp(const std::filesystem::path& path);
+
+bool write_stamp(const std::filesystem::path& path, const build_stamp& stamp);
+
+} // namespace basicpp::cli
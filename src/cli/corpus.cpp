@@ -0,0 +1,161 @@
+#include "corpus.hpp"
+
+#include <string>
+
+namespace basicpp::cli {
+
+namespace {
+
+// Small deterministic generator (splitmix64) so corpora do not depend on the standard library's engines.
+class corpus_random {
+public:
+    explicit corpus_random(std::uint64_t seed)
+        : state_(seed) {
+    }
+
+    std::uint64_t next() noexcept {
+        std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    std::size_t below(std::size_t bound) noexcept {
+        return bound == 0 ? 0 : static_cast<std::size_t>(next() % bound);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+void append_constants(std::string& out, std::size_t count, corpus_random& random) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out += "const Value" + std::to_string(i) + " = ";
+        switch (random.below(4)) {
+        case 0: out += std::to_string(random.below(1000000)); break;
+        case 1: out += std::to_string(random.below(1000)) + '.' + std::to_string(random.below(100)); break;
+        case 2: out += "\"text value " + std::to_string(random.below(100000)) + '"'; break;
+        default: out += random.below(2) == 0 ? "true" : "false"; break;
+        }
+        out += '\n';
+    }
+}
+
+void append_states(std::string& out, std::size_t transitions, corpus_random& random) {
+    constexpr std::size_t transitions_per_machine = 500;
+    constexpr std::size_t states_per_machine = 64;
+    constexpr std::size_t events_per_machine = 32;
+
+    std::size_t machine = 0;
+    while (transitions > 0) {
+        const auto count = transitions < transitions_per_machine ? transitions : transitions_per_machine;
+        out += "state Machine" + std::to_string(machine) + " = State0\n";
+        for (std::size_t i = 0; i < count; ++i) {
+            out += "    on Event" + std::to_string(random.below(events_per_machine)) + " => State" +
+                   std::to_string(random.below(states_per_machine)) + '\n';
+        }
+        transitions -= count;
+        ++machine;
+    }
+}
+
+void append_statements(std::string& out, std::size_t count, corpus_random& random) {
+    for (std::size_t i = 0; i < count; ++i) {
+        switch (random.below(3)) {
+        case 0:
+            out += "    let total" + std::to_string(i) + " = count * " + std::to_string(random.below(100)) + " + offset\n";
+            break;
+        case 1:
+            out += "    if count >= " + std::to_string(random.below(1000)) + " then\n";
+            out += "        count = count - 1\n";
+            out += "    end if\n";
+            break;
+        default:
+            out += "    print \"step " + std::to_string(i) + "\" & name\n";
+            break;
+        }
+    }
+}
+
+void append_commands(std::string& out, std::size_t count, corpus_random& random) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out += "command Command" + std::to_string(i) + "(name, count, offset)\n";
+        append_statements(out, 1 + random.below(4), random);
+        out += "end command\n";
+    }
+}
+
+void append_bodies(std::string& out, std::size_t statements, corpus_random& random) {
+    constexpr std::size_t statements_per_function = 5000;
+
+    std::size_t function = 0;
+    while (statements > 0) {
+        const auto count = statements < statements_per_function ? statements : statements_per_function;
+        out += "function Body" + std::to_string(function) + "(name, count, offset) as Integer\n";
+        append_statements(out, count, random);
+        out += "    return count\n";
+        out += "end function\n";
+        statements -= count;
+        ++function;
+    }
+}
+
+} // namespace
+
+std::string_view to_string(corpus_shape shape) {
+    switch (shape) {
+    case corpus_shape::constants: return "constants";
+    case corpus_shape::states: return "states";
+    case corpus_shape::commands: return "commands";
+    case corpus_shape::bodies: return "bodies";
+    case corpus_shape::mixed: return "mixed";
+    }
+    return "unknown";
+}
+
+std::optional<corpus_shape> parse_corpus_shape(std::string_view name) {
+    for (auto shape : {corpus_shape::constants, corpus_shape::states, corpus_shape::commands, corpus_shape::bodies,
+                       corpus_shape::mixed}) {
+        if (to_string(shape) == name) {
+            return shape;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string generate_corpus(const corpus_options& options) {
+    corpus_random random(options.seed);
+    std::string out;
+    out.reserve(options.size * 48 + 64);
+
+    out += "module Bench";
+    out += to_string(options.shape);
+    out += "\nimport Basicpp.Command\n";
+
+    switch (options.shape) {
+    case corpus_shape::constants:
+        append_constants(out, options.size, random);
+        break;
+    case corpus_shape::states:
+        append_states(out, options.size, random);
+        break;
+    case corpus_shape::commands:
+        append_commands(out, options.size, random);
+        break;
+    case corpus_shape::bodies:
+        append_bodies(out, options.size, random);
+        break;
+    case corpus_shape::mixed: {
+        const auto quarter = options.size / 4;
+        append_constants(out, quarter, random);
+        append_states(out, quarter, random);
+        append_commands(out, quarter, random);
+        append_bodies(out, options.size - 3 * quarter, random);
+        break;
+    }
+    }
+
+    return out;
+}
+
+} // namespace basicpp::cli
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace basicpp::cli {
+
+// Synthetic .bpp workloads used by `bppc bench`; each shape stresses a different part of the frontend.
+enum class corpus_shape {
+    constants,
+    states,
+    commands,
+    bodies,
+    mixed,
+};
+
+struct corpus_options {
+    corpus_shape shape = corpus_shape::mixed;
+    // Number of top-level declarations (constants, transitions, commands) or body statements.
+    std::size_t size = 1000;
+    std::uint64_t seed = 1;
+};
+
+std::string_view to_string(corpus_shape shape);
+
+std::optional<corpus_shape> parse_corpus_shape(std::string_view name);
+
+// Deterministic for a given set of options so results can be compared across versions.
+std::string generate_corpus(const corpus_options& options);
+
+} // namespace basicpp::cli
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 
+#include "bench.hpp"
 #include "transpile.hpp"
 
 namespace {
@@ -28,10 +29,25 @@ void print_usage() {
     std::cout << "Commands:\n";
     std::cout << "  transpile   Convert .bpp sources into C++ files\n";
     std::cout << "  build       Run full pipeline (transpile + compile)\n";
+    std::cout << "  bench       Measure frontend throughput on synthetic corpora\n";
     std::cout << "  version     Display tool version\n";
     std::cout << "\nOptions for 'transpile':\n";
     std::cout << "  --tokens           Dump lexer tokens after parsing\n";
     std::cout << "  --out <path>       Override output path (file or directory)\n";
+    std::cout << "  --import-path <dir> Add a directory searched for imported modules (repeatable)\n";
+    std::cout << "  --jobs <n>         Transpile up to n independent modules concurrently\n";
+    std::cout << "  --no-cache         Regenerate every module even if its stamp is current\n";
+    std::cout << "  --no-state-checks  Skip warnings about unreachable, overridden or equivalent states\n";
+    std::cout << "  --minimize-states  Merge equivalent states and drop unreachable ones before emission\n";
+    std::cout << "  --mem-stats        Report time, allocations and peak memory per phase\n";
+    std::cout << "\nOptions for 'bench':\n";
+    std::cout << "  --shape <name>     constants, states, commands, bodies, mixed or all (repeatable)\n";
+    std::cout << "  --size <n>         Declarations (or body statements) per corpus, default 1000\n";
+    std::cout << "  --warmup <n>       Untimed iterations per phase, default 3\n";
+    std::cout << "  --reps <n>         Timed iterations per phase, default 10\n";
+    std::cout << "  --seed <n>         Corpus generator seed, default 1\n";
+    std::cout << "  --json <path>      Write results as JSON\n";
+    std::cout << "  --emit-corpus <dir> Also write the generated .bpp corpora\n";
 }
 
 int run_build(const std::vector<std::string>& params) {
@@ -57,6 +73,10 @@ int main(int argc, char** argv) {
         return basicpp::cli::run_transpile(args.parameters);
     }
 
+    if (args.subcommand == "bench") {
+        return basicpp::cli::run_bench(args.parameters);
+    }
+
     if (args.subcommand == "build") {
         return run_build(args.parameters);
     }
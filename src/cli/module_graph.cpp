@@ -0,0 +1,122 @@
+#include "module_graph.hpp"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+
+namespace basicpp::cli {
+
+std::optional<std::filesystem::path> resolve_import(std::string_view import_path,
+                                                    const std::vector<std::filesystem::path>& search_paths) {
+    std::filesystem::path relative;
+    std::size_t start = 0;
+    while (start <= import_path.size()) {
+        const auto dot = import_path.find('.', start);
+        const auto segment = import_path.substr(start, dot == std::string_view::npos ? std::string_view::npos : dot - start);
+        if (segment.empty()) {
+            return std::nullopt;
+        }
+        relative /= std::string(segment);
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+    relative += ".bpp";
+
+    for (const auto& directory : search_paths) {
+        auto candidate = directory / relative;
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(candidate, ec)) {
+            return candidate;
+        }
+    }
+    return std::nullopt;
+}
+
+std::size_t module_graph::add_node(std::string name) {
+    names_.push_back(std::move(name));
+    dependencies_.emplace_back();
+    return names_.size() - 1;
+}
+
+void module_graph::add_dependency(std::size_t from, std::size_t to) {
+    auto& deps = dependencies_[from];
+    if (std::find(deps.begin(), deps.end(), to) == deps.end()) {
+        deps.push_back(to);
+    }
+}
+
+core::result<std::vector<std::vector<std::size_t>>, std::string> module_graph::topological_levels() const {
+    using levels_result = core::result<std::vector<std::vector<std::size_t>>, std::string>;
+
+    std::vector<std::vector<std::size_t>> dependents(size());
+    std::vector<std::size_t> pending(size(), 0);
+    for (std::size_t node = 0; node < size(); ++node) {
+        pending[node] = dependencies_[node].size();
+        for (auto dep : dependencies_[node]) {
+            dependents[dep].push_back(node);
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> levels;
+    std::vector<std::size_t> frontier;
+    for (std::size_t node = 0; node < size(); ++node) {
+        if (pending[node] == 0) {
+            frontier.push_back(node);
+        }
+    }
+
+    std::size_t processed = 0;
+    while (!frontier.empty()) {
+        std::vector<std::size_t> next;
+        for (auto node : frontier) {
+            for (auto dependent : dependents[node]) {
+                if (--pending[dependent] == 0) {
+                    next.push_back(dependent);
+                }
+            }
+        }
+        processed += frontier.size();
+        levels.push_back(std::move(frontier));
+        frontier = std::move(next);
+    }
+
+    if (processed != size()) {
+        return levels_result::err(describe_cycle(pending));
+    }
+
+    return levels_result::ok(std::move(levels));
+}
+
+std::string module_graph::describe_cycle(const std::vector<std::size_t>& remaining_in_degree) const {
+    // Every node left with pending dependencies lies on or behind a cycle; walking unresolved
+    // dependencies from any of them must eventually revisit a node.
+    std::size_t node = 0;
+    while (node < size() && remaining_in_degree[node] == 0) {
+        ++node;
+    }
+
+    std::vector<std::size_t> path;
+    std::vector<std::size_t> position(size(), size());
+    while (position[node] == size()) {
+        position[node] = path.size();
+        path.push_back(node);
+        for (auto dep : dependencies_[node]) {
+            if (remaining_in_degree[dep] != 0) {
+                node = dep;
+                break;
+            }
+        }
+    }
+
+    std::string message = "import cycle detected: ";
+    for (std::size_t i = position[node]; i < path.size(); ++i) {
+        message += names_[path[i]];
+        message += " -> ";
+    }
+    message += names_[node];
+    return message;
+}
+
+} // namespace basicpp::cli
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <basicpp/core/result.hpp>
+
+namespace basicpp::cli {
+
+// Maps a dotted import path (Alpha.Beta) to Alpha/Beta.bpp under the first search directory that has it.
+std::optional<std::filesystem::path> resolve_import(std::string_view import_path,
+                                                    const std::vector<std::filesystem::path>& search_paths);
+
+// Directed dependency graph between modules; an edge from -> to means `from` imports `to`.
+class module_graph {
+public:
+    std::size_t add_node(std::string name);
+
+    void add_dependency(std::size_t from, std::size_t to);
+
+    std::size_t size() const noexcept {
+        return names_.size();
+    }
+
+    const std::string& name(std::size_t node) const {
+        return names_[node];
+    }
+
+    const std::vector<std::size_t>& dependencies(std::size_t node) const {
+        return dependencies_[node];
+    }
+
+    // Groups nodes into levels so each node only depends on nodes from earlier levels; nodes inside a
+    // level are independent and can be processed concurrently. Fails with the offending path on cycles.
+    core::result<std::vector<std::vector<std::size_t>>, std::string> topological_levels() const;
+
+private:
+    std::string describe_cycle(const std::vector<std::size_t>& remaining_in_degree) const;
+
+    std::vector<std::string> names_;
+    std::vector<std::vector<std::size_t>> dependencies_;
+};
+
+} // namespace basicpp::cli
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace basicpp::cli {
+
+inline std::size_t default_job_count() noexcept {
+    const auto hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+// Runs fn(index) for every index in [0, count) on up to `jobs` threads, including the caller.
+// The first exception thrown by any invocation is rethrown once all workers have stopped.
+template <typename Fn>
+void parallel_for(std::size_t count, std::size_t jobs, Fn&& fn) {
+    const auto workers = std::min(std::max<std::size_t>(jobs, 1), count);
+    if (workers <= 1) {
+        for (std::size_t index = 0; index < count; ++index) {
+            fn(index);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+
+    auto worker = [&] {
+        while (true) {
+            const auto index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count) {
+                return;
+            }
+            try {
+                fn(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                next.store(count, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+} // namespace basicpp::cli
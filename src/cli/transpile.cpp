@@ -1,18 +1,29 @@
 #include "transpile.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <vector>
 
+#include "alloc_stats.hpp"
+#include "build_cache.hpp"
 #include "codegen/generator.hpp"
+#include "frontend/diagnostic.hpp"
+#include "frontend/interface.hpp"
 #include "frontend/lexer.hpp"
 #include "frontend/parser.hpp"
+#include "module_graph.hpp"
+#include "parallel.hpp"
 
 namespace basicpp::cli {
 
@@ -21,7 +32,121 @@ namespace {
 struct transpile_options {
     std::filesystem::path input_path;
     std::optional<std::filesystem::path> output_path;
+    std::vector<std::filesystem::path> import_paths;
+    std::size_t jobs = 0;
     bool show_tokens = false;
+    bool mem_stats = false;
+    bool use_cache = true;
+    bool check_states = true;
+    bool minimize_states = false;
+};
+
+// One .bpp file of the project: the input module or a module reached through its imports.
+struct module_unit {
+    std::string import_path;
+    std::filesystem::path source_path;
+    std::filesystem::path output_path;
+    std::string source;
+    basicpp::frontend::ast::module_decl module;
+    std::string interface_text;
+    std::optional<build_stamp> stamp;
+    std::string error;
+    std::vector<std::string> warnings;
+    std::uint64_t source_hash = 0;
+    std::uint64_t interface_hash = 0;
+    bool parsed = false;
+    bool up_to_date = false;
+};
+
+struct phase_stats {
+    std::string_view name;
+    double elapsed_ms = 0.0;
+    alloc_counters allocations{};
+};
+
+// Measures wall time and allocation deltas for each compiler phase when --mem-stats is requested.
+// Repeated runs of the same phase (one per module) are accumulated; peak live bytes keeps the maximum.
+// Not thread-safe: --mem-stats processes modules on a single thread.
+class phase_recorder {
+public:
+    explicit phase_recorder(bool enabled)
+        : enabled_(enabled) {
+    }
+
+    template <typename Fn>
+    decltype(auto) run(std::string_view name, Fn&& fn) {
+        if (!enabled_) {
+            return fn();
+        }
+
+        reset_alloc_peak();
+        const auto before = alloc_snapshot();
+        const auto start = std::chrono::steady_clock::now();
+
+        struct finish_guard {
+            phase_recorder& recorder;
+            std::string_view name;
+            alloc_counters before;
+            std::chrono::steady_clock::time_point start;
+
+            ~finish_guard() {
+                const auto end = std::chrono::steady_clock::now();
+                const auto after = alloc_snapshot();
+
+                phase_stats stats;
+                stats.name = name;
+                stats.elapsed_ms = std::chrono::duration<double, std::milli>(end - start).count();
+                stats.allocations.allocations = after.allocations - before.allocations;
+                stats.allocations.bytes_allocated = after.bytes_allocated - before.bytes_allocated;
+                stats.allocations.live_bytes = after.live_bytes;
+                stats.allocations.peak_live_bytes =
+                    after.peak_live_bytes > before.live_bytes ? after.peak_live_bytes - before.live_bytes : 0;
+                recorder.accumulate(stats);
+            }
+        } guard{*this, name, before, start};
+
+        return fn();
+    }
+
+    void report(std::ostream& out) const {
+        if (!enabled_) {
+            return;
+        }
+
+        out << "memory statistics:\n";
+        out << "  " << std::left << std::setw(10) << "phase" << std::right << std::setw(12) << "time_ms"
+            << std::setw(12) << "allocs" << std::setw(14) << "bytes" << std::setw(14) << "peak_live" << '\n';
+        for (const auto& phase : phases_) {
+            out << "  " << std::left << std::setw(10) << phase.name << std::right << std::setw(12) << std::fixed
+                << std::setprecision(3) << phase.elapsed_ms << std::setw(12) << phase.allocations.allocations
+                << std::setw(14) << phase.allocations.bytes_allocated << std::setw(14)
+                << phase.allocations.peak_live_bytes << '\n';
+        }
+        if (!alloc_stats_enabled()) {
+            out << "  (allocation counters unavailable; configure with -DBASICPP_ENABLE_ALLOC_STATS=ON)\n";
+        }
+        out << "  peak_rss_bytes " << peak_rss_bytes() << '\n';
+    }
+
+private:
+    void accumulate(const phase_stats& stats) {
+        for (auto& phase : phases_) {
+            if (phase.name == stats.name) {
+                phase.elapsed_ms += stats.elapsed_ms;
+                phase.allocations.allocations += stats.allocations.allocations;
+                phase.allocations.bytes_allocated += stats.allocations.bytes_allocated;
+                phase.allocations.live_bytes = stats.allocations.live_bytes;
+                if (stats.allocations.peak_live_bytes > phase.allocations.peak_live_bytes) {
+                    phase.allocations.peak_live_bytes = stats.allocations.peak_live_bytes;
+                }
+                return;
+            }
+        }
+        phases_.push_back(stats);
+    }
+
+    bool enabled_;
+    std::vector<phase_stats> phases_;
 };
 
 transpile_options parse_transpile_options(const std::vector<std::string>& params) {
@@ -35,6 +160,53 @@ transpile_options parse_transpile_options(const std::vector<std::string>& params
             continue;
         }
 
+        if (param == "--mem-stats") {
+            options.mem_stats = true;
+            continue;
+        }
+
+        if (param == "--no-cache") {
+            options.use_cache = false;
+            continue;
+        }
+
+        if (param == "--no-state-checks") {
+            options.check_states = false;
+            continue;
+        }
+
+        if (param == "--minimize-states") {
+            options.minimize_states = true;
+            continue;
+        }
+
+        constexpr std::string_view import_prefix = "--import-path=";
+        if (param.rfind(import_prefix, 0) == 0) {
+            options.import_paths.emplace_back(param.substr(import_prefix.size()));
+            continue;
+        }
+
+        if (param == "--import-path") {
+            if (index + 1 >= params.size()) {
+                throw std::runtime_error("--import-path requires a directory argument");
+            }
+            options.import_paths.emplace_back(params[++index]);
+            continue;
+        }
+
+        if (param == "--jobs") {
+            if (index + 1 >= params.size()) {
+                throw std::runtime_error("--jobs requires a count argument");
+            }
+            const auto& count = params[++index];
+            try {
+                options.jobs = static_cast<std::size_t>(std::stoul(count));
+            } catch (const std::exception&) {
+                throw std::runtime_error("invalid --jobs count: " + count);
+            }
+            continue;
+        }
+
         constexpr std::string_view out_prefix = "--out=";
         if (param.rfind(out_prefix, 0) == 0) {
             options.output_path = param.substr(out_prefix.size());
@@ -86,6 +258,189 @@ std::filesystem::path resolve_output_path(const std::filesystem::path& input,
     return candidate;
 }
 
+// Imported modules mirror their import path under an --out directory; otherwise they are written
+// beside their source like a single-file transpile.
+std::filesystem::path resolve_dependency_output_path(const module_unit& unit,
+                                                     const std::optional<std::filesystem::path>& override_path) {
+    if (override_path && !override_path->has_extension()) {
+        std::filesystem::path relative;
+        std::string segment;
+        for (char ch : unit.import_path) {
+            if (ch == '.') {
+                relative /= segment;
+                segment.clear();
+            } else {
+                segment.push_back(ch);
+            }
+        }
+        relative /= segment + ".cpp";
+        return *override_path / relative;
+    }
+
+    std::filesystem::path candidate = unit.source_path;
+    candidate.replace_extension(".cpp");
+    return candidate;
+}
+
+std::filesystem::path canonical_key(const std::filesystem::path& path) {
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(path, ec);
+    return ec ? path.lexically_normal() : canonical;
+}
+
+bool read_source(const std::filesystem::path& path, std::string& source) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+core::result<void, std::string> write_text_file(const std::filesystem::path& path, const std::string& contents) {
+    if (path.has_parent_path()) {
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        if (ec) {
+            return core::result<void, std::string>::err("failed to create output directory: " + ec.message());
+        }
+    }
+
+    std::ofstream output_file(path, std::ios::binary);
+    if (!output_file) {
+        return core::result<void, std::string>::err("failed to write " + path.string());
+    }
+
+    output_file << contents;
+    if (!contents.empty() && contents.back() != '\n') {
+        output_file << '\n';
+    }
+    output_file.close();
+    if (!output_file) {
+        return core::result<void, std::string>::err("failed to write " + path.string());
+    }
+    return core::result<void, std::string>::ok();
+}
+
+void parse_unit(module_unit& unit, phase_recorder& recorder) {
+    auto tokens = recorder.run("lex", [&] {
+        return basicpp::frontend::lexer::tokenize(unit.source);
+    });
+    if (!tokens) {
+        unit.error = unit.source_path.string() + ": lexer error: " + tokens.error();
+        return;
+    }
+
+    auto module = recorder.run("parse", [&] {
+        return basicpp::frontend::parser::parse_module(tokens.value());
+    });
+    if (!module) {
+        unit.error = unit.source_path.string() + ": parser error: " + module.error();
+        return;
+    }
+
+    unit.module = std::move(module.value());
+    unit.interface_text = basicpp::frontend::write_interface(unit.module);
+    unit.interface_hash = fingerprint(unit.interface_text);
+    unit.parsed = true;
+}
+
+// Loads just enough of a module to know its imports and exported interface. When the stamp shows the
+// source is unchanged, the .bppi summary is read instead of lexing and parsing the full source.
+void load_unit(module_unit& unit, const transpile_options& options, phase_recorder& recorder) {
+    if (!read_source(unit.source_path, unit.source)) {
+        unit.error = "failed to open " + unit.source_path.string();
+        return;
+    }
+    unit.source_hash = fingerprint(unit.source);
+
+    if (options.use_cache) {
+        unit.stamp = read_stamp(stamp_path_for(unit.output_path));
+        std::string summary;
+        if (unit.stamp && unit.stamp->source_hash == unit.source_hash &&
+            read_source(interface_path_for(unit.output_path), summary) &&
+            fingerprint(summary) == unit.stamp->interface_hash) {
+            auto module = basicpp::frontend::read_interface(summary);
+            if (module) {
+                unit.module = std::move(module.value());
+                unit.interface_text = std::move(summary);
+                unit.interface_hash = unit.stamp->interface_hash;
+                return;
+            }
+        }
+    }
+
+    parse_unit(unit, recorder);
+}
+
+// A unit's cache key covers the tool version, the options that change generated code or its warnings, its
+// own source and the interface hashes of the modules it imports. Body-only edits leave a module's interface
+// unchanged and therefore do not rebuild importers. A reused unit reports the warnings recorded in its stamp.
+void emit_unit(module_unit& unit, const std::vector<module_unit>& units, const std::vector<std::size_t>& dependencies,
+               const transpile_options& options, phase_recorder& recorder) {
+    auto key = fingerprint(BASICPP_VERSION);
+    key = fingerprint_combine(key, options.minimize_states ? 1 : 0);
+    key = fingerprint_combine(key, options.check_states ? 1 : 0);
+    key = fingerprint_combine(key, unit.source_hash);
+    for (auto dep : dependencies) {
+        key = fingerprint_combine(key, units[dep].interface_hash);
+    }
+
+    if (options.use_cache && !unit.parsed && unit.stamp && unit.stamp->key == key) {
+        std::error_code ec;
+        if (std::filesystem::exists(unit.output_path, ec)) {
+            unit.up_to_date = true;
+            for (const auto& warning : unit.stamp->warnings) {
+                unit.warnings.push_back(unit.source_path.string() + ": warning: " + warning);
+            }
+            return;
+        }
+    }
+
+    if (!unit.parsed) {
+        // Only the summary was loaded, but an imported interface changed: regenerate from source.
+        parse_unit(unit, recorder);
+        if (!unit.error.empty()) {
+            return;
+        }
+    }
+
+    std::string cpp_source;
+    std::vector<basicpp::frontend::diagnostic> warnings;
+    auto generated = recorder.run("codegen", [&] {
+        basicpp::codegen::generate_options generate{};
+        generate.check_states = options.check_states;
+        generate.minimize_states = options.minimize_states;
+        return basicpp::codegen::generate_translation_unit(unit.module, cpp_source, generate, warnings);
+    });
+    if (!generated) {
+        unit.error = unit.source_path.string() + ": codegen error: " + generated.error();
+        return;
+    }
+    build_stamp stamp{unit.source_hash, unit.interface_hash, key, {}};
+    for (const auto& warning : warnings) {
+        unit.warnings.push_back(unit.source_path.string() + ": warning: " + warning.message);
+        stamp.warnings.push_back(warning.message);
+    }
+
+    auto written = write_text_file(unit.output_path, cpp_source);
+    if (!written) {
+        unit.error = written.error();
+        return;
+    }
+
+    written = write_text_file(interface_path_for(unit.output_path), unit.interface_text);
+    if (!written) {
+        unit.error = written.error();
+        return;
+    }
+
+    const auto stamp_path = stamp_path_for(unit.output_path);
+    if (!write_stamp(stamp_path, stamp)) {
+        unit.error = "failed to write " + stamp_path.string();
+    }
+}
+
 int dump_tokens(const std::vector<basicpp::frontend::token>& tokens) {
     for (const auto& tok : tokens) {
         std::cout << tok.line << ':' << tok.column << '\t' << basicpp::frontend::to_string(tok.kind);
@@ -108,65 +463,110 @@ int run_transpile(const std::vector<std::string>& params) {
         return 1;
     }
 
-    std::ifstream file(options.input_path, std::ios::binary);
-    if (!file) {
-        std::cerr << "failed to open " << options.input_path << '\n';
-        return 1;
-    }
-
-    std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-
-    auto tokens_result = basicpp::frontend::lexer::tokenize(source);
-    if (!tokens_result) {
-        std::cerr << "lexer error: " << tokens_result.error() << '\n';
-        return 1;
-    }
+    phase_recorder recorder(options.mem_stats);
 
     if (options.show_tokens) {
-        return dump_tokens(tokens_result.value());
-    }
+        std::string source;
+        if (!read_source(options.input_path, source)) {
+            std::cerr << "failed to open " << options.input_path << '\n';
+            return 1;
+        }
 
-    auto module = basicpp::frontend::parser::parse_module(tokens_result.value());
-    if (!module) {
-        std::cerr << "parser error: " << module.error() << '\n';
-        return 1;
-    }
+        auto tokens_result = recorder.run("lex", [&] {
+            return basicpp::frontend::lexer::tokenize(source);
+        });
+        if (!tokens_result) {
+            std::cerr << "lexer error: " << tokens_result.error() << '\n';
+            return 1;
+        }
 
-    auto generated = basicpp::codegen::generate_translation_unit(module.value());
-    if (!generated) {
-        std::cerr << "codegen error: " << generated.error() << '\n';
-        return 1;
+        const int status = dump_tokens(tokens_result.value());
+        recorder.report(std::cout);
+        return status;
     }
 
-    const auto& cpp_source = generated.value();
-    const auto output_path = resolve_output_path(options.input_path, options.output_path);
+    // Per-phase allocation counters are process-wide, so attribute them from a single thread.
+    const auto jobs = options.mem_stats ? 1 : (options.jobs == 0 ? default_job_count() : options.jobs);
+
+    std::vector<std::filesystem::path> search_paths;
+    search_paths.push_back(options.input_path.has_parent_path() ? options.input_path.parent_path()
+                                                                : std::filesystem::path("."));
+    search_paths.insert(search_paths.end(), options.import_paths.begin(), options.import_paths.end());
+
+    std::vector<module_unit> units;
+    module_graph graph;
+    std::map<std::filesystem::path, std::size_t> units_by_path;
+
+    module_unit root;
+    root.source_path = options.input_path;
+    root.output_path = resolve_output_path(options.input_path, options.output_path);
+    units_by_path.emplace(canonical_key(root.source_path), 0);
+    graph.add_node(root.source_path.filename().string());
+    units.push_back(std::move(root));
+
+    // Discover the import graph breadth-first, loading each wave of newly found modules in parallel.
+    std::vector<std::size_t> wave{0};
+    while (!wave.empty()) {
+        parallel_for(wave.size(), jobs, [&](std::size_t index) {
+            load_unit(units[wave[index]], options, recorder);
+        });
+
+        std::vector<std::size_t> next_wave;
+        for (auto node : wave) {
+            if (!units[node].error.empty()) {
+                std::cerr << units[node].error << '\n';
+                return 1;
+            }
 
-    if (output_path.has_parent_path()) {
-        std::error_code ec;
-        std::filesystem::create_directories(output_path.parent_path(), ec);
-        if (ec) {
-            std::cerr << "failed to create output directory: " << ec.message() << '\n';
-            return 1;
+            for (const auto& import : units[node].module.imports) {
+                auto resolved = resolve_import(import.path, search_paths);
+                if (!resolved) {
+                    // Unresolved imports refer to runtime headers and stay comments in the output.
+                    continue;
+                }
+
+                auto [slot, inserted] = units_by_path.emplace(canonical_key(*resolved), units.size());
+                if (inserted) {
+                    module_unit unit;
+                    unit.import_path = import.path;
+                    unit.source_path = *resolved;
+                    unit.output_path = resolve_dependency_output_path(unit, options.output_path);
+                    graph.add_node(import.path);
+                    units.push_back(std::move(unit));
+                    next_wave.push_back(slot->second);
+                }
+                graph.add_dependency(node, slot->second);
+            }
         }
+        wave = std::move(next_wave);
     }
 
-    std::ofstream output_file(output_path, std::ios::binary);
-    if (!output_file) {
-        std::cerr << "failed to write " << output_path.string() << '\n';
+    auto levels = graph.topological_levels();
+    if (!levels) {
+        std::cerr << levels.error() << '\n';
         return 1;
     }
 
-    output_file << cpp_source;
-    if (!cpp_source.empty() && cpp_source.back() != '\n') {
-        output_file << '\n';
-    }
-    output_file.close();
-    if (!output_file) {
-        std::cerr << "failed to write " << output_path.string() << '\n';
-        return 1;
+    for (const auto& level : levels.value()) {
+        parallel_for(level.size(), jobs, [&](std::size_t index) {
+            const auto node = level[index];
+            emit_unit(units[node], units, graph.dependencies(node), options, recorder);
+        });
+
+        for (auto node : level) {
+            const auto& unit = units[node];
+            for (const auto& warning : unit.warnings) {
+                std::cerr << warning << '\n';
+            }
+            if (!unit.error.empty()) {
+                std::cerr << unit.error << '\n';
+                return 1;
+            }
+            std::cout << (unit.up_to_date ? "Up to date " : "Generated ") << unit.output_path.string() << '\n';
+        }
     }
 
-    std::cout << "Generated " << output_path.string() << '\n';
+    recorder.report(std::cout);
     return 0;
 }
 
@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <cctype>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "frontend/token.hpp"
+#include "state_analysis.hpp"
+#include "state_hierarchy.hpp"
 
 namespace basicpp::codegen {
 
@@ -70,13 +72,12 @@ std::string escape_string(const std::string& value) {
     return escaped;
 }
 
-std::string render_constant_declaration(const frontend::ast::const_decl& decl, include_flags& flags) {
+std::string render_constant_declaration(const frontend::ast::const_decl& decl) {
     const auto variable_name = sanitize_identifier(decl.name);
     const auto& literal = decl.value;
 
     switch (literal.kind) {
     case frontend::token_kind::string_literal: {
-        flags.string_view_header = true;
         return "inline constexpr std::string_view " + variable_name + "{\"" + escape_string(literal.lexeme) + "\"};";
     }
     case frontend::token_kind::integer_literal:
@@ -89,16 +90,14 @@ std::string render_constant_declaration(const frontend::ast::const_decl& decl, i
     }
 }
 
-std::string convert_type_name(const std::string& type_name, include_flags& flags) {
+std::string convert_type_name(const std::string& type_name) {
     if (type_name == "Integer") {
-        flags.cstdint_header = true;
         return "std::int64_t";
     }
     if (type_name == "Float") {
         return "double";
     }
     if (type_name == "String") {
-        flags.string_header = true;
         return "std::string";
     }
     if (type_name == "Boolean") {
@@ -119,169 +118,243 @@ std::string convert_type_name(const std::string& type_name, include_flags& flags
     return converted;
 }
 
-std::string render_state_factory(const frontend::ast::state_decl& state, include_flags& flags) {
-    flags.string_header = true;
-    flags.state_machine_header = true;
-
-    const auto function_name = "make_" + sanitize_identifier(state.name) + "_state";
-    std::ostringstream out;
-    out << "inline basicpp::state::state_machine<std::string, std::string> " << function_name << "()\n";
-    out << "{\n";
-    out << "    basicpp::state::state_machine<std::string, std::string> machine{\"" << escape_string(state.initial_state)
-        << "\"};\n";
+void report_state_findings(const std::string& name, const flat_state_machine& flat,
+                           std::vector<frontend::diagnostic>& warnings) {
+    auto warn = [&](std::string message) {
+        warnings.push_back(frontend::diagnostic{frontend::diagnostic_severity::warning,
+                                                frontend::diagnostic_phase::codegen,
+                                                "state " + name + ": " + std::move(message)});
+    };
 
-    std::string current_state = state.initial_state;
-    for (const auto& transition : state.transitions) {
-        out << "    machine.add_transition(\"" << escape_string(current_state) << "\", \""
-            << escape_string(transition.event) << "\", \"" << escape_string(transition.target_state) << "\");\n";
-        current_state = transition.target_state;
+    const auto report = analyze_state(flat);
+    for (const auto& transition : report.overridden) {
+        warn("transition from '" + transition.from + "' on '" + transition.event + "' to '" + transition.to +
+             "' is overridden by a later one");
     }
-
-    out << "    return machine;\n";
-    out << "}\n";
-    return out.str();
-}
-
-std::string render_command(const frontend::ast::command_decl& command, include_flags& flags) {
-    flags.string_header = true;
-    flags.core_result_header = true;
-
-    const auto function_name = sanitize_identifier(command.name);
-    std::ostringstream out;
-    out << "inline basicpp::core::result<void, std::string> " << function_name << "(";
-
-    for (std::size_t i = 0; i < command.parameters.size(); ++i) {
-        if (i != 0) {
-            out << ", ";
+    for (const auto& state : report.unreachable) {
+        warn("'" + state + "' is unreachable from '" + flat.initial_state + "'");
+    }
+    for (const auto& members : report.equivalent) {
+        std::string list;
+        for (const auto& member : members) {
+            list += list.empty() ? "'" : ", '";
+            list += member;
+            list += '\'';
         }
-        out << "const std::string& " << sanitize_identifier(command.parameters[i]);
+        warn("states " + list + " are equivalent");
     }
+}
 
-    out << ")\n";
-    out << "{\n";
-
-    for (const auto& param : command.parameters) {
-        out << "    (void)" << sanitize_identifier(param) << ";\n";
+void render_state_factory(const std::string& name, const flat_state_machine& flat, std::string& out) {
+    const auto function_name = "make_" + sanitize_identifier(name) + "_state";
+    out += "inline basicpp::state::state_machine<std::string, std::string> ";
+    out += function_name;
+    out += "()\n";
+    out += "{\n";
+    out += "    basicpp::state::state_machine<std::string, std::string> machine{\"";
+    out += escape_string(flat.initial_state);
+    out += "\"};\n";
+
+    for (const auto& transition : flat.transitions) {
+        out += "    machine.add_transition(\"";
+        out += escape_string(transition.from);
+        out += "\", \"";
+        out += escape_string(transition.event);
+        out += "\", \"";
+        out += escape_string(transition.to);
+        out += "\");\n";
     }
 
-    out << "    // TODO: Translate Basic++ command body into C++\n";
-    out << "    return basicpp::core::result<void, std::string>::ok();\n";
-    out << "}\n";
-
-    return out.str();
+    out += "    return machine;\n";
+    out += "}\n";
 }
 
-std::string render_function(const frontend::ast::function_decl& fn, include_flags& flags) {
-    flags.string_header = true; // parameters use std::string
-
-    const auto function_name = sanitize_identifier(fn.name);
-    const bool has_return_type = fn.return_type.has_value();
-    const std::string return_type = has_return_type ? convert_type_name(fn.return_type.value(), flags) : "void";
-
-    std::ostringstream out;
-    out << "inline " << return_type << ' ' << function_name << '(';
-
-    for (std::size_t i = 0; i < fn.parameters.size(); ++i) {
+void render_parameters(const std::vector<std::string>& parameters, std::string& out) {
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
         if (i != 0) {
-            out << ", ";
+            out += ", ";
         }
-        out << "const std::string& " << sanitize_identifier(fn.parameters[i]);
+        out += "const std::string& ";
+        out += sanitize_identifier(parameters[i]);
     }
+}
 
-    out << ")\n";
-    out << "{\n";
-
-    for (const auto& param : fn.parameters) {
-        out << "    (void)" << sanitize_identifier(param) << ";\n";
+void render_unused_parameters(const std::vector<std::string>& parameters, std::string& out) {
+    for (const auto& param : parameters) {
+        out += "    (void)";
+        out += sanitize_identifier(param);
+        out += ";\n";
     }
+}
+
+void render_command(const frontend::ast::command_decl& command, std::string& out) {
+    out += "inline basicpp::core::result<void, std::string> ";
+    out += sanitize_identifier(command.name);
+    out += '(';
+    render_parameters(command.parameters, out);
+    out += ")\n";
+    out += "{\n";
+    render_unused_parameters(command.parameters, out);
+    out += "    // TODO: Translate Basic++ command body into C++\n";
+    out += "    return basicpp::core::result<void, std::string>::ok();\n";
+    out += "}\n";
+}
 
-    out << "    // TODO: Translate Basic++ function body into C++\n";
+void render_function(const frontend::ast::function_decl& fn, std::string& out) {
+    const bool has_return_type = fn.return_type.has_value();
+    const std::string return_type = has_return_type ? convert_type_name(fn.return_type.value()) : "void";
+
+    out += "inline ";
+    out += return_type;
+    out += ' ';
+    out += sanitize_identifier(fn.name);
+    out += '(';
+    render_parameters(fn.parameters, out);
+    out += ")\n";
+    out += "{\n";
+    render_unused_parameters(fn.parameters, out);
+    out += "    // TODO: Translate Basic++ function body into C++\n";
     if (has_return_type) {
-        out << "    return {};\n";
+        out += "    return {};\n";
     } else {
-        out << "    return;\n";
+        out += "    return;\n";
     }
-
-    out << "}\n";
-
-    return out.str();
+    out += "}\n";
 }
 
-} // namespace
-
-core::result<std::string, std::string> generate_translation_unit(const frontend::ast::module_decl& module) {
+// The headers the rendered declarations need, worked out before rendering so the header block can be
+// written first and the declarations appended after it.
+include_flags required_headers(const frontend::ast::module_decl& module) {
     include_flags flags{};
-
-    std::ostringstream constants_section;
     for (const auto& constant : module.constants) {
-        constants_section << render_constant_declaration(constant, flags) << "\n";
-    }
-
-    if (!module.constants.empty()) {
-        constants_section << '\n';
+        if (constant.value.kind == frontend::token_kind::string_literal) {
+            flags.string_view_header = true;
+        }
     }
-
-    std::ostringstream states_section;
-    for (const auto& state : module.states) {
-        states_section << render_state_factory(state, flags) << '\n';
+    if (!module.states.empty()) {
+        flags.string_header = true;
+        flags.state_machine_header = true;
     }
-
-    std::ostringstream commands_section;
-    for (const auto& command : module.commands) {
-        commands_section << render_command(command, flags) << '\n';
+    if (!module.commands.empty()) {
+        flags.string_header = true;
+        flags.core_result_header = true;
     }
-
-    std::ostringstream functions_section;
     for (const auto& fn : module.functions) {
-        functions_section << render_function(fn, flags) << '\n';
+        flags.string_header = true; // parameters use std::string
+        if (fn.return_type && *fn.return_type == "Integer") {
+            flags.cstdint_header = true;
+        }
     }
+    return flags;
+}
 
-    std::ostringstream out;
-    out << "// Generated by bppc 0.0.1\n";
-    out << "// Module: " << module.name << "\n\n";
+void render_header(const frontend::ast::module_decl& module, const include_flags& flags,
+                   const std::string& module_namespace, std::string& out) {
+    out += "// Generated by bppc 0.0.1\n";
+    out += "// Module: ";
+    out += module.name;
+    out += "\n\n";
 
     if (flags.string_header) {
-        out << "#include <string>\n";
+        out += "#include <string>\n";
     }
     if (flags.string_view_header) {
-        out << "#include <string_view>\n";
+        out += "#include <string_view>\n";
     }
     if (flags.cstdint_header) {
-        out << "#include <cstdint>\n";
+        out += "#include <cstdint>\n";
     }
     if (flags.stdexcept_header) {
-        out << "#include <stdexcept>\n";
+        out += "#include <stdexcept>\n";
     }
     if (flags.core_result_header) {
-        out << "#include <basicpp/core/result.hpp>\n";
+        out += "#include <basicpp/core/result.hpp>\n";
     }
     if (flags.state_machine_header) {
-        out << "#include <basicpp/state/state_machine.hpp>\n";
+        out += "#include <basicpp/state/state_machine.hpp>\n";
     }
 
     if (!module.imports.empty()) {
-        out << '\n';
-        out << "// Basic++ imports\n";
+        out += '\n';
+        out += "// Basic++ imports\n";
         for (const auto& import : module.imports) {
-            out << "//   - " << import.path << "\n";
+            out += "//   - ";
+            out += import.path;
+            out += "\n";
         }
     }
 
-    out << '\n';
+    out += '\n';
+    out += "namespace basicpp_generated {\n";
+    out += "namespace ";
+    out += module_namespace;
+    out += " {\n\n";
+}
+
+} // namespace
+
+core::result<std::string, std::string> generate_translation_unit(const frontend::ast::module_decl& module) {
+    std::string out;
+    auto status = generate_translation_unit(module, out);
+    if (!status) {
+        return core::result<std::string, std::string>::err(std::move(status).error());
+    }
+    return core::result<std::string, std::string>::ok(std::move(out));
+}
+
+core::result<void, std::string> generate_translation_unit(const frontend::ast::module_decl& module, std::string& out) {
+    std::vector<frontend::diagnostic> warnings;
+    return generate_translation_unit(module, out, generate_options{}, warnings);
+}
 
+core::result<void, std::string> generate_translation_unit(const frontend::ast::module_decl& module, std::string& out,
+                                                          const generate_options& options,
+                                                          std::vector<frontend::diagnostic>& warnings) {
     const auto module_namespace = sanitize_identifier(module.name);
-    out << "namespace basicpp_generated {\n";
-    out << "namespace " << module_namespace << " {\n\n";
+    out.clear();
+    render_header(module, required_headers(module), module_namespace, out);
 
-    out << constants_section.str();
-    out << states_section.str();
-    out << commands_section.str();
-    out << functions_section.str();
+    for (const auto& constant : module.constants) {
+        try {
+            out += render_constant_declaration(constant);
+        } catch (const std::logic_error& ex) {
+            return core::result<void, std::string>::err(ex.what());
+        }
+        out += '\n';
+    }
+
+    if (!module.constants.empty()) {
+        out += '\n';
+    }
+
+    for (const auto& state : module.states) {
+        auto flat = flatten_state(state);
+        if (options.check_states) {
+            report_state_findings(state.name, flat, warnings);
+        }
+        if (options.minimize_states) {
+            flat = minimize_state(flat);
+        }
+        render_state_factory(state.name, flat, out);
+        out += '\n';
+    }
+
+    for (const auto& command : module.commands) {
+        render_command(command, out);
+        out += '\n';
+    }
+
+    for (const auto& fn : module.functions) {
+        render_function(fn, out);
+        out += '\n';
+    }
 
-    out << "} // namespace " << module_namespace << "\n";
-    out << "} // namespace basicpp_generated\n";
+    out += "} // namespace ";
+    out += module_namespace;
+    out += "\n";
+    out += "} // namespace basicpp_generated\n";
 
-    return core::result<std::string, std::string>::ok(out.str());
+    return core::result<void, std::string>::ok();
 }
 
 } // namespace basicpp::codegen
@@ -1,13 +1,30 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include <basicpp/core/result.hpp>
 
 #include "frontend/ast.hpp"
+#include "frontend/diagnostic.hpp"
 
 namespace basicpp::codegen {
 
 core::result<std::string, std::string> generate_translation_unit(const frontend::ast::module_decl& module);
 
+// Writes the translation unit into `out`, replacing its contents but keeping its capacity for reuse.
+core::result<void, std::string> generate_translation_unit(const frontend::ast::module_decl& module, std::string& out);
+
+struct generate_options {
+    // Report unreachable states, overridden transitions and equivalent states of each state machine.
+    bool check_states = false;
+    // Emit each state machine minimised (see minimize_state); merged states disappear from the output.
+    bool minimize_states = false;
+};
+
+// As above; state machine findings are appended to `warnings` as codegen warnings.
+core::result<void, std::string> generate_translation_unit(const frontend::ast::module_decl& module, std::string& out,
+                                                          const generate_options& options,
+                                                          std::vector<frontend::diagnostic>& warnings);
+
 } // namespace basicpp::codegen
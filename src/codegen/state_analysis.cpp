@@ -0,0 +1,309 @@
+#include "state_analysis.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace basicpp::codegen {
+
+namespace {
+
+constexpr std::size_t no_state = std::numeric_limits<std::size_t>::max();
+
+// The flattened machine as a dense table over state and event indices (both in order of first mention).
+struct indexed_machine {
+    std::vector<std::string_view> events;
+    std::vector<std::size_t> next; // states x events, no_state where there is no transition
+    std::vector<std::size_t> overridden;
+    std::vector<std::size_t> reachable; // state indices in breadth-first order from the initial state
+    std::size_t initial = 0;
+};
+
+indexed_machine index_machine(const flat_state_machine& machine) {
+    indexed_machine indexed;
+
+    std::unordered_map<std::string_view, std::size_t> state_index;
+    state_index.reserve(machine.states.size());
+    for (const auto& state : machine.states) {
+        state_index.emplace(state, state_index.size());
+    }
+    std::unordered_map<std::string_view, std::size_t> event_index;
+    for (const auto& transition : machine.transitions) {
+        if (event_index.emplace(transition.event, indexed.events.size()).second) {
+            indexed.events.push_back(transition.event);
+        }
+    }
+
+    const auto events = indexed.events.size();
+    indexed.next.assign(machine.states.size() * events, no_state);
+    // Walk backwards so the transition that wins is seen first and every earlier one is reported as overridden.
+    for (std::size_t i = machine.transitions.size(); i-- > 0;) {
+        const auto& transition = machine.transitions[i];
+        auto& cell = indexed.next[state_index.at(transition.from) * events + event_index.at(transition.event)];
+        if (cell == no_state) {
+            cell = state_index.at(transition.to);
+        } else {
+            indexed.overridden.push_back(i);
+        }
+    }
+
+    indexed.initial = state_index.at(machine.initial_state);
+    std::vector<char> seen(machine.states.size(), 0);
+    seen[indexed.initial] = 1;
+    indexed.reachable.push_back(indexed.initial);
+    for (std::size_t head = 0; head < indexed.reachable.size(); ++head) {
+        const auto from = indexed.reachable[head];
+        for (std::size_t event = 0; event < events; ++event) {
+            const auto to = indexed.next[from * events + event];
+            if (to != no_state && !seen[to]) {
+                seen[to] = 1;
+                indexed.reachable.push_back(to);
+            }
+        }
+    }
+    return indexed;
+}
+
+// Hopcroft's partition refinement over the reachable states, with an extra sink standing for "no transition"
+// so the table is complete. Terminal states (no transition leads to another state) start in blocks of their
+// own: the machine settles there and current_state() reports the name as the outcome, so two of them are
+// never equivalent. Blocks are contiguous ranges of `order`; a split moves the marked states to the front
+// of their range and turns them into a new block. Returns the block of each state (no_state if
+// unreachable).
+std::vector<std::size_t> equivalence_blocks(const indexed_machine& machine, std::size_t state_count) {
+    const auto events = machine.events.size();
+    const auto members = machine.reachable.size();
+    const auto sink = members;
+    const auto total = members + 1;
+
+    std::vector<std::size_t> compact(state_count, no_state);
+    for (std::size_t i = 0; i < members; ++i) {
+        compact[machine.reachable[i]] = i;
+    }
+    auto target_of = [&](std::size_t state, std::size_t event) {
+        if (state == sink) {
+            return sink;
+        }
+        const auto to = machine.next[machine.reachable[state] * events + event];
+        return to == no_state ? sink : compact[to];
+    };
+
+    // Preimages in compressed rows: the states reaching `target` on `event` are
+    // sources[offsets[target * events + event] .. offsets[target * events + event + 1]).
+    std::vector<std::size_t> offsets(total * events + 1, 0);
+    for (std::size_t state = 0; state < total; ++state) {
+        for (std::size_t event = 0; event < events; ++event) {
+            ++offsets[target_of(state, event) * events + event + 1];
+        }
+    }
+    for (std::size_t i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+    }
+    std::vector<std::size_t> sources(total * events);
+    {
+        auto fill = offsets;
+        for (std::size_t state = 0; state < total; ++state) {
+            for (std::size_t event = 0; event < events; ++event) {
+                sources[fill[target_of(state, event) * events + event]++] = state;
+            }
+        }
+    }
+
+    auto terminal = [&](std::size_t state) {
+        for (std::size_t event = 0; event < events; ++event) {
+            const auto to = target_of(state, event);
+            if (to != sink && to != state) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Non-terminal states first, then each terminal state, then the sink.
+    std::vector<std::size_t> order;
+    order.reserve(total);
+    for (std::size_t state = 0; state < members; ++state) {
+        if (!terminal(state)) {
+            order.push_back(state);
+        }
+    }
+    const auto open = order.size();
+    for (std::size_t state = 0; state < members; ++state) {
+        if (terminal(state)) {
+            order.push_back(state);
+        }
+    }
+    order.push_back(sink);
+    std::vector<std::size_t> position(total);
+    for (std::size_t i = 0; i < total; ++i) {
+        position[order[i]] = i;
+    }
+
+    std::vector<std::size_t> block_of(total, 0);
+    std::vector<std::size_t> first;
+    std::vector<std::size_t> last;
+    std::vector<std::size_t> marked;
+    auto add_block = [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            block_of[order[i]] = first.size();
+        }
+        first.push_back(begin);
+        last.push_back(end);
+        marked.push_back(0);
+    };
+    if (open != 0) {
+        add_block(0, open);
+    }
+    for (auto i = open; i < total; ++i) {
+        add_block(i, i + 1);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> pending;
+    std::vector<char> queued(total * events, 0);
+    auto enqueue = [&](std::size_t block, std::size_t event) {
+        if (!queued[block * events + event]) {
+            queued[block * events + event] = 1;
+            pending.emplace_back(block, event);
+        }
+    };
+    // Splitting by every block but one is enough: the union of all blocks splits nothing.
+    for (std::size_t block = 1; block < first.size(); ++block) {
+        for (std::size_t event = 0; event < events; ++event) {
+            enqueue(block, event);
+        }
+    }
+
+    std::vector<std::size_t> splitter;
+    std::vector<std::size_t> touched;
+    while (!pending.empty()) {
+        const auto [block, event] = pending.back();
+        pending.pop_back();
+        queued[block * events + event] = 0;
+
+        // Collect first: marking reorders ranges, including the splitter's own.
+        splitter.clear();
+        for (auto i = first[block]; i < last[block]; ++i) {
+            const auto target = order[i];
+            for (auto j = offsets[target * events + event]; j < offsets[target * events + event + 1]; ++j) {
+                splitter.push_back(sources[j]);
+            }
+        }
+
+        touched.clear();
+        for (const auto state : splitter) {
+            const auto owner = block_of[state];
+            const auto boundary = first[owner] + marked[owner];
+            if (position[state] < boundary) {
+                continue; // already marked
+            }
+            const auto displaced = order[boundary];
+            std::swap(order[position[state]], order[boundary]);
+            position[displaced] = position[state];
+            position[state] = boundary;
+            if (marked[owner]++ == 0) {
+                touched.push_back(owner);
+            }
+        }
+
+        for (const auto split : touched) {
+            const auto count = marked[split];
+            marked[split] = 0;
+            if (count == last[split] - first[split]) {
+                continue;
+            }
+            const auto created = first.size();
+            first.push_back(first[split]);
+            last.push_back(first[split] + count);
+            marked.push_back(0);
+            first[split] += count;
+            for (auto i = first[created]; i < last[created]; ++i) {
+                block_of[order[i]] = created;
+            }
+
+            const auto created_size = count;
+            const auto remaining_size = last[split] - first[split];
+            for (std::size_t c = 0; c < events; ++c) {
+                if (queued[split * events + c] || created_size <= remaining_size) {
+                    enqueue(created, c);
+                } else {
+                    enqueue(split, c);
+                }
+            }
+        }
+    }
+
+    std::vector<std::size_t> result(state_count, no_state);
+    for (std::size_t i = 0; i < members; ++i) {
+        result[machine.reachable[i]] = block_of[i];
+    }
+    return result;
+}
+
+} // namespace
+
+state_report analyze_state(const flat_state_machine& machine) {
+    const auto indexed = index_machine(machine);
+    const auto blocks = equivalence_blocks(indexed, machine.states.size());
+
+    state_report report;
+    for (auto i = indexed.overridden.rbegin(); i != indexed.overridden.rend(); ++i) {
+        report.overridden.push_back(machine.transitions[*i]);
+    }
+
+    std::unordered_map<std::size_t, std::size_t> class_of_block;
+    std::vector<std::vector<std::string>> classes;
+    for (std::size_t state = 0; state < machine.states.size(); ++state) {
+        if (blocks[state] == no_state) {
+            report.unreachable.push_back(machine.states[state]);
+            continue;
+        }
+        const auto [slot, inserted] = class_of_block.emplace(blocks[state], classes.size());
+        if (inserted) {
+            classes.emplace_back();
+        }
+        classes[slot->second].push_back(machine.states[state]);
+    }
+    for (auto& members : classes) {
+        if (members.size() > 1) {
+            report.equivalent.push_back(std::move(members));
+        }
+    }
+    return report;
+}
+
+flat_state_machine minimize_state(const flat_state_machine& machine) {
+    const auto indexed = index_machine(machine);
+    const auto blocks = equivalence_blocks(indexed, machine.states.size());
+    const auto events = indexed.events.size();
+
+    // Each block is represented by its first state in declaration order, except the initial state's block.
+    std::unordered_map<std::size_t, std::size_t> representative;
+    representative.emplace(blocks[indexed.initial], indexed.initial);
+    for (std::size_t state = 0; state < machine.states.size(); ++state) {
+        if (blocks[state] != no_state) {
+            representative.emplace(blocks[state], state);
+        }
+    }
+
+    flat_state_machine minimal;
+    minimal.initial_state = machine.initial_state;
+    for (std::size_t state = 0; state < machine.states.size(); ++state) {
+        if (blocks[state] == no_state || representative.at(blocks[state]) != state) {
+            continue;
+        }
+        minimal.states.push_back(machine.states[state]);
+        for (std::size_t event = 0; event < events; ++event) {
+            const auto to = indexed.next[state * events + event];
+            if (to != no_state) {
+                minimal.transitions.push_back(flat_transition{machine.states[state], std::string(indexed.events[event]),
+                                                              machine.states[representative.at(blocks[to])]});
+            }
+        }
+    }
+    return minimal;
+}
+
+} // namespace basicpp::codegen
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "state_hierarchy.hpp"
+
+namespace basicpp::codegen {
+
+// Findings about one flattened state machine. Missing transitions count as behaviour: two states are only
+// equivalent when they reject the same events and agree, class for class, on the targets of the rest.
+// Terminal states (nothing leads out of them) are told apart by name, since that is the outcome a caller
+// reads from current_state(), so they are never equivalent to each other.
+struct state_report {
+    // Leaf states that no sequence of events reaches from the initial state.
+    std::vector<std::string> unreachable;
+    // Transitions replaced by a later one with the same source and event (add_transition keeps the last).
+    std::vector<flat_transition> overridden;
+    // Classes of two or more reachable states that no event sequence can tell apart, in declaration order.
+    std::vector<std::vector<std::string>> equivalent;
+};
+
+state_report analyze_state(const flat_state_machine& machine);
+
+// The smallest machine with the same behaviour from the initial state (Hopcroft's algorithm): unreachable
+// states are dropped, every equivalence class is merged into its first state (the initial state keeps its
+// name) and each (state, event) pair has exactly one transition. Merged state names no longer appear.
+flat_state_machine minimize_state(const flat_state_machine& machine);
+
+} // namespace basicpp::codegen
@@ -0,0 +1,146 @@
+#include "state_hierarchy.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace basicpp::codegen {
+
+namespace {
+
+class hierarchy {
+public:
+    explicit hierarchy(const frontend::ast::state_decl& state) {
+        for (const auto& group : state.groups) {
+            auto& children = children_[group.parent];
+            for (const auto& child : group.children) {
+                parents_.emplace(child, group.parent);
+                children.push_back(child);
+            }
+        }
+    }
+
+    const std::string* parent(const std::string& state) const {
+        const auto found = parents_.find(state);
+        return found == parents_.end() ? nullptr : &found->second;
+    }
+
+    // The parser guarantees a tree, so descending through first children terminates.
+    const std::string& leaf(const std::string& state) const {
+        const std::string* current = &state;
+        for (auto found = children_.find(*current); found != children_.end(); found = children_.find(*current)) {
+            current = &found->second.front();
+        }
+        return *current;
+    }
+
+    void append_leaves(const std::string& state, std::vector<const std::string*>& out) const {
+        const auto found = children_.find(state);
+        if (found == children_.end()) {
+            out.push_back(&state);
+            return;
+        }
+        for (const auto& child : found->second) {
+            append_leaves(child, out);
+        }
+    }
+
+private:
+    std::unordered_map<std::string, std::string> parents_;
+    std::unordered_map<std::string, std::vector<std::string>> children_;
+};
+
+// (source state, event) of a declared transition.
+using transition_key = std::pair<std::string_view, std::string_view>;
+
+struct transition_key_hash {
+    std::size_t operator()(const transition_key& key) const noexcept {
+        const auto source = std::hash<std::string_view>{}(key.first);
+        const auto event = std::hash<std::string_view>{}(key.second);
+        return source ^ (event + 0x9e3779b97f4a7c15ULL + (source << 6) + (source >> 2));
+    }
+};
+
+} // namespace
+
+flat_state_machine flatten_state(const frontend::ast::state_decl& state) {
+    const hierarchy tree{state};
+
+    // Resolve the source of each declared transition first: chained transitions leave the leaf the previous
+    // one entered, explicit ones leave the named state.
+    struct declared {
+        const std::string* source;
+        const frontend::ast::state_transition* transition;
+    };
+    std::vector<declared> declarations;
+    declarations.reserve(state.transitions.size());
+    const std::string* cursor = &tree.leaf(state.initial_state);
+    for (const auto& transition : state.transitions) {
+        if (transition.source_state) {
+            declarations.push_back({&*transition.source_state, &transition});
+        } else {
+            declarations.push_back({cursor, &transition});
+            cursor = &tree.leaf(transition.target_state);
+        }
+    }
+
+    std::unordered_set<transition_key, transition_key_hash> declared_keys;
+    declared_keys.reserve(declarations.size());
+    for (const auto& declaration : declarations) {
+        declared_keys.emplace(*declaration.source, declaration.transition->event);
+    }
+    auto declares = [&](const std::string& source, const std::string& event) {
+        return declared_keys.contains(transition_key{source, event});
+    };
+
+    flat_state_machine flat{};
+    flat.initial_state = tree.leaf(state.initial_state);
+    flat.transitions.reserve(declarations.size());
+
+    std::unordered_set<std::string_view> seen;
+    auto add_state = [&](const std::string& name) {
+        if (seen.insert(name).second) {
+            flat.states.push_back(name);
+        }
+    };
+    add_state(flat.initial_state);
+    std::vector<const std::string*> leaves;
+    for (const auto& group : state.groups) {
+        leaves.clear();
+        tree.append_leaves(group.parent, leaves);
+        for (const auto* leaf : leaves) {
+            add_state(*leaf);
+        }
+    }
+    for (const auto& declaration : declarations) {
+        const auto& event = declaration.transition->event;
+        const auto& target = tree.leaf(declaration.transition->target_state);
+
+        leaves.clear();
+        tree.append_leaves(*declaration.source, leaves);
+        for (const auto* leaf : leaves) {
+            // A leaf inherits this transition only if nothing between it and the declaring state overrides it.
+            const std::string* owner = leaf;
+            while (*owner != *declaration.source && !declares(*owner, event)) {
+                owner = tree.parent(*owner);
+            }
+            if (*owner == *declaration.source) {
+                flat.transitions.push_back({*leaf, event, target});
+            }
+        }
+    }
+
+    for (const auto& transition : flat.transitions) {
+        add_state(transition.from);
+        add_state(transition.to);
+    }
+
+    return flat;
+}
+
+} // namespace basicpp::codegen
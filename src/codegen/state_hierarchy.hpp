@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "frontend/ast.hpp"
+
+namespace basicpp::codegen {
+
+struct flat_transition {
+    std::string from;
+    std::string event;
+    std::string to;
+};
+
+// A state declaration with its hierarchy resolved away: every transition leaves and enters a leaf state.
+struct flat_state_machine {
+    std::string initial_state;
+    // Leaf states in order of first mention, starting with the initial state.
+    std::vector<std::string> states;
+    std::vector<flat_transition> transitions;
+};
+
+// Copies transitions declared on a parent state to each descendant without a transition of its own for that
+// event, and replaces composite targets by their initial leaf. Transitions keep declaration order, so for a
+// declaration without `in` groups the result is exactly the chain as written.
+flat_state_machine flatten_state(const frontend::ast::state_decl& state);
+
+} // namespace basicpp::codegen
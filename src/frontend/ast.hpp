@@ -18,15 +18,25 @@ struct const_decl {
     literal value;
 };
 
+// `on Event => Target` leaves the state the previous transition entered; `on Event in Source => Target`
+// names its source explicitly and does not move that chain.
 struct state_transition {
     std::string event;
     std::string target_state;
+    std::optional<std::string> source_state;
+};
+
+// `in Parent: Child1, Child2`; the first child is the state entered when a transition targets the parent.
+struct state_group {
+    std::string parent;
+    std::vector<std::string> children;
 };
 
 struct state_decl {
     std::string name;
     std::string initial_state;
     std::vector<state_transition> transitions;
+    std::vector<state_group> groups;
 };
 
 struct command_decl {
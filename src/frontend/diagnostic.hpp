@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace basicpp::frontend {
+
+enum class diagnostic_phase {
+    lexer,
+    parser,
+    codegen,
+};
+
+enum class diagnostic_severity {
+    error,
+    warning,
+};
+
+// Structured compiler message; line/column are 1-based and 0 when no source position applies.
+struct diagnostic {
+    diagnostic_severity severity = diagnostic_severity::error;
+    diagnostic_phase phase = diagnostic_phase::lexer;
+    std::string message;
+    std::size_t line = 0;
+    std::size_t column = 0;
+};
+
+inline std::string_view to_string(diagnostic_phase phase) {
+    switch (phase) {
+    case diagnostic_phase::lexer: return "lexer";
+    case diagnostic_phase::parser: return "parser";
+    case diagnostic_phase::codegen: return "codegen";
+    }
+    return "unknown";
+}
+
+inline std::string_view to_string(diagnostic_severity severity) {
+    switch (severity) {
+    case diagnostic_severity::error: return "error";
+    case diagnostic_severity::warning: return "warning";
+    }
+    return "unknown";
+}
+
+} // namespace basicpp::frontend
@@ -0,0 +1,127 @@
+#include "interface.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "lexer.hpp"
+#include "parser.hpp"
+
+namespace basicpp::frontend {
+
+namespace {
+
+constexpr std::string_view interface_header = "// bppi 1";
+
+void append_unique(std::vector<std::string>& values, const std::string& value) {
+    if (std::find(values.begin(), values.end(), value) == values.end()) {
+        values.push_back(value);
+    }
+}
+
+void append_list(std::string& out, const std::vector<std::string>& values) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i != 0) {
+            out += ", ";
+        }
+        out += values[i];
+    }
+}
+
+void append_literal(std::string& out, const ast::literal& literal) {
+    if (literal.kind == token_kind::string_literal) {
+        out.push_back('"');
+        out += literal.lexeme;
+        out.push_back('"');
+        return;
+    }
+    out += literal.lexeme;
+}
+
+} // namespace
+
+std::string write_interface(const ast::module_decl& module) {
+    std::string out;
+    out += interface_header;
+    out += '\n';
+    out += "module " + module.name + '\n';
+
+    for (const auto& import : module.imports) {
+        out += "import " + import.path + '\n';
+    }
+
+    for (const auto& constant : module.constants) {
+        out += "const " + constant.name + " = ";
+        append_literal(out, constant.value);
+        out += '\n';
+    }
+
+    for (const auto& state : module.states) {
+        std::vector<std::string> states{state.initial_state};
+        std::vector<std::string> events;
+        for (const auto& group : state.groups) {
+            append_unique(states, group.parent);
+            for (const auto& child : group.children) {
+                append_unique(states, child);
+            }
+        }
+        for (const auto& transition : state.transitions) {
+            append_unique(states, transition.target_state);
+            append_unique(events, transition.event);
+        }
+
+        out += "// states: ";
+        append_list(out, states);
+        out += "\n// events: ";
+        append_list(out, events);
+        out += '\n';
+
+        out += "state " + state.name + " = " + state.initial_state + '\n';
+        for (const auto& group : state.groups) {
+            out += "in " + group.parent + ": ";
+            append_list(out, group.children);
+            out += '\n';
+        }
+        for (const auto& transition : state.transitions) {
+            out += "on " + transition.event;
+            if (transition.source_state) {
+                out += " in " + *transition.source_state;
+            }
+            out += " => " + transition.target_state + '\n';
+        }
+    }
+
+    for (const auto& command : module.commands) {
+        out += "command " + command.name + '(';
+        append_list(out, command.parameters);
+        out += ")\nend command\n";
+    }
+
+    for (const auto& fn : module.functions) {
+        out += "function " + fn.name + '(';
+        append_list(out, fn.parameters);
+        out += ')';
+        if (fn.return_type) {
+            out += " as " + *fn.return_type;
+        }
+        out += "\nend function\n";
+    }
+
+    return out;
+}
+
+core::result<ast::module_decl, std::string> read_interface(std::string_view text) {
+    using interface_result = core::result<ast::module_decl, std::string>;
+
+    if (text.substr(0, interface_header.size()) != interface_header) {
+        return interface_result::err("not a bppi interface summary");
+    }
+
+    auto tokens = lexer::tokenize(text);
+    if (!tokens) {
+        return interface_result::err(tokens.error());
+    }
+
+    return parser::parse_module(tokens.value());
+}
+
+} // namespace basicpp::frontend
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <basicpp/core/result.hpp>
+
+#include "ast.hpp"
+
+namespace basicpp::frontend {
+
+// Interface summaries (.bppi) describe what a module exports without its command/function bodies:
+// imports, constants, state machines with their states and events, and command/function signatures.
+// The summary is written as body-free Basic++ so reading it back reuses the regular lexer and parser.
+std::string write_interface(const ast::module_decl& module);
+
+core::result<ast::module_decl, std::string> read_interface(std::string_view text);
+
+} // namespace basicpp::frontend
@@ -95,8 +95,22 @@ std::optional<token_kind> keyword_lookup(std::string_view lexeme) {
 
 core::result<std::vector<token>, std::string> lexer::tokenize(std::string_view source) {
     std::vector<token> tokens;
+    auto status = tokenize(source, tokens);
+    if (!status) {
+        return core::result<std::vector<token>, std::string>::err(std::move(status).error().message);
+    }
+    return core::result<std::vector<token>, std::string>::ok(std::move(tokens));
+}
+
+core::result<void, diagnostic> lexer::tokenize(std::string_view source, std::vector<token>& tokens) {
+    tokens.clear();
     cursor cur{source};
 
+    auto fail = [](const char* message, std::size_t line, std::size_t column) {
+        return core::result<void, diagnostic>::err(
+            diagnostic{diagnostic_severity::error, diagnostic_phase::lexer, message, line, column});
+    };
+
     auto make_token = [&](token_kind kind, std::string lexeme, std::size_t line, std::size_t column) {
         return token{kind, std::move(lexeme), line, column};
     };
@@ -215,7 +229,7 @@ core::result<std::vector<token>, std::string> lexer::tokenize(std::string_view s
                 cur.advance();
             }
             if (cur.at_end()) {
-                return core::result<std::vector<token>, std::string>::err("unterminated string literal");
+                return fail("unterminated string literal", token_start_line, token_start_column);
             }
             cur.advance(); // closing quote
             std::string lexeme(source.substr(token_start_index + 1, cur.index - token_start_index - 2));
@@ -249,14 +263,14 @@ core::result<std::vector<token>, std::string> lexer::tokenize(std::string_view s
                     tokens.push_back(make_token(token_kind::identifier, std::move(lexeme), token_start_line, token_start_column));
                 }
             } else {
-                return core::result<std::vector<token>, std::string>::err("unexpected character");
+                return fail("unexpected character", token_start_line, token_start_column);
             }
             break;
         }
     }
 
     tokens.push_back(token{token_kind::end_of_file, "", cur.line, cur.column});
-    return core::result<std::vector<token>, std::string>::ok(std::move(tokens));
+    return core::result<void, diagnostic>::ok();
 }
 
 } // namespace basicpp::frontend
@@ -7,6 +7,7 @@
 
 #include <basicpp/core/result.hpp>
 
+#include "diagnostic.hpp"
 #include "token.hpp"
 
 namespace basicpp::frontend {
@@ -14,6 +15,9 @@ namespace basicpp::frontend {
 class lexer {
 public:
     static core::result<std::vector<token>, std::string> tokenize(std::string_view source);
+
+    // Tokenizes into a caller-owned vector, reusing its capacity; errors carry the offending position.
+    static core::result<void, diagnostic> tokenize(std::string_view source, std::vector<token>& tokens);
 };
 
 } // namespace basicpp::frontend
@@ -1,6 +1,8 @@
 #include "parser.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -14,20 +16,25 @@ public:
         : tokens_(tokens) {
     }
 
-    core::result<ast::module_decl, std::string> parse_module() {
-        ast::module_decl module;
+    core::result<void, std::string> parse_module(ast::module_decl& module) {
+        module.name.clear();
+        module.imports.clear();
+        module.constants.clear();
+        module.states.clear();
+        module.commands.clear();
+        module.functions.clear();
 
         if (match(token_kind::end_of_file)) {
-            return core::result<ast::module_decl, std::string>::err("empty input");
+            return core::result<void, std::string>::err("empty input");
         }
 
         if (!match(token_kind::keyword_module)) {
-            return core::result<ast::module_decl, std::string>::err("expected 'module' keyword");
+            return core::result<void, std::string>::err("expected 'module' keyword");
         }
 
         auto name_token = consume(token_kind::identifier, "expected module name");
         if (!name_token) {
-            return core::result<ast::module_decl, std::string>::err(name_token.error());
+            return core::result<void, std::string>::err(name_token.error());
         }
 
         module.name = name_token.value().lexeme;
@@ -36,7 +43,7 @@ public:
             advance();
             auto import = parse_import_path();
             if (!import) {
-                return core::result<ast::module_decl, std::string>::err(import.error());
+                return core::result<void, std::string>::err(import.error());
             }
             module.imports.push_back(std::move(import.value()));
         }
@@ -46,7 +53,7 @@ public:
                 advance();
                 auto constant = parse_const_decl();
                 if (!constant) {
-                    return core::result<ast::module_decl, std::string>::err(constant.error());
+                    return core::result<void, std::string>::err(constant.error());
                 }
                 module.constants.push_back(std::move(constant.value()));
                 continue;
@@ -56,7 +63,7 @@ public:
                 advance();
                 auto state = parse_state_decl();
                 if (!state) {
-                    return core::result<ast::module_decl, std::string>::err(state.error());
+                    return core::result<void, std::string>::err(state.error());
                 }
                 module.states.push_back(std::move(state.value()));
                 continue;
@@ -66,7 +73,7 @@ public:
                 advance();
                 auto command = parse_command_decl();
                 if (!command) {
-                    return core::result<ast::module_decl, std::string>::err(command.error());
+                    return core::result<void, std::string>::err(command.error());
                 }
                 module.commands.push_back(std::move(command.value()));
                 continue;
@@ -76,18 +83,23 @@ public:
                 advance();
                 auto function = parse_function_decl();
                 if (!function) {
-                    return core::result<ast::module_decl, std::string>::err(function.error());
+                    return core::result<void, std::string>::err(function.error());
                 }
                 module.functions.push_back(std::move(function.value()));
                 continue;
             }
 
-            return core::result<ast::module_decl, std::string>::err(unexpected_token_message());
+            return core::result<void, std::string>::err(unexpected_token_message());
         }
 
         // Future work: parse additional declarations.
 
-        return core::result<ast::module_decl, std::string>::ok(std::move(module));
+        return core::result<void, std::string>::ok();
+    }
+
+    // Location of the token the parser stopped at; used to position error diagnostics.
+    const token& error_token() const {
+        return tokens_[index_ < tokens_.size() ? index_ : tokens_.size() - 1];
     }
 
 private:
@@ -275,14 +287,23 @@ private:
             return core::result<ast::state_decl, std::string>::err(initial_token.error());
         }
 
-        if (!peek(token_kind::keyword_on)) {
-            return core::result<ast::state_decl, std::string>::err("state requires at least one 'on' transition");
-        }
-
         ast::state_decl decl{};
         decl.name = name_token.value().lexeme;
         decl.initial_state = initial_token.value().lexeme;
 
+        while (peek(token_kind::keyword_in)) {
+            advance(); // consume 'in'
+            auto group = parse_state_group(decl);
+            if (!group) {
+                return core::result<ast::state_decl, std::string>::err(group.error());
+            }
+            decl.groups.push_back(std::move(group.value()));
+        }
+
+        if (!peek(token_kind::keyword_on)) {
+            return core::result<ast::state_decl, std::string>::err("state requires at least one 'on' transition");
+        }
+
         while (peek(token_kind::keyword_on)) {
             advance(); // consume 'on'
             auto transition = parse_state_transition();
@@ -295,12 +316,67 @@ private:
         return core::result<ast::state_decl, std::string>::ok(std::move(decl));
     }
 
+    // Parses `Parent: Child1, Child2` after 'in'; every state has at most one parent and the hierarchy is a tree.
+    core::result<ast::state_group, std::string> parse_state_group(const ast::state_decl& decl) {
+        auto parent_token = consume(token_kind::identifier, "expected parent state after 'in'");
+        if (!parent_token) {
+            return core::result<ast::state_group, std::string>::err(parent_token.error());
+        }
+
+        auto colon_token = consume(token_kind::colon, "expected ':' after parent state");
+        if (!colon_token) {
+            return core::result<ast::state_group, std::string>::err(colon_token.error());
+        }
+
+        ast::state_group group{};
+        group.parent = parent_token.value().lexeme;
+        do {
+            auto child_token = consume(token_kind::identifier, "expected substate name");
+            if (!child_token) {
+                return core::result<ast::state_group, std::string>::err(child_token.error());
+            }
+            const auto& child = child_token.value().lexeme;
+            if (parent_of(decl, child) != nullptr || std::find(group.children.begin(), group.children.end(), child) !=
+                                                         group.children.end()) {
+                return core::result<ast::state_group, std::string>::err("state '" + child + "' already has a parent");
+            }
+            for (const std::string* ancestor = &group.parent; ancestor != nullptr;
+                 ancestor = parent_of(decl, *ancestor)) {
+                if (*ancestor == child) {
+                    return core::result<ast::state_group, std::string>::err("state '" + child +
+                                                                            "' cannot contain itself");
+                }
+            }
+            group.children.push_back(child);
+        } while (match(token_kind::comma));
+
+        return core::result<ast::state_group, std::string>::ok(std::move(group));
+    }
+
+    static const std::string* parent_of(const ast::state_decl& decl, const std::string& state) {
+        for (const auto& group : decl.groups) {
+            if (std::find(group.children.begin(), group.children.end(), state) != group.children.end()) {
+                return &group.parent;
+            }
+        }
+        return nullptr;
+    }
+
     core::result<ast::state_transition, std::string> parse_state_transition() {
         auto event_token = consume(token_kind::identifier, "expected event name after 'on'");
         if (!event_token) {
             return core::result<ast::state_transition, std::string>::err(event_token.error());
         }
 
+        std::optional<std::string> source_state;
+        if (match(token_kind::keyword_in)) {
+            auto source_token = consume(token_kind::identifier, "expected source state after 'in'");
+            if (!source_token) {
+                return core::result<ast::state_transition, std::string>::err(source_token.error());
+            }
+            source_state = source_token.value().lexeme;
+        }
+
         auto arrow_token = consume(token_kind::arrow, "expected '=>' after event name");
         if (!arrow_token) {
             return core::result<ast::state_transition, std::string>::err(arrow_token.error());
@@ -314,6 +390,7 @@ private:
         ast::state_transition transition{};
         transition.event = event_token.value().lexeme;
         transition.target_state = target_token.value().lexeme;
+        transition.source_state = std::move(source_state);
         return core::result<ast::state_transition, std::string>::ok(std::move(transition));
     }
 
@@ -426,8 +503,26 @@ private:
 } // namespace
 
 core::result<ast::module_decl, std::string> parser::parse_module(const std::vector<token>& tokens) {
+    ast::module_decl module;
+    auto status = parse_module(tokens, module);
+    if (!status) {
+        return core::result<ast::module_decl, std::string>::err(std::move(status).error().message);
+    }
+    return core::result<ast::module_decl, std::string>::ok(std::move(module));
+}
+
+core::result<void, diagnostic> parser::parse_module(const std::vector<token>& tokens, ast::module_decl& module) {
     parser_impl impl(tokens);
-    return impl.parse_module();
+    auto status = impl.parse_module(module);
+    if (!status) {
+        diagnostic error{diagnostic_severity::error, diagnostic_phase::parser, std::move(status).error()};
+        if (!tokens.empty()) {
+            error.line = impl.error_token().line;
+            error.column = impl.error_token().column;
+        }
+        return core::result<void, diagnostic>::err(std::move(error));
+    }
+    return core::result<void, diagnostic>::ok();
 }
 
 } // namespace basicpp::frontend
@@ -5,6 +5,7 @@
 #include <basicpp/core/result.hpp>
 
 #include "ast.hpp"
+#include "diagnostic.hpp"
 #include "token.hpp"
 
 namespace basicpp::frontend {
@@ -12,6 +13,10 @@ namespace basicpp::frontend {
 class parser {
 public:
     static core::result<ast::module_decl, std::string> parse_module(const std::vector<token>& tokens);
+
+    // Parses into a caller-owned module, reusing the capacity of its declaration vectors.
+    // Errors report the position of the token where parsing stopped.
+    static core::result<void, diagnostic> parse_module(const std::vector<token>& tokens, ast::module_decl& module);
 };
 
 } // namespace basicpp::frontend
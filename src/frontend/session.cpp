@@ -0,0 +1,61 @@
+#include "session.hpp"
+
+#include <utility>
+
+#include "codegen/generator.hpp"
+#include "interface.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+
+namespace basicpp::frontend {
+
+core::result<transpile_output, diagnostic> transpiler_session::transpile(std::string_view source,
+                                                                          const transpile_options& options) {
+    diagnostics_.clear();
+    interface_summary_.clear();
+
+    auto fail = [this](diagnostic error) {
+        diagnostics_.push_back(error);
+        return core::result<transpile_output, diagnostic>::err(std::move(error));
+    };
+
+    auto lexed = lexer::tokenize(source, tokens_);
+    if (!lexed) {
+        return fail(std::move(lexed).error());
+    }
+
+    auto parsed = parser::parse_module(tokens_, module_);
+    if (!parsed) {
+        return fail(std::move(parsed).error());
+    }
+
+    codegen::generate_options generate{};
+    generate.check_states = options.check_states;
+    generate.minimize_states = options.minimize_states;
+    auto generated = codegen::generate_translation_unit(module_, cpp_source_, generate, diagnostics_);
+    if (!generated) {
+        return fail(diagnostic{diagnostic_severity::error, diagnostic_phase::codegen, std::move(generated).error()});
+    }
+
+    if (options.emit_interface) {
+        interface_summary_ = write_interface(module_);
+    }
+
+    transpile_output output;
+    output.cpp_source = cpp_source_;
+    output.interface_summary = interface_summary_;
+    output.diagnostics = diagnostics_;
+    output.module = &module_;
+    output.token_count = tokens_.size();
+    return core::result<transpile_output, diagnostic>::ok(output);
+}
+
+void transpiler_session::release_memory() {
+    std::vector<token>().swap(tokens_);
+    module_ = ast::module_decl{};
+    std::string().swap(cpp_source_);
+    std::string().swap(interface_summary_);
+    std::vector<diagnostic>().swap(diagnostics_);
+}
+
+} // namespace basicpp::frontend
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <basicpp/core/result.hpp>
+
+#include "ast.hpp"
+#include "diagnostic.hpp"
+#include "token.hpp"
+
+namespace basicpp::frontend {
+
+struct transpile_options {
+    // Also render the .bppi interface summary of the module.
+    bool emit_interface = false;
+    // Report state machine findings (unreachable states, overridden transitions, equivalent states) as warnings.
+    bool check_states = false;
+    // Emit state machines minimised; see codegen::minimize_state.
+    bool minimize_states = false;
+};
+
+// Views into the session's buffers; they stay valid until the next transpile() call on the same
+// session or until the session is destroyed.
+struct transpile_output {
+    std::string_view cpp_source;
+    std::string_view interface_summary;
+    std::span<const diagnostic> diagnostics;
+    const ast::module_decl* module = nullptr;
+    std::size_t token_count = 0;
+};
+
+// In-process entry point to the frontend for embedders: source text in, C++ (and optionally the
+// interface summary) out, with no file I/O. The token stream, AST and output buffers are kept between
+// calls so steady-state transpiles reuse their capacity. A session is not synchronised; use one
+// session per thread. Distinct sessions share no mutable state and can run concurrently.
+class transpiler_session {
+public:
+    transpiler_session() = default;
+
+    transpiler_session(const transpiler_session&) = delete;
+    transpiler_session& operator=(const transpiler_session&) = delete;
+    transpiler_session(transpiler_session&&) noexcept = default;
+    transpiler_session& operator=(transpiler_session&&) noexcept = default;
+
+    core::result<transpile_output, diagnostic> transpile(std::string_view source, const transpile_options& options = {});
+
+    // Diagnostics of the last call, including the error when it failed.
+    std::span<const diagnostic> diagnostics() const noexcept {
+        return diagnostics_;
+    }
+
+    // Drops retained buffers, e.g. after an unusually large input.
+    void release_memory();
+
+private:
+    std::vector<token> tokens_;
+    ast::module_decl module_;
+    std::string cpp_source_;
+    std::string interface_summary_;
+    std::vector<diagnostic> diagnostics_;
+};
+
+} // namespace basicpp::frontend
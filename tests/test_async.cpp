@@ -0,0 +1,140 @@
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/async_command.hpp>
+#include <basicpp/command/async_registry.hpp>
+#include <basicpp/core/executor.hpp>
+#include <basicpp/core/task.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using basicpp::core::task;
+using registry_t = basicpp::command::async_registry<int, int>;
+
+namespace {
+
+task<int> add_one(int value) {
+    co_return value + 1;
+}
+
+task<int> add_two(int value) {
+    const auto first = co_await add_one(value);
+    co_return co_await add_one(first);
+}
+
+task<void> throw_later() {
+    co_await add_one(0);
+    throw std::runtime_error("boom");
+}
+
+// Hops onto the pool `hops` times, yielding its thread between hops like a command waiting on I/O.
+task<std::uint64_t> hop(basicpp::core::executor& pool, std::uint64_t id, int hops) {
+    for (int i = 0; i < hops; ++i) {
+        co_await basicpp::core::schedule(pool);
+    }
+    co_return id;
+}
+
+struct counter_context {
+    mutable std::atomic<int> value{0};
+};
+
+class increment_command final : public basicpp::command::async_command<counter_context> {
+public:
+    basicpp::core::task<result_type> execute_async(const counter_context& context) override {
+        context.value.fetch_add(co_await add_one(0));
+        co_return result_type::ok();
+    }
+};
+
+} // namespace
+
+BASICPP_TEST(TaskChainsAndPropagatesExceptions) {
+    if (basicpp::core::sync_wait(add_two(40)) != 42) {
+        throw std::runtime_error("awaited tasks should compose");
+    }
+
+    bool caught = false;
+    try {
+        basicpp::core::sync_wait(throw_later());
+    } catch (const std::runtime_error& error) {
+        caught = std::string(error.what()) == "boom";
+    }
+    if (!caught) {
+        throw std::runtime_error("exception should propagate through sync_wait");
+    }
+}
+
+BASICPP_TEST(ScheduleResumesOnThreadPool) {
+    basicpp::core::thread_pool_executor pool(2);
+    const auto caller = std::this_thread::get_id();
+    auto on_pool = [](basicpp::core::executor& target) -> task<std::thread::id> {
+        co_await basicpp::core::schedule(target);
+        co_return std::this_thread::get_id();
+    };
+    if (basicpp::core::sync_wait(on_pool(pool)) == caller) {
+        throw std::runtime_error("schedule should resume on a pool thread");
+    }
+}
+
+BASICPP_TEST(WhenAllMultiplexesManyTasksOnFewThreads) {
+    basicpp::core::thread_pool_executor pool(3);
+    std::vector<task<std::uint64_t>> tasks;
+    constexpr std::uint64_t count = 2000;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        tasks.push_back(hop(pool, i, 4));
+    }
+    const auto values = basicpp::core::sync_wait(basicpp::core::when_all(std::move(tasks)));
+    if (values.size() != count) {
+        throw std::runtime_error("when_all should return one value per task");
+    }
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (values[i] != i) {
+            throw std::runtime_error("when_all should keep input order");
+        }
+    }
+}
+
+BASICPP_TEST(AsyncRegistryDispatchesHandlers) {
+    basicpp::core::thread_pool_executor pool(2);
+    registry_t registry(pool);
+    if (!registry.register_handler("inc", [](int value) -> registry_t::task_type {
+            co_return registry_t::handler_result::ok(co_await add_one(value));
+        })) {
+        throw std::runtime_error("register_handler should report insertion");
+    }
+
+    if (basicpp::core::sync_wait(registry.dispatch("inc", 1)).value() != 2) {
+        throw std::runtime_error("async handler should be invoked");
+    }
+
+    auto missing = basicpp::core::sync_wait(registry.dispatch("nope", 0));
+    if (missing || missing.error() != "command not found: nope") {
+        throw std::runtime_error("missing key should yield an error");
+    }
+
+    // The task keeps its handler alive even if the registry drops it before the task runs.
+    auto pending = registry.dispatch("inc", 10);
+    registry.unregister_handler("inc");
+    if (registry.contains("inc") || basicpp::core::sync_wait(std::move(pending)).value() != 11) {
+        throw std::runtime_error("in-flight dispatch should survive unregistration");
+    }
+}
+
+BASICPP_TEST(AsyncCommandExecutes) {
+    counter_context context;
+    increment_command command;
+    for (int i = 0; i < 3; ++i) {
+        if (!basicpp::core::sync_wait(command.execute_async(context))) {
+            throw std::runtime_error("async command should succeed");
+        }
+    }
+    if (context.value.load() != 3) {
+        throw std::runtime_error("async command should update the context");
+    }
+}
+
+BASICPP_TEST_MAIN()
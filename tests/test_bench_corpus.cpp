@@ -0,0 +1,41 @@
+#include <stdexcept>
+#include <string>
+
+#include <basicpp/testing/selftest.hpp>
+
+#include "cli/corpus.hpp"
+#include "frontend/session.hpp"
+
+using basicpp::cli::corpus_options;
+using basicpp::cli::corpus_shape;
+
+BASICPP_TEST(BenchCorpusShapesTranspile) {
+    basicpp::frontend::transpiler_session session;
+    for (auto shape : {corpus_shape::constants, corpus_shape::states, corpus_shape::commands, corpus_shape::bodies,
+                       corpus_shape::mixed}) {
+        const auto source = basicpp::cli::generate_corpus(corpus_options{shape, 200, 7});
+        auto output = session.transpile(source);
+        if (!output) {
+            throw std::runtime_error("corpus " + std::string(basicpp::cli::to_string(shape)) +
+                                     " failed: " + output.error().message);
+        }
+        if (output.value().token_count < 200) {
+            throw std::runtime_error("corpus smaller than requested");
+        }
+    }
+}
+
+BASICPP_TEST(BenchCorpusIsDeterministic) {
+    const corpus_options options{corpus_shape::mixed, 100, 42};
+    if (basicpp::cli::generate_corpus(options) != basicpp::cli::generate_corpus(options)) {
+        throw std::runtime_error("same options should produce the same corpus");
+    }
+
+    auto other = options;
+    other.seed = 43;
+    if (basicpp::cli::generate_corpus(options) == basicpp::cli::generate_corpus(other)) {
+        throw std::runtime_error("seed should change the corpus");
+    }
+}
+
+BASICPP_TEST_MAIN()
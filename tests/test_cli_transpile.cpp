@@ -1,5 +1,8 @@
 #include <filesystem>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <system_error>
@@ -19,6 +22,26 @@ std::filesystem::path make_temp_directory() {
     return base;
 }
 
+void write_file(const std::filesystem::path& path, const std::string& contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream output(path, std::ios::binary);
+    if (!output) {
+        throw std::runtime_error("failed to write input test file");
+    }
+    output << contents;
+}
+
+int run_quiet(std::vector<std::string> params, std::string* captured_output = nullptr) {
+    std::ostringstream captured;
+    auto* previous = std::cout.rdbuf(captured.rdbuf());
+    int exit_code = basicpp::cli::run_transpile(params);
+    std::cout.rdbuf(previous);
+    if (captured_output) {
+        *captured_output = captured.str();
+    }
+    return exit_code;
+}
+
 } // namespace
 
 BASICPP_TEST(CliTranspileWritesCppFile) {
@@ -63,4 +86,169 @@ BASICPP_TEST(CliTranspileWritesCppFile) {
     std::filesystem::remove_all(temp_dir, ec);
 }
 
+BASICPP_TEST(CliTranspileReportsMemStats) {
+    const auto temp_dir = make_temp_directory();
+    const auto input_path = temp_dir / "Stats.bpp";
+
+    {
+        std::ofstream input(input_path, std::ios::binary);
+        if (!input) {
+            throw std::runtime_error("failed to write input test file");
+        }
+        input << "module Stats\n"
+              << "const Limit = 10\n";
+    }
+
+    std::ostringstream captured;
+    auto* previous = std::cout.rdbuf(captured.rdbuf());
+    std::vector<std::string> params{input_path.string(), "--mem-stats"};
+    int exit_code = basicpp::cli::run_transpile(params);
+    std::cout.rdbuf(previous);
+
+    if (exit_code != 0) {
+        throw std::runtime_error("run_transpile returned non-zero exit code");
+    }
+
+    const auto report = captured.str();
+    for (const char* expected : {"memory statistics", "lex", "parse", "codegen", "peak_rss_bytes"}) {
+        if (report.find(expected) == std::string::npos) {
+            throw std::runtime_error(std::string("mem-stats report missing ") + expected);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(temp_dir, ec);
+}
+
+BASICPP_TEST(CliTranspileBuildsImportedModulesAndReusesCache) {
+    const auto temp_dir = make_temp_directory();
+    write_file(temp_dir / "App.bpp", "module App\nimport Lib.Util\nimport Basicpp.Command\nconst Name = \"app\"\n");
+    write_file(temp_dir / "Lib" / "Util.bpp", "module Util\nimport Lib.Core\nconst Size = 2\n");
+    write_file(temp_dir / "Lib" / "Core.bpp", "module Core\nconst Base = 1\n");
+
+    const auto out_dir = temp_dir / "out";
+    std::string output;
+    if (run_quiet({(temp_dir / "App.bpp").string(), "--out", out_dir.string()}, &output) != 0) {
+        throw std::runtime_error("multi-module transpile failed");
+    }
+
+    for (const auto& expected : {out_dir / "App.cpp", out_dir / "Lib" / "Util.cpp", out_dir / "Lib" / "Core.cpp"}) {
+        if (!std::filesystem::exists(expected)) {
+            throw std::runtime_error("missing generated module " + expected.string());
+        }
+    }
+
+    if (run_quiet({(temp_dir / "App.bpp").string(), "--out", out_dir.string()}, &output) != 0) {
+        throw std::runtime_error("cached transpile failed");
+    }
+    if (output.find("Generated") != std::string::npos) {
+        throw std::runtime_error("unchanged modules should be reused from the cache");
+    }
+
+    write_file(temp_dir / "Lib" / "Util.bpp", "module Util\nimport Lib.Core\nconst Size = 3\n");
+    if (run_quiet({(temp_dir / "App.bpp").string(), "--out", out_dir.string()}, &output) != 0) {
+        throw std::runtime_error("incremental transpile failed");
+    }
+    if (output.find("Up to date " + (out_dir / "Lib" / "Core.cpp").string()) == std::string::npos ||
+        output.find("Generated " + (out_dir / "Lib" / "Util.cpp").string()) == std::string::npos ||
+        output.find("Generated " + (out_dir / "App.cpp").string()) == std::string::npos) {
+        throw std::runtime_error("only the edited module and its dependents should regenerate");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(temp_dir, ec);
+}
+
+BASICPP_TEST(CliTranspileKeepsImportersOnBodyOnlyEdits) {
+    const auto temp_dir = make_temp_directory();
+    write_file(temp_dir / "App.bpp", "module App\nimport Core\n");
+    write_file(temp_dir / "Core.bpp", "module Core\nfunction Answer() as Integer\nreturn 1\nend function\n");
+
+    if (run_quiet({(temp_dir / "App.bpp").string()}) != 0) {
+        throw std::runtime_error("initial transpile failed");
+    }
+    if (!std::filesystem::exists(temp_dir / "Core.bppi")) {
+        throw std::runtime_error("expected an interface summary for the imported module");
+    }
+
+    write_file(temp_dir / "Core.bpp", "module Core\nfunction Answer() as Integer\nreturn 42\nend function\n");
+    std::string output;
+    if (run_quiet({(temp_dir / "App.bpp").string()}, &output) != 0) {
+        throw std::runtime_error("incremental transpile failed");
+    }
+    if (output.find("Generated " + (temp_dir / "Core.cpp").string()) == std::string::npos) {
+        throw std::runtime_error("edited module should regenerate");
+    }
+    if (output.find("Up to date " + (temp_dir / "App.cpp").string()) == std::string::npos) {
+        throw std::runtime_error("importer should be reused when the interface is unchanged");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(temp_dir, ec);
+}
+
+BASICPP_TEST(CliTranspileWarnsAboutAndMinimizesStates) {
+    const auto temp_dir = make_temp_directory();
+    const auto input_path = temp_dir / "Door.bpp";
+    write_file(input_path, "module Door\nstate Door = Closed\non Open => Opened\non Close => Closed\n"
+                           "on Open => Ajar\non Close => Closed\n");
+
+    std::ostringstream errors;
+    auto* previous = std::cerr.rdbuf(errors.rdbuf());
+    std::string output;
+    const int plain_exit = run_quiet({input_path.string()}, &output);
+    const auto first_errors = errors.str();
+    errors.str("");
+    const int cached_exit = run_quiet({input_path.string()}, &output);
+    const auto cached_output = output;
+    const auto cached_errors = errors.str();
+    const int minimized_exit = run_quiet({input_path.string(), "--minimize-states"}, &output);
+    std::cerr.rdbuf(previous);
+
+    if (plain_exit != 0 || cached_exit != 0 || minimized_exit != 0) {
+        throw std::runtime_error("transpile with state warnings should still succeed");
+    }
+    const std::string warning = "warning: state Door: transition from 'Closed' on 'Open' to 'Opened' is overridden";
+    if (first_errors.find(warning) == std::string::npos) {
+        throw std::runtime_error("missing overridden transition warning:\n" + first_errors);
+    }
+    if (cached_output.find("Up to date") == std::string::npos || cached_errors.find(warning) == std::string::npos) {
+        throw std::runtime_error("a module reused from the cache should repeat its warnings:\n" + cached_errors);
+    }
+    if (output.find("Generated") == std::string::npos) {
+        throw std::runtime_error("changing --minimize-states should invalidate the cache");
+    }
+
+    std::ifstream generated(temp_dir / "Door.cpp");
+    const std::string cpp{std::istreambuf_iterator<char>(generated), std::istreambuf_iterator<char>()};
+    if (cpp.find("\"Opened\"") != std::string::npos || cpp.find("\"Ajar\"") == std::string::npos) {
+        throw std::runtime_error("minimised output should only keep reachable states");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(temp_dir, ec);
+}
+
+BASICPP_TEST(CliTranspileRejectsImportCycles) {
+    const auto temp_dir = make_temp_directory();
+    write_file(temp_dir / "Main.bpp", "module Main\nimport Ping\n");
+    write_file(temp_dir / "Ping.bpp", "module Ping\nimport Pong\n");
+    write_file(temp_dir / "Pong.bpp", "module Pong\nimport Ping\n");
+
+    std::ostringstream errors;
+    auto* previous = std::cerr.rdbuf(errors.rdbuf());
+    const int exit_code = run_quiet({(temp_dir / "Main.bpp").string()});
+    std::cerr.rdbuf(previous);
+
+    if (exit_code == 0) {
+        throw std::runtime_error("import cycle should fail the transpile");
+    }
+    if (errors.str().find("import cycle detected") == std::string::npos) {
+        throw std::runtime_error("missing cycle diagnostic");
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(temp_dir, ec);
+}
+
 BASICPP_TEST_MAIN()
@@ -0,0 +1,196 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <basicpp/history/coalescer.hpp>
+#include <basicpp/history/concurrent_coalescer.hpp>
+#include <basicpp/history/keyed_coalescer.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+struct add {
+    std::int64_t operator()(std::int64_t a, std::int64_t b) const noexcept {
+        return a + b;
+    }
+};
+
+} // namespace
+
+BASICPP_TEST(ConcurrentCoalescerKeepsWindowSemantics) {
+    basicpp::history::coalescer<std::int64_t> serial{milliseconds(10), add{}};
+    basicpp::history::concurrent_coalescer<std::int64_t, add> concurrent{milliseconds(10)};
+    const auto origin = clock_type::time_point{};
+
+    // Pushes and consumes at the same instants must give the same emissions from both coalescers.
+    const int steps[][2] = {{0, 1}, {4, 2}, {9, -1}, {10, -1}, {12, 5}, {15, -1}, {21, -1}, {22, -1}, {30, 7}, {45, -1}};
+    for (const auto& [at, value] : steps) {
+        const auto now = origin + milliseconds(at);
+        if (value >= 0) {
+            serial.push(value, now);
+            concurrent.push(value, now);
+            if (!concurrent.has_pending()) {
+                throw std::runtime_error("concurrent coalescer should report a pending value");
+            }
+            continue;
+        }
+        const auto expected = serial.consume(now);
+        const auto actual = concurrent.consume(now);
+        if (expected != actual) {
+            throw std::runtime_error("concurrent coalescer should emit what coalescer emits");
+        }
+    }
+    if (concurrent.has_pending()) {
+        throw std::runtime_error("nothing should be pending after the last window");
+    }
+
+    concurrent.push(3, origin);
+    concurrent.reset();
+    if (concurrent.has_pending() || concurrent.consume(origin + milliseconds(100))) {
+        throw std::runtime_error("reset should drop pending values");
+    }
+}
+
+BASICPP_TEST(ConcurrentCoalescerSurvivesThrowingCombine) {
+    auto sum = basicpp::history::make_concurrent_coalescer<std::int64_t>(
+        milliseconds(10), [](std::int64_t a, std::int64_t b) -> std::int64_t {
+            if (b < 0) {
+                throw std::runtime_error("negative update");
+            }
+            return a + b;
+        });
+    const auto origin = clock_type::time_point{};
+
+    sum.push(1, origin);
+    bool threw = false;
+    try {
+        sum.push(-1, origin + milliseconds(1));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    sum.push(2, origin + milliseconds(2));
+
+    // A throwing combine must leave its slot free: consume would otherwise wait for it forever.
+    const auto value = sum.consume(origin + milliseconds(10));
+    if (!threw || !value || *value != 3 || sum.has_pending()) {
+        throw std::runtime_error("a throwing combine should propagate and keep the pending value");
+    }
+}
+
+BASICPP_TEST(ConcurrentCoalescerLosesNoUpdates) {
+    // A zero window lets every consume emit, so the consumer races the producers throughout.
+    auto sum = basicpp::history::make_concurrent_coalescer<std::int64_t, clock_type, 4>(
+        clock_type::duration::zero(), [](std::int64_t a, std::int64_t b) { return a + b; });
+    constexpr int producers = 6;
+    constexpr std::int64_t per_producer = 20000;
+
+    std::atomic<int> running{producers};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (std::int64_t i = 1; i <= per_producer; ++i) {
+                sum.push(i);
+            }
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    std::int64_t total = 0;
+    std::int64_t emissions = 0;
+    while (running.load(std::memory_order_acquire) != 0) {
+        if (const auto value = sum.consume()) {
+            total += *value;
+            ++emissions;
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (const auto value = sum.consume()) {
+        total += *value;
+        ++emissions;
+    }
+
+    if (total != producers * per_producer * (per_producer + 1) / 2) {
+        throw std::runtime_error("concurrent coalescer lost or duplicated an update");
+    }
+    if (emissions == 0 || sum.has_pending()) {
+        throw std::runtime_error("concurrent coalescer should have emitted everything");
+    }
+}
+
+BASICPP_TEST(KeyedCoalescerEmitsEachKeyAfterItsWindow) {
+    auto edits = basicpp::history::make_keyed_coalescer<std::string, std::string>(
+        milliseconds(10), [](const std::string& a, const std::string& b) { return a + b; });
+    const auto origin = clock_type::time_point{} + milliseconds(1000);
+
+    edits.push("a", "1", origin);
+    edits.push("b", "x", origin + milliseconds(4));
+    edits.push("a", "2", origin + milliseconds(8));
+    if (edits.size() != 2 || !edits.poll(origin + milliseconds(9)).empty()) {
+        throw std::runtime_error("keyed coalescer should hold both keys inside their windows");
+    }
+
+    auto first = edits.poll(origin + milliseconds(10));
+    if (first.size() != 1 || first[0].first != "a" || first[0].second != "12" || edits.contains("a")) {
+        throw std::runtime_error("keyed coalescer should emit only the key whose window elapsed");
+    }
+
+    edits.push("a", "3", origin + milliseconds(11));
+    if (!edits.erase("a") || edits.erase("a")) {
+        throw std::runtime_error("keyed coalescer should drop an erased key once");
+    }
+    auto second = edits.poll(origin + milliseconds(100));
+    if (second.size() != 1 || second[0].first != "b" || second[0].second != "x" || !edits.empty()) {
+        throw std::runtime_error("keyed coalescer should emit the remaining key");
+    }
+}
+
+BASICPP_TEST(KeyedCoalescerMatchesPerKeyCoalescers) {
+    // Windows far longer than the wheel's 64^4-tick span exercise parking in the top level.
+    for (const auto window : {milliseconds(10), milliseconds(700), milliseconds(20'000'000)}) {
+        basicpp::history::keyed_coalescer<int, std::int64_t, clock_type, add> keyed{window, add{}, milliseconds(1)};
+        std::map<int, std::pair<std::int64_t, clock_type::time_point>> expected;
+        std::mt19937 rng(7);
+        auto now = clock_type::time_point{};
+
+        for (int step = 0; step < 20000; ++step) {
+            now += milliseconds(rng() % 3 == 0 ? rng() % (window.count() / 4 + 2) : rng() % 3);
+            if (rng() % 4 != 0) {
+                const auto key = static_cast<int>(rng() % 500);
+                const auto value = static_cast<std::int64_t>(rng() % 100);
+                keyed.push(key, value, now);
+                auto [it, inserted] = expected.try_emplace(key, value, now);
+                if (!inserted) {
+                    it->second.first += value;
+                }
+                continue;
+            }
+            std::map<int, std::int64_t> due;
+            for (auto it = expected.begin(); it != expected.end();) {
+                if (now - it->second.second >= window) {
+                    due.emplace(it->first, it->second.first);
+                    it = expected.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            std::map<int, std::int64_t> emitted;
+            keyed.poll(now, [&](const int& key, std::int64_t& value) { emitted.emplace(key, value); });
+            if (emitted != due || keyed.size() != expected.size()) {
+                throw std::runtime_error("keyed coalescer should emit exactly the keys whose window elapsed");
+            }
+        }
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -1,9 +1,12 @@
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <basicpp/testing/selftest.hpp>
 
 #include "codegen/generator.hpp"
+#include "codegen/state_analysis.hpp"
+#include "codegen/state_hierarchy.hpp"
 #include "frontend/lexer.hpp"
 #include "frontend/parser.hpp"
 
@@ -28,6 +31,31 @@ std::string generate_cpp(std::string_view source) {
     return generated.value();
 }
 
+basicpp::frontend::ast::module_decl parse(std::string_view source) {
+    auto tokens = basicpp::frontend::lexer::tokenize(source);
+    if (!tokens) {
+        throw std::runtime_error("lexer failed");
+    }
+    auto module = basicpp::frontend::parser::parse_module(tokens.value());
+    if (!module) {
+        throw std::runtime_error("parser failed: " + module.error());
+    }
+    return module.value();
+}
+
+// B and C both accept only Next and return to A, so they are equivalent; Stop is declared twice from A.
+constexpr std::string_view redundant_machine =
+    "module Demo\n"
+    "state Machine = A\n"
+    "in Spare: Ghost\n"
+    "on Stop => A\n"
+    "on Go => B\n"
+    "on Next => A\n"
+    "on Stop => A\n"
+    "on Jump => C\n"
+    "on Next => A\n"
+    "on Stop in A => A\n";
+
 } // namespace
 
 BASICPP_TEST(CodegenEmitsConstStateCommandFunction) {
@@ -72,4 +100,114 @@ BASICPP_TEST(CodegenEmitsConstStateCommandFunction) {
     }
 }
 
+BASICPP_TEST(CodegenFlattensStateHierarchy) {
+    constexpr std::string_view source =
+        "module Net\n"
+        "state Link = Offline\n"
+        "in Online: Idle, Busy\n"
+        "on Connect => Online\n"
+        "on Start => Busy\n"
+        "on Drop in Online => Offline\n"
+        "on Drop in Busy => Idle\n";
+
+    const auto cpp = generate_cpp(source);
+
+    constexpr std::string_view expected =
+        "    machine.add_transition(\"Offline\", \"Connect\", \"Idle\");\n"
+        "    machine.add_transition(\"Idle\", \"Start\", \"Busy\");\n"
+        "    machine.add_transition(\"Idle\", \"Drop\", \"Offline\");\n"
+        "    machine.add_transition(\"Busy\", \"Drop\", \"Idle\");\n"
+        "    return machine;\n";
+    if (cpp.find(expected) == std::string::npos) {
+        throw std::runtime_error("hierarchy should be flattened into leaf transitions:\n" + cpp);
+    }
+    if (cpp.find("\"Online\", \"Drop\"") != std::string::npos) {
+        throw std::runtime_error("composite states should not appear as transition sources");
+    }
+}
+
+BASICPP_TEST(StateAnalysisReportsRedundancy) {
+    const auto module = parse(redundant_machine);
+    const auto report = basicpp::codegen::analyze_state(basicpp::codegen::flatten_state(module.states.at(0)));
+
+    if (report.unreachable != std::vector<std::string>{"Ghost"}) {
+        throw std::runtime_error("Ghost should be reported unreachable");
+    }
+    if (report.overridden.size() != 2 || report.overridden[0].event != "Stop" || report.overridden[1].event != "Stop") {
+        throw std::runtime_error("both earlier Stop transitions should be reported as overridden");
+    }
+    if (report.equivalent != std::vector<std::vector<std::string>>{{"B", "C"}}) {
+        throw std::runtime_error("B and C should be reported equivalent");
+    }
+}
+
+BASICPP_TEST(StateAnalysisMinimizesMachine) {
+    const auto module = parse(redundant_machine);
+    const auto minimal = basicpp::codegen::minimize_state(basicpp::codegen::flatten_state(module.states.at(0)));
+
+    if (minimal.initial_state != "A" || minimal.states != std::vector<std::string>{"A", "B"}) {
+        throw std::runtime_error("minimal machine should keep A and B only");
+    }
+    // A: Stop, Go, Jump (Jump now enters B); B: Next.
+    if (minimal.transitions.size() != 4) {
+        throw std::runtime_error("minimal machine should have one transition per state and event");
+    }
+    for (const auto& transition : minimal.transitions) {
+        if (transition.event == "Jump" && transition.to != "B") {
+            throw std::runtime_error("transitions into merged states should target the representative");
+        }
+    }
+
+    // A machine that is already minimal comes back with the same transitions.
+    const auto again = basicpp::codegen::minimize_state(minimal);
+    if (again.states != minimal.states || again.transitions.size() != minimal.transitions.size()) {
+        throw std::runtime_error("minimisation should be idempotent");
+    }
+}
+
+BASICPP_TEST(StateAnalysisKeepsTerminalStatesApart) {
+    const auto module = parse("module Jobs\nstate Job = Idle\non Ok => Done\non Fail in Idle => Failed\n");
+    const auto flat = basicpp::codegen::flatten_state(module.states.at(0));
+
+    if (!basicpp::codegen::analyze_state(flat).equivalent.empty()) {
+        throw std::runtime_error("distinct terminal states should not be reported equivalent");
+    }
+    const auto minimal = basicpp::codegen::minimize_state(flat);
+    if (minimal.states != std::vector<std::string>{"Idle", "Done", "Failed"} || minimal.transitions.size() != 2) {
+        throw std::runtime_error("distinct terminal states should not be merged");
+    }
+    for (const auto& transition : minimal.transitions) {
+        if (transition.to != (transition.event == "Ok" ? "Done" : "Failed")) {
+            throw std::runtime_error("each outcome should keep its own terminal state");
+        }
+    }
+}
+
+BASICPP_TEST(CodegenReportsAndMinimizesStates) {
+    const auto module = parse(redundant_machine);
+
+    std::string plain;
+    if (!basicpp::codegen::generate_translation_unit(module, plain)) {
+        throw std::runtime_error("code generation failed");
+    }
+
+    std::string minimal;
+    std::vector<basicpp::frontend::diagnostic> warnings;
+    basicpp::codegen::generate_options options{};
+    options.check_states = true;
+    options.minimize_states = true;
+    if (!basicpp::codegen::generate_translation_unit(module, minimal, options, warnings)) {
+        throw std::runtime_error("code generation failed");
+    }
+
+    if (warnings.size() != 4 || warnings[0].severity != basicpp::frontend::diagnostic_severity::warning ||
+        warnings[0].phase != basicpp::frontend::diagnostic_phase::codegen ||
+        warnings[3].message != "state Machine: states 'B', 'C' are equivalent") {
+        throw std::runtime_error("unexpected state warnings");
+    }
+    if (plain.find("\"C\"") == std::string::npos || minimal.find("\"C\"") != std::string::npos) {
+        throw std::runtime_error("minimised output should not mention merged states");
+    }
+}
+
 BASICPP_TEST_MAIN()
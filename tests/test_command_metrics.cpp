@@ -0,0 +1,131 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/metrics.hpp>
+#include <basicpp/command/registry.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using basicpp::command::latency_histogram;
+using plain_registry = basicpp::command::registry<int, int>;
+using metered_registry =
+    basicpp::command::basic_registry<basicpp::command::with_metrics<basicpp::command::registry_policy<>>, int, int>;
+
+template <typename Registry>
+concept has_metrics = requires(const Registry& registry) { registry.metrics(); };
+
+static_assert(!plain_registry::metrics_type::enabled && !has_metrics<plain_registry>);
+static_assert(metered_registry::metrics_type::enabled && has_metrics<metered_registry>);
+
+namespace {
+
+metered_registry make_registry() {
+    metered_registry registry;
+    registry.register_handler("even", [](int value) {
+        if (value % 2 != 0) {
+            return metered_registry::handler_result::err("odd");
+        }
+        return metered_registry::handler_result::ok(value);
+    });
+    registry.register_handler("noop", [](int value) { return metered_registry::handler_result::ok(value); });
+    return registry;
+}
+
+} // namespace
+
+BASICPP_TEST(LatencyHistogramBucketsAreMonotonic) {
+    for (std::uint64_t value : {0ull, 7ull, 8ull, 9ull, 100ull, 1000ull, 123456789ull, 1ull << 39}) {
+        const auto bucket = latency_histogram::bucket_of(value);
+        if (latency_histogram::bucket_upper(bucket) < value ||
+            (bucket > 0 && latency_histogram::bucket_upper(bucket - 1) >= value)) {
+            throw std::runtime_error("value should fall inside its bucket: " + std::to_string(value));
+        }
+        if (value >= 8 && latency_histogram::bucket_upper(bucket) > value + value / 8) {
+            throw std::runtime_error("bucket should be within 12.5% of the value");
+        }
+    }
+
+    latency_histogram histogram;
+    for (std::uint64_t i = 1; i <= 100; ++i) {
+        histogram.record(i * 1000);
+    }
+    const auto p50 = histogram.percentile(0.5);
+    if (histogram.count() != 100 || p50 < 50000 || p50 > 50000 + 50000 / 8) {
+        throw std::runtime_error("median should land in the 50us bucket");
+    }
+}
+
+BASICPP_TEST(RegistryRecordsCallsAndErrorsPerKey) {
+    auto registry = make_registry();
+    for (int i = 0; i < 10; ++i) {
+        registry.dispatch("even", i);
+    }
+    registry.dispatch(registry.resolve("noop"), 1);
+    registry.dispatch("missing", 0);
+
+    const auto snapshot = registry.metrics();
+    const auto* even = snapshot.find("even");
+    const auto* noop = snapshot.find("noop");
+    if (snapshot.keys.size() != 2 || !even || !noop || snapshot.find("missing")) {
+        throw std::runtime_error("snapshot should hold one entry per registered key");
+    }
+    if (even->calls != 10 || even->errors != 5 || even->latency.count() != 10 || noop->calls != 1 ||
+        noop->errors != 0) {
+        throw std::runtime_error("calls and errors should be counted per key");
+    }
+    if (even->percentile_ns(0.99) > even->max_ns) {
+        throw std::runtime_error("percentiles should not exceed the maximum");
+    }
+
+    const auto text = registry.metrics().to_text();
+    const auto json = registry.metrics().to_json();
+    if (text.find("even 10 5 ") == std::string::npos ||
+        json.find("{\"key\":\"even\",\"calls\":10,\"errors\":5,") == std::string::npos ||
+        json.find("\"key\":\"noop\"") == std::string::npos) {
+        throw std::runtime_error("text and JSON export should include every key: " + json);
+    }
+
+    // A reused slot starts from zero.
+    registry.unregister_handler("noop");
+    registry.register_handler("fresh", [](int value) { return metered_registry::handler_result::ok(value); });
+    const auto after = registry.metrics();
+    const auto* fresh = after.find("fresh");
+    if (!fresh || fresh->calls != 0) {
+        throw std::runtime_error("a newly registered key should have empty metrics");
+    }
+}
+
+BASICPP_TEST(RegistryMetricsMergeThreadShards) {
+    auto registry = make_registry();
+    constexpr int threads = 8;
+    constexpr int per_thread = 5000;
+
+    std::vector<metered_registry::batch_request> requests;
+    for (int i = 0; i < 1000; ++i) {
+        requests.push_back({"even", {i}});
+    }
+    std::vector<metered_registry::handler_result> results(requests.size());
+    registry.dispatch_batch(requests, results);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&registry] {
+            for (int i = 0; i < per_thread; ++i) {
+                registry.dispatch("noop", i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const auto snapshot = registry.metrics();
+    if (snapshot.find("noop")->calls != threads * per_thread || snapshot.find("even")->calls != 1000 ||
+        snapshot.find("even")->errors != 500) {
+        throw std::runtime_error("shards should merge into exact totals");
+    }
+}
+
+BASICPP_TEST_MAIN()
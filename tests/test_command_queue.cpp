@@ -0,0 +1,166 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/queue.hpp>
+#include <basicpp/command/registry.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using registry_t = basicpp::command::registry<std::uint64_t, std::uint64_t>;
+using queue_t = basicpp::command::queue<std::uint64_t>;
+using basicpp::command::backpressure;
+
+namespace {
+
+// Records the arguments it sees, in order; only the consumer thread touches it.
+struct recorder {
+    std::vector<std::uint64_t> seen;
+    std::uint64_t sum = 0;
+
+    void install(registry_t& registry) {
+        registry.register_handler("record", [this](std::uint64_t value) {
+            seen.push_back(value);
+            sum += value;
+            return registry_t::handler_result::ok(value);
+        });
+    }
+};
+
+} // namespace
+
+BASICPP_TEST(QueueDrainsInFifoOrder) {
+    registry_t registry;
+    recorder log;
+    log.install(registry);
+    queue_t commands(4);
+
+    for (std::uint64_t i = 0; i < 3; ++i) {
+        commands.push("record", i);
+    }
+    commands.push("missing", 99);
+
+    if (commands.drain(registry, 2) != 2 || log.seen != std::vector<std::uint64_t>{0, 1}) {
+        throw std::runtime_error("drain should honour its limit and FIFO order");
+    }
+
+    std::vector<std::string> failures;
+    const auto drained = commands.drain(registry, [&](std::string_view key, const registry_t::handler_result& result) {
+        if (!result) {
+            failures.emplace_back(key);
+        }
+    });
+    if (drained != 2 || log.seen.back() != 2 || failures != std::vector<std::string>{"missing"} || !commands.empty()) {
+        throw std::runtime_error("drain should report results per command");
+    }
+}
+
+BASICPP_TEST(QueueBackpressureModes) {
+    registry_t registry;
+    recorder log;
+    log.install(registry);
+
+    queue_t dropping(2, backpressure::drop);
+    if (!dropping.push("record", 1) || !dropping.push("record", 2) || dropping.push("record", 3)) {
+        throw std::runtime_error("drop mode should reject when full");
+    }
+    dropping.drain(registry);
+    if (log.seen != std::vector<std::uint64_t>{1, 2} || dropping.dropped() != 1) {
+        throw std::runtime_error("drop mode should keep the oldest commands");
+    }
+
+    log.seen.clear();
+    queue_t overwriting(2, backpressure::overwrite);
+    for (std::uint64_t i = 1; i <= 5; ++i) {
+        overwriting.push("record", i);
+    }
+    overwriting.drain(registry);
+    if (log.seen != std::vector<std::uint64_t>{4, 5} || overwriting.dropped() != 3) {
+        throw std::runtime_error("overwrite mode should keep the newest commands");
+    }
+}
+
+BASICPP_TEST(QueueOverwriteEvictsOnlyTheOldestWhileDispatching) {
+    registry_t registry;
+    std::vector<std::uint64_t> seen;
+    std::atomic<bool> dispatching{false};
+    std::atomic<bool> resume{false};
+    registry.register_handler("record", [&](std::uint64_t value) {
+        if (value == 1) {
+            // Hold the first command until the producer is done; the deadline keeps a regression from hanging.
+            dispatching.store(true);
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            while (!resume.load() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+        seen.push_back(value);
+        return registry_t::handler_result::ok(value);
+    });
+
+    queue_t commands(4, backpressure::overwrite);
+    for (std::uint64_t i = 1; i <= 4; ++i) {
+        commands.push("record", i);
+    }
+    std::thread consumer([&] { commands.drain(registry, 1); });
+    while (!dispatching.load()) {
+        std::this_thread::yield();
+    }
+    // The command being dispatched no longer takes a slot: 5 fits, and 6 evicts only 2.
+    commands.push("record", 5);
+    commands.push("record", 6);
+    resume.store(true);
+    consumer.join();
+    commands.drain(registry);
+
+    if (seen != std::vector<std::uint64_t>{1, 3, 4, 5, 6} || commands.dropped() != 1) {
+        throw std::runtime_error("overwrite should evict only the oldest pending command");
+    }
+}
+
+BASICPP_TEST(QueueRunLoopWithManyProducers) {
+    registry_t registry;
+    recorder log;
+    log.install(registry);
+    queue_t commands(64);
+
+    constexpr std::uint64_t producers = 4;
+    constexpr std::uint64_t per_producer = 20000;
+
+    std::jthread consumer([&](std::stop_token stop) { commands.run(registry, stop); });
+    std::vector<std::thread> threads;
+    for (std::uint64_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < per_producer; ++i) {
+                commands.push("record", p * per_producer + i + 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    consumer.request_stop();
+    consumer.join();
+
+    const auto total = producers * per_producer;
+    if (log.seen.size() != total || log.sum != total * (total + 1) / 2 || commands.dropped() != 0) {
+        throw std::runtime_error("blocking queue should deliver every command exactly once");
+    }
+
+    // Each producer's commands arrive in the order it pushed them.
+    std::vector<std::uint64_t> last(producers, 0);
+    for (auto value : log.seen) {
+        const auto producer = (value - 1) / per_producer;
+        if (value <= last[producer]) {
+            throw std::runtime_error("per-producer order should be preserved");
+        }
+        last[producer] = value;
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -1,5 +1,8 @@
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 #include <basicpp/command/registry.hpp>
 #include <basicpp/testing/selftest.hpp>
@@ -30,4 +33,233 @@ BASICPP_TEST(CommandRegistryFailsWhenCommandMissing) {
     }
 }
 
+BASICPP_TEST(CommandRegistryDispatchesByStringView) {
+    registry_t registry;
+    registry.register_handler("answer", [] {
+        return registry_t::handler_result::ok(42);
+    });
+
+    const char buffer[] = "answer-and-more";
+    auto result = registry.dispatch(std::string_view(buffer, 6));
+    if (!result || result.value() != 42) {
+        throw std::runtime_error("string_view dispatch failed");
+    }
+}
+
+BASICPP_TEST(CommandRegistryHandlesSurviveChurnAndGoStale) {
+    registry_t registry;
+    for (int i = 0; i < 100; ++i) {
+        registry.register_handler("cmd" + std::to_string(i), [i] {
+            return registry_t::handler_result::ok(i);
+        });
+    }
+
+    auto handle = registry.resolve("cmd42");
+    if (!handle || registry.resolve("missing")) {
+        throw std::runtime_error("resolve returned unexpected handles");
+    }
+
+    for (int i = 0; i < 100; i += 2) {
+        registry.unregister_handler("cmd" + std::to_string(i + 1));
+    }
+    for (int i = 100; i < 200; ++i) {
+        registry.register_handler("cmd" + std::to_string(i), [i] {
+            return registry_t::handler_result::ok(i);
+        });
+    }
+
+    auto result = registry.dispatch(handle);
+    if (!result || result.value() != 42) {
+        throw std::runtime_error("handle should survive unrelated churn");
+    }
+
+    registry.register_handler("cmd42", [] {
+        return registry_t::handler_result::ok(-42);
+    });
+    if (registry.dispatch(handle).value() != -42) {
+        throw std::runtime_error("overwriting a handler should keep its handle");
+    }
+
+    registry.unregister_handler("cmd42");
+    registry.register_handler("cmd42", [] {
+        return registry_t::handler_result::ok(0);
+    });
+    if (registry.dispatch(handle) || registry.contains(handle)) {
+        throw std::runtime_error("handle should be stale after its key was unregistered");
+    }
+    if (registry.size() != 150 || registry.keys().size() != 150) {
+        throw std::runtime_error("unexpected registry size");
+    }
+}
+
+BASICPP_TEST(CommandRegistryFreezeKeepsDispatchAndThawsOnMutation) {
+    registry_t registry;
+    for (int i = 0; i < 50; ++i) {
+        registry.register_handler("cmd" + std::to_string(i), [i] {
+            return registry_t::handler_result::ok(i);
+        });
+    }
+    auto handle = registry.resolve("cmd7");
+
+    registry.freeze();
+    if (!registry.frozen() || registry.dispatch("cmd49").value() != 49 || registry.dispatch("cmd50")) {
+        throw std::runtime_error("frozen dispatch mismatch");
+    }
+    if (registry.resolve("cmd7") != handle || registry.dispatch(handle).value() != 7) {
+        throw std::runtime_error("freezing should not change handles");
+    }
+
+    registry.register_handler("cmd7", [] {
+        return registry_t::handler_result::ok(70);
+    });
+    if (!registry.frozen() || registry.dispatch("cmd7").value() != 70) {
+        throw std::runtime_error("replacing a handler should keep the frozen table");
+    }
+
+    registry.register_handler("late", [] {
+        return registry_t::handler_result::ok(-1);
+    });
+    if (registry.frozen() || registry.dispatch("late").value() != -1) {
+        throw std::runtime_error("adding a key should thaw the registry");
+    }
+
+    registry.freeze();
+    registry.unregister_handler("cmd3");
+    if (registry.frozen() || registry.contains("cmd3") || !registry.contains("cmd4")) {
+        throw std::runtime_error("removing a key should thaw the registry");
+    }
+}
+
+BASICPP_TEST(CommandRegistryDispatchBatchGroupsByHandler) {
+    using batch_registry = basicpp::command::registry<int, int>;
+    batch_registry registry;
+    std::vector<std::string> calls;
+    for (const char* name : {"add", "mul", "neg"}) {
+        registry.register_handler(name, [&calls, op = std::string(name)](int value) {
+            calls.push_back(op);
+            if (op == "add") {
+                return batch_registry::handler_result::ok(value + 1);
+            }
+            if (op == "mul") {
+                return batch_registry::handler_result::ok(value * 2);
+            }
+            return batch_registry::handler_result::ok(-value);
+        });
+    }
+
+    std::vector<batch_registry::batch_request> requests;
+    const char* pattern[] = {"add", "mul", "neg", "nope", "mul", "add"};
+    for (int i = 0; i < 60; ++i) {
+        requests.push_back({pattern[i % 6], std::tuple<int>(i)});
+    }
+
+    for (bool frozen : {false, true}) {
+        if (frozen) {
+            registry.freeze();
+        }
+        calls.clear();
+        std::vector<batch_registry::handler_result> results(requests.size());
+        registry.dispatch_batch(requests, results);
+
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            auto expected = registry.dispatch(requests[i].key, static_cast<int>(i));
+            if (static_cast<bool>(expected) != static_cast<bool>(results[i]) ||
+                (expected && expected.value() != results[i].value())) {
+                throw std::runtime_error("batch result differs from single dispatch");
+            }
+        }
+
+        // 50 successful invocations, each handler's calls contiguous.
+        std::size_t switches = 0;
+        for (std::size_t i = 1; i < 50; ++i) {
+            switches += calls[i] != calls[i - 1] ? 1 : 0;
+        }
+        if (calls.size() != 100 || switches != 2) {
+            throw std::runtime_error("batch invocations should be grouped by handler");
+        }
+    }
+}
+
+BASICPP_TEST(CommandRegistryDispatchBatchIsReentrant) {
+    using batch_registry = basicpp::command::registry<int, int>;
+    batch_registry inner;
+    for (int h = 0; h < 5; ++h) {
+        inner.register_handler("h" + std::to_string(h), [h](int value) {
+            return batch_registry::handler_result::ok(value * 10 + h);
+        });
+    }
+
+    // A handler that runs a batch of its own on the same thread, on another registry of the same type.
+    batch_registry outer;
+    outer.register_handler("nested", [&inner](int value) {
+        std::vector<batch_registry::batch_request> requests;
+        for (int i = 0; i < 7; ++i) {
+            requests.push_back({i % 2 == 0 ? "h4" : "h0", std::tuple<int>(i)});
+        }
+        std::vector<batch_registry::handler_result> results(requests.size());
+        inner.dispatch_batch(requests, results);
+        int sum = 0;
+        for (const auto& result : results) {
+            sum += result.value();
+        }
+        return batch_registry::handler_result::ok(value + sum);
+    });
+    outer.register_handler("twice", [](int value) { return batch_registry::handler_result::ok(value * 2); });
+
+    std::vector<batch_registry::batch_request> requests;
+    for (int i = 0; i < 40; ++i) {
+        requests.push_back({i % 3 == 0 ? "nested" : "twice", std::tuple<int>(i)});
+    }
+    std::vector<batch_registry::handler_result> results(requests.size());
+    outer.dispatch_batch(requests, results);
+
+    // The nested batch yields 0*10+4 + 1*10 + 2*10+4 + ... + 6*10+4 = 226.
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        const int value = static_cast<int>(i);
+        const int expected = i % 3 == 0 ? value + 226 : value * 2;
+        if (!results[i] || results[i].value() != expected) {
+            throw std::runtime_error("a nested dispatch_batch should not disturb the outer batch");
+        }
+    }
+}
+
+BASICPP_TEST(CommandRegistryParallelDispatchBatch) {
+    using batch_registry = basicpp::command::registry<long long, long long>;
+    batch_registry registry;
+    for (int h = 0; h < 8; ++h) {
+        registry.register_handler("op" + std::to_string(h), [h](long long value) {
+            return batch_registry::handler_result::ok(value * 8 + h);
+        });
+    }
+
+    std::vector<std::string> keys;
+    for (int h = 0; h < 9; ++h) {
+        keys.push_back("op" + std::to_string(h));
+    }
+    std::vector<batch_registry::batch_request> requests;
+    for (long long i = 0; i < 10000; ++i) {
+        requests.push_back({keys[static_cast<std::size_t>(i % 9)], std::tuple<long long>(i)});
+    }
+
+    std::vector<batch_registry::handler_result> results(requests.size());
+    registry.dispatch_batch(requests, results, basicpp::command::parallel_dispatch{4, 16});
+    for (long long i = 0; i < 10000; ++i) {
+        const auto& result = results[static_cast<std::size_t>(i)];
+        if (i % 9 == 8 ? static_cast<bool>(result) : (!result || result.value() != i * 8 + i % 9)) {
+            throw std::runtime_error("parallel batch produced a wrong result");
+        }
+    }
+
+    std::vector<batch_registry::handler_result> too_small(1);
+    bool threw = false;
+    try {
+        registry.dispatch_batch(requests, too_small);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("undersized results span should be rejected");
+    }
+}
+
 BASICPP_TEST_MAIN()
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <basicpp/command/concurrent_registry.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using registry_t = basicpp::command::concurrent_registry<std::uint64_t, std::uint64_t>;
+
+namespace {
+
+// Handler state that poisons itself on destruction, so a reader running a reclaimed handler is detected.
+struct tracked_state {
+    static constexpr std::uint64_t live_magic = 0x600DF00Du;
+
+    explicit tracked_state(std::uint64_t value)
+        : value(value) {
+    }
+
+    ~tracked_state() {
+        magic = 0xDEADu;
+    }
+
+    std::uint64_t magic = live_magic;
+    std::uint64_t value;
+};
+
+registry_t::handler_type make_handler(std::uint64_t value) {
+    auto state = std::make_shared<tracked_state>(value);
+    return [state](std::uint64_t arg) {
+        if (state->magic != tracked_state::live_magic) {
+            return registry_t::handler_result::err("handler used after reclamation");
+        }
+        return registry_t::handler_result::ok(state->value * 1000 + arg);
+    };
+}
+
+} // namespace
+
+BASICPP_TEST(ConcurrentRegistryBehavesLikeRegistry) {
+    registry_t registry;
+    if (!registry.register_handler("a", make_handler(1)) || registry.register_handler("a", make_handler(2))) {
+        throw std::runtime_error("register_handler should report insertion");
+    }
+    if (registry.dispatch("a", 5).value() != 2005 || registry.size() != 1 || !registry.contains("a")) {
+        throw std::runtime_error("replaced handler should be dispatched");
+    }
+
+    registry.unregister_handler("a");
+    auto missing = registry.dispatch("a", 0);
+    if (missing || missing.error() != "command not found: a" || registry.size() != 0) {
+        throw std::runtime_error("unregistered handler should be gone");
+    }
+}
+
+BASICPP_TEST(ConcurrentRegistryStress) {
+    registry_t registry;
+    constexpr std::uint64_t stable_keys = 16;
+    for (std::uint64_t i = 0; i < stable_keys; ++i) {
+        registry.register_handler("stable" + std::to_string(i), make_handler(i));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> failures{0};
+    std::atomic<std::uint64_t> dispatched{0};
+
+    const auto reader_count = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<std::thread> readers;
+    for (unsigned t = 0; t < reader_count; ++t) {
+        readers.emplace_back([&, t] {
+            std::uint64_t local = 0;
+            for (std::uint64_t i = t; !stop.load(std::memory_order_relaxed); ++i) {
+                const auto key = i % (stable_keys + 4);
+                if (key < stable_keys) {
+                    // Stable keys are only ever replaced by handlers with the same value.
+                    auto result = registry.dispatch("stable" + std::to_string(key), 7);
+                    if (!result || result.value() != key * 1000 + 7) {
+                        failures.fetch_add(1);
+                    }
+                } else {
+                    // Churned keys may be present or absent, but never reclaimed while running.
+                    auto result = registry.dispatch("churn" + std::to_string(key), 7);
+                    if (!result && result.error().rfind("command not found", 0) != 0) {
+                        failures.fetch_add(1);
+                    }
+                }
+                ++local;
+            }
+            dispatched.fetch_add(local);
+        });
+    }
+
+    std::thread writer([&] {
+        for (std::uint64_t round = 0; round < 400; ++round) {
+            const auto key = round % stable_keys;
+            registry.register_handler("stable" + std::to_string(key), make_handler(key));
+            registry.register_handler("churn" + std::to_string(stable_keys + round % 4), make_handler(round));
+            if (round % 3 == 0) {
+                registry.unregister_handler("churn" + std::to_string(stable_keys + (round + 1) % 4));
+            }
+        }
+        stop.store(true);
+    });
+
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    if (failures.load() != 0) {
+        throw std::runtime_error("concurrent dispatch observed " + std::to_string(failures.load()) + " failures");
+    }
+    if (dispatched.load() == 0) {
+        throw std::runtime_error("readers made no progress");
+    }
+}
+
+BASICPP_TEST_MAIN()
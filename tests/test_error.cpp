@@ -0,0 +1,108 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/error.hpp>
+#include <basicpp/state/state_machine.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{0};
+
+} // namespace
+
+// Counting allocator so the tests below can assert that failure paths stay allocation-free.
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+using basicpp::core::errc;
+using basicpp::core::error;
+
+static_assert(std::is_trivially_copyable_v<error>);
+static_assert(sizeof(error) <= 64);
+static_assert(std::is_trivially_copyable_v<basicpp::core::result<int, error>>);
+
+BASICPP_TEST(ErrorFormatsOnDemand) {
+    constexpr error missing(errc::command_not_found, "command not found", "jump");
+    static_assert(missing.code() == errc::command_not_found);
+    static_assert(missing.payload() == "jump");
+
+    if (missing.to_string() != "command not found: jump") {
+        throw std::runtime_error("unexpected error text: " + missing.to_string());
+    }
+
+    const error bare(errc::transition_not_found, "transition not found");
+    if (bare.to_string() != "transition not found" || !(bare == errc::transition_not_found)) {
+        throw std::runtime_error("payload-free error should print its message only");
+    }
+
+    const std::string long_key(100, 'k');
+    const error cut(errc::command_not_found, "command not found", long_key);
+    if (!cut.truncated() || cut.payload().size() != error::payload_capacity ||
+        cut.to_string() != "command not found: " + long_key.substr(0, error::payload_capacity) + "...") {
+        throw std::runtime_error("long payload should be truncated");
+    }
+}
+
+BASICPP_TEST(StringPoliciesKeepExistingMessages) {
+    basicpp::command::registry<int> registry;
+    auto missing = registry.dispatch("missing");
+    if (missing || missing.error() != "command not found: missing") {
+        throw std::runtime_error("string registry message changed");
+    }
+
+    basicpp::state::state_machine<std::string, std::string> machine{"idle"};
+    auto rejected = machine.dispatch("stop");
+    if (rejected || rejected.error() != "transition not found") {
+        throw std::runtime_error("string state machine message changed");
+    }
+}
+
+BASICPP_TEST(ErrorPoliciesDoNotAllocateOnFailure) {
+    using registry_t = basicpp::command::basic_registry<basicpp::command::registry_policy<error>, int>;
+    using machine_t = basicpp::state::state_machine<int, int, basicpp::state::state_machine_policy<error>>;
+
+    registry_t registry;
+    registry.register_handler("answer", [] { return registry_t::handler_result::ok(42); });
+    machine_t machine{0};
+    machine.add_transition(0, 1, 1);
+
+    const std::string key = "a key that does not fit in the small string buffer";
+    const auto before = allocation_count.load();
+    auto missing = registry.dispatch(key);
+    auto rejected = machine.dispatch(7);
+    const auto after = allocation_count.load();
+
+    if (after != before) {
+        throw std::runtime_error("failed dispatch allocated");
+    }
+    if (missing || missing.error().code() != errc::command_not_found) {
+        throw std::runtime_error("expected command_not_found");
+    }
+    if (rejected || rejected.error().code() != errc::transition_not_found || machine.current_state() != 0) {
+        throw std::runtime_error("expected transition_not_found");
+    }
+    if (missing.error().to_string().rfind("command not found: a key", 0) != 0) {
+        throw std::runtime_error("unexpected lazily formatted message");
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <basicpp/core/flat_hash_map.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using string_map = basicpp::core::flat_hash_map<std::string, int, basicpp::core::string_hash, std::equal_to<>>;
+
+BASICPP_TEST(FlatHashMapTransparentLookup) {
+    string_map map;
+    map.try_emplace("alpha", 1);
+    map.try_emplace(std::string("beta"), 2);
+
+    const char* raw = "alpha";
+    std::string_view view = "beta";
+    if (!map.contains(raw) || *map.find(view) != 2 || map.find("gamma") != nullptr) {
+        throw std::runtime_error("transparent lookup failed");
+    }
+
+    auto [value, inserted] = map.try_emplace("alpha", 10);
+    if (inserted || *value != 1) {
+        throw std::runtime_error("try_emplace should keep the existing value");
+    }
+
+    map.insert_or_assign("alpha", 10);
+    if (*map.find("alpha") != 10 || map.size() != 2) {
+        throw std::runtime_error("insert_or_assign should overwrite");
+    }
+}
+
+BASICPP_TEST(FlatHashMapMatchesReferenceUnderChurn) {
+    // Integer keys with a deliberately weak hash stress long probe runs and backward-shift deletion.
+    struct clustered_hash {
+        std::size_t operator()(std::uint32_t key) const noexcept {
+            return key % 17;
+        }
+    };
+
+    basicpp::core::flat_hash_map<std::uint32_t, std::uint32_t, clustered_hash> map;
+    std::unordered_map<std::uint32_t, std::uint32_t> reference;
+
+    std::uint64_t state = 0x12345678u;
+    for (int step = 0; step < 20000; ++step) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto key = static_cast<std::uint32_t>((state >> 33) % 512);
+        if ((state >> 20) % 3 == 0) {
+            if (map.erase(key) != (reference.erase(key) == 1)) {
+                throw std::runtime_error("erase disagreed with reference");
+            }
+        } else {
+            map.insert_or_assign(key, static_cast<std::uint32_t>(step));
+            reference[key] = static_cast<std::uint32_t>(step);
+        }
+
+        if (map.size() != reference.size()) {
+            throw std::runtime_error("size disagreed with reference");
+        }
+    }
+
+    for (const auto& [key, value] : reference) {
+        const auto* found = map.find(key);
+        if (!found || *found != value) {
+            throw std::runtime_error("lookup disagreed with reference");
+        }
+    }
+
+    std::size_t visited = 0;
+    map.for_each([&](std::uint32_t key, std::uint32_t value) {
+        ++visited;
+        if (reference.at(key) != value) {
+            throw std::runtime_error("for_each yielded a stale value");
+        }
+    });
+    if (visited != reference.size()) {
+        throw std::runtime_error("for_each missed elements");
+    }
+}
+
+BASICPP_TEST(FlatHashMapOwnsNonTrivialValues) {
+    basicpp::core::flat_hash_map<int, std::shared_ptr<int>> map;
+    auto tracked = std::make_shared<int>(7);
+    for (int i = 0; i < 100; ++i) {
+        map.try_emplace(i, tracked);
+    }
+    for (int i = 0; i < 50; ++i) {
+        map.erase(i);
+    }
+
+    auto copy = map;
+    if (tracked.use_count() != 101 || copy.size() != 50) {
+        throw std::runtime_error("copies should share ownership of the remaining values");
+    }
+
+    copy.clear();
+    map = std::move(copy);
+    if (tracked.use_count() != 1 || !map.empty()) {
+        throw std::runtime_error("clear and move-assign should release values");
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -0,0 +1,144 @@
+#include <array>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <basicpp/command/registry.hpp>
+#include <basicpp/core/function_ref.hpp>
+#include <basicpp/core/inplace_function.hpp>
+#include <basicpp/history/coalescer.hpp>
+#include <basicpp/state/state_machine.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using basicpp::core::function_ref;
+using basicpp::core::inplace_function;
+
+namespace {
+
+int twice(int value) {
+    return value * 2;
+}
+
+struct counted {
+    static inline int alive = 0;
+    counted() { ++alive; }
+    counted(const counted&) { ++alive; }
+    counted(counted&&) noexcept { ++alive; }
+    ~counted() { --alive; }
+};
+
+} // namespace
+
+static_assert(!std::is_copy_constructible_v<inplace_function<void(), 16>>);
+static_assert(std::is_nothrow_move_constructible_v<inplace_function<void(), 16>>);
+
+BASICPP_TEST(InplaceFunctionStoresMoveOnlyCallables) {
+    auto owned = std::make_unique<int>(40);
+    inplace_function<int(int), 16> fn = [p = std::move(owned)](int add) { return *p + add; };
+    if (!fn || fn(2) != 42) {
+        throw std::runtime_error("move-only capture should be callable");
+    }
+
+    auto moved = std::move(fn);
+    if (fn || !moved || moved(1) != 41) {
+        throw std::runtime_error("move should transfer the callable and empty the source");
+    }
+
+    inplace_function<int(int), 16> pointer = &twice;
+    if (pointer(21) != 42) {
+        throw std::runtime_error("function pointer should be callable");
+    }
+
+    inplace_function<int(int), 16> empty = static_cast<int (*)(int)>(nullptr);
+    bool threw = false;
+    try {
+        (void)empty(1);
+    } catch (const std::bad_function_call&) {
+        threw = true;
+    }
+    if (empty || !threw) {
+        throw std::runtime_error("null function pointer should leave the wrapper empty");
+    }
+}
+
+BASICPP_TEST(InplaceFunctionDestroysItsCallable) {
+    {
+        inplace_function<void(), 32> fn = [c = counted{}] { (void)c; };
+        if (counted::alive != 1) {
+            throw std::runtime_error("expected exactly one live capture");
+        }
+        inplace_function<void(), 32> other = std::move(fn);
+        other = nullptr;
+        if (counted::alive != 0) {
+            throw std::runtime_error("reset should destroy the capture");
+        }
+        other = [c = counted{}] { (void)c; };
+    }
+    if (counted::alive != 0) {
+        throw std::runtime_error("destructor should destroy the capture");
+    }
+}
+
+BASICPP_TEST(FunctionRefCallsWithoutOwning) {
+    int calls = 0;
+    auto counter = [&calls](int step) { calls += step; };
+    function_ref<void(int)> ref = counter;
+    ref(2);
+    ref(3);
+
+    function_ref<int(int)> free_fn = twice;
+    if (calls != 5 || free_fn(4) != 8) {
+        throw std::runtime_error("function_ref should forward calls");
+    }
+}
+
+BASICPP_TEST(ComponentsAcceptInplacePolicies) {
+    using registry_t =
+        basicpp::command::basic_registry<basicpp::command::inplace_registry_policy<basicpp::core::error, 48>, int>;
+
+    registry_t registry;
+    std::array<int, 8> table{1, 2, 3, 4, 5, 6, 7, 8};
+    registry.register_handler("sum", [table] {
+        int total = 0;
+        for (int v : table) {
+            total += v;
+        }
+        return registry_t::handler_result::ok(total);
+    });
+    registry.register_handler("owned", [p = std::make_unique<int>(9)] { return registry_t::handler_result::ok(*p); });
+
+    if (registry.dispatch("sum").value() != 36 || registry.dispatch("owned").value() != 9) {
+        throw std::runtime_error("inplace registry dispatch failed");
+    }
+
+    std::vector<std::string_view> keys;
+    registry.for_each_key([&](std::string_view key) { keys.push_back(key); });
+    if (keys.size() != 2) {
+        throw std::runtime_error("for_each_key should visit every key");
+    }
+
+    using machine_t = basicpp::state::state_machine<int, int, basicpp::state::inplace_state_machine_policy<>>;
+    machine_t machine{0};
+    machine.add_transition(0, 1, 1);
+    int seen = -1;
+    machine.on_transition([&seen](const int&, const int& to, const int&) { seen = to; });
+    if (!machine.dispatch(1) || seen != 1) {
+        throw std::runtime_error("inplace callback should run");
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto sum = basicpp::history::make_coalescer<int>(std::chrono::milliseconds(10),
+                                                     [](const int& a, const int& b) { return a + b; });
+    const auto start = clock::time_point{};
+    sum.push(1, start);
+    sum.push(2, start);
+    auto value = sum.consume(start + std::chrono::milliseconds(10));
+    if (!value || *value != 3) {
+        throw std::runtime_error("lambda-typed coalescer should combine");
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -0,0 +1,120 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <basicpp/testing/selftest.hpp>
+
+#include "frontend/interface.hpp"
+#include "frontend/lexer.hpp"
+#include "frontend/parser.hpp"
+
+namespace {
+
+using basicpp::frontend::lexer;
+using basicpp::frontend::parser;
+
+basicpp::frontend::ast::module_decl parse(std::string_view source) {
+    auto tokens = lexer::tokenize(source);
+    if (!tokens) {
+        throw std::runtime_error("lexer failed");
+    }
+    auto module = parser::parse_module(tokens.value());
+    if (!module) {
+        throw std::runtime_error("parser failed: " + module.error());
+    }
+    return module.value();
+}
+
+constexpr std::string_view sample_source =
+    "module Player\n"
+    "import Lib.Audio\n"
+    "const Volume = 11\n"
+    "const Title = \"Main\"\n"
+    "state Transport = Stopped\n"
+    "on Play => Playing\n"
+    "on Stop => Stopped\n"
+    "command Seek(position)\n"
+    "let target = position\n"
+    "end command\n"
+    "function Duration(track) as Float\n"
+    "return 1.5\n"
+    "end function\n";
+
+} // namespace
+
+BASICPP_TEST(InterfaceRoundTripsDeclarationsWithoutBodies) {
+    const auto module = parse(sample_source);
+    const auto text = basicpp::frontend::write_interface(module);
+
+    if (text.find("let target") != std::string::npos || text.find("1.5") != std::string::npos) {
+        throw std::runtime_error("interface should not contain bodies");
+    }
+    if (text.find("// states: Stopped, Playing") == std::string::npos ||
+        text.find("// events: Play, Stop") == std::string::npos) {
+        throw std::runtime_error("interface should list states and events");
+    }
+
+    auto summary = basicpp::frontend::read_interface(text);
+    if (!summary) {
+        throw std::runtime_error("failed to read interface: " + summary.error());
+    }
+
+    const auto& value = summary.value();
+    if (value.name != "Player" || value.imports.size() != 1 || value.imports[0].path != "Lib.Audio") {
+        throw std::runtime_error("module header did not round-trip");
+    }
+    if (value.constants.size() != 2 || value.constants[1].value.lexeme != "Main") {
+        throw std::runtime_error("constants did not round-trip");
+    }
+    if (value.states.size() != 1 || value.states[0].transitions.size() != 2) {
+        throw std::runtime_error("state machine did not round-trip");
+    }
+    if (value.commands.size() != 1 || value.commands[0].parameters.size() != 1 ||
+        !value.commands[0].body_tokens.empty()) {
+        throw std::runtime_error("command signature did not round-trip");
+    }
+    if (value.functions.size() != 1 || value.functions[0].return_type.value_or("") != "Float") {
+        throw std::runtime_error("function signature did not round-trip");
+    }
+
+    if (basicpp::frontend::write_interface(value) != text) {
+        throw std::runtime_error("interface text should be stable across round-trips");
+    }
+}
+
+BASICPP_TEST(InterfaceIgnoresBodyOnlyChanges) {
+    std::string edited(sample_source);
+    edited.replace(edited.find("return 1.5"), 10, "return 2.5");
+
+    const auto original = basicpp::frontend::write_interface(parse(sample_source));
+    const auto changed = basicpp::frontend::write_interface(parse(edited));
+    if (original != changed) {
+        throw std::runtime_error("body edits should not change the interface");
+    }
+}
+
+BASICPP_TEST(InterfaceRoundTripsStateHierarchy) {
+    const auto module = parse("module Net\n"
+                              "state Link = Offline\n"
+                              "in Online: Idle, Busy\n"
+                              "on Connect => Online\n"
+                              "on Drop in Online => Offline\n");
+    const auto text = basicpp::frontend::write_interface(module);
+    if (text.find("in Online: Idle, Busy\n") == std::string::npos ||
+        text.find("on Drop in Online => Offline\n") == std::string::npos) {
+        throw std::runtime_error("interface should keep groups and explicit sources");
+    }
+
+    auto summary = basicpp::frontend::read_interface(text);
+    if (!summary || basicpp::frontend::write_interface(summary.value()) != text) {
+        throw std::runtime_error("state hierarchy did not round-trip");
+    }
+}
+
+BASICPP_TEST(InterfaceRejectsPlainSources) {
+    if (basicpp::frontend::read_interface(sample_source)) {
+        throw std::runtime_error("sources without the bppi header should be rejected");
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -0,0 +1,85 @@
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <basicpp/testing/selftest.hpp>
+
+#include "cli/module_graph.hpp"
+
+using basicpp::cli::module_graph;
+
+BASICPP_TEST(ModuleGraphGroupsIndependentModulesIntoLevels) {
+    module_graph graph;
+    const auto app = graph.add_node("App");
+    const auto ui = graph.add_node("Ui");
+    const auto net = graph.add_node("Net");
+    const auto core = graph.add_node("Core");
+    graph.add_dependency(app, ui);
+    graph.add_dependency(app, net);
+    graph.add_dependency(ui, core);
+    graph.add_dependency(net, core);
+
+    auto levels = graph.topological_levels();
+    if (!levels) {
+        throw std::runtime_error("expected acyclic graph to sort");
+    }
+
+    const auto& value = levels.value();
+    if (value.size() != 3) {
+        throw std::runtime_error("unexpected level count");
+    }
+    if (value[0] != std::vector<std::size_t>{core}) {
+        throw std::runtime_error("leaf module should come first");
+    }
+    if (value[1].size() != 2) {
+        throw std::runtime_error("independent modules should share a level");
+    }
+    if (value[2] != std::vector<std::size_t>{app}) {
+        throw std::runtime_error("root module should come last");
+    }
+}
+
+BASICPP_TEST(ModuleGraphReportsCycles) {
+    module_graph graph;
+    const auto a = graph.add_node("A");
+    const auto b = graph.add_node("B");
+    const auto c = graph.add_node("C");
+    graph.add_dependency(a, b);
+    graph.add_dependency(b, c);
+    graph.add_dependency(c, b);
+
+    auto levels = graph.topological_levels();
+    if (levels) {
+        throw std::runtime_error("cycle should be rejected");
+    }
+    if (levels.error().find("B -> C -> B") == std::string::npos &&
+        levels.error().find("C -> B -> C") == std::string::npos) {
+        throw std::runtime_error("cycle message should name the cycle: " + levels.error());
+    }
+}
+
+BASICPP_TEST(ResolveImportSearchesDirectoriesInOrder) {
+    const auto base = std::filesystem::current_path() / "module_graph_test";
+    std::error_code ec;
+    std::filesystem::remove_all(base, ec);
+    std::filesystem::create_directories(base / "first");
+    std::filesystem::create_directories(base / "second" / "Lib");
+    std::ofstream(base / "second" / "Lib" / "Util.bpp") << "module Util\n";
+
+    const std::vector<std::filesystem::path> search_paths{base / "first", base / "second"};
+    auto resolved = basicpp::cli::resolve_import("Lib.Util", search_paths);
+    if (!resolved || resolved->filename() != "Util.bpp") {
+        throw std::runtime_error("expected import to resolve in the second directory");
+    }
+
+    if (basicpp::cli::resolve_import("Basicpp.Command", search_paths)) {
+        throw std::runtime_error("runtime imports should stay unresolved");
+    }
+
+    std::filesystem::remove_all(base, ec);
+}
+
+BASICPP_TEST_MAIN()
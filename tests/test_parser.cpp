@@ -1,5 +1,6 @@
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <basicpp/testing/selftest.hpp>
 
@@ -147,6 +148,54 @@ BASICPP_TEST(ParserParsesStateMachine) {
     }
 }
 
+BASICPP_TEST(ParserParsesStateHierarchy) {
+    const std::string source =
+        "module App\n"
+        "state Link = Offline\n"
+        "in Online: Idle, Busy\n"
+        "on Connect => Online\n"
+        "on Drop in Online => Offline\n";
+
+    auto tokens = lexer::tokenize(source);
+    if (!tokens) {
+        throw std::runtime_error("lexer failed");
+    }
+
+    auto module = parser::parse_module(tokens.value());
+    if (!module) {
+        throw std::runtime_error("parser failed: " + module.error());
+    }
+
+    const auto& state = module.value().states.at(0);
+    if (state.groups.size() != 1 || state.groups[0].parent != "Online" ||
+        state.groups[0].children != std::vector<std::string>{"Idle", "Busy"}) {
+        throw std::runtime_error("unexpected state group");
+    }
+    if (state.transitions.size() != 2 || state.transitions[0].source_state ||
+        state.transitions[1].source_state.value_or("") != "Online") {
+        throw std::runtime_error("unexpected transition sources");
+    }
+}
+
+BASICPP_TEST(ParserRejectsStateHierarchyCycle) {
+    const std::string source =
+        "module App\n"
+        "state Link = Idle\n"
+        "in Online: Idle\n"
+        "in Idle: Online\n"
+        "on Start => Busy\n";
+
+    auto tokens = lexer::tokenize(source);
+    if (!tokens) {
+        throw std::runtime_error("lexer failed");
+    }
+
+    auto module = parser::parse_module(tokens.value());
+    if (module || module.error() != "state 'Online' cannot contain itself") {
+        throw std::runtime_error("hierarchy cycles should be rejected");
+    }
+}
+
 BASICPP_TEST(ParserRejectsStateWithoutTransition) {
     const std::string source = "module App\nstate AppState = Idle\n";
     auto tokens = lexer::tokenize(source);
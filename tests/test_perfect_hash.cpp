@@ -0,0 +1,85 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <basicpp/command/static_registry.hpp>
+#include <basicpp/core/perfect_hash.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+namespace {
+
+constexpr basicpp::core::static_perfect_hash<5> colours({"red", "green", "blue", "cyan", "magenta"});
+
+static_assert(colours.find("red") == 0);
+static_assert(colours.find("magenta") == 4);
+static_assert(colours.find("black") == colours.npos);
+static_assert(basicpp::core::static_perfect_hash<0>({}).find("x") == 0);
+
+using commands_t = basicpp::command::static_registry<3, int, int>;
+
+constexpr commands_t::handler_result add_one(int value) {
+    return commands_t::handler_result::ok(value + 1);
+}
+
+constexpr commands_t::handler_result twice(int value) {
+    return commands_t::handler_result::ok(value * 2);
+}
+
+constexpr commands_t::handler_result negate(int value) {
+    return commands_t::handler_result::ok(-value);
+}
+
+constexpr commands_t commands{{{{"inc", &add_one}, {"double", &twice}, {"neg", &negate}}}};
+
+static_assert(commands.dispatch("double", 21).value() == 42);
+static_assert(commands.contains("neg") && !commands.contains("nope"));
+static_assert(commands.dispatch("nope", 1).error().code() == basicpp::core::errc::command_not_found);
+
+} // namespace
+
+BASICPP_TEST(PerfectHashFindsEveryKeyAndRejectsOthers) {
+    std::vector<std::string> storage;
+    for (int i = 0; i < 10000; ++i) {
+        storage.push_back("key." + std::to_string(i * 31));
+    }
+    std::vector<std::string_view> keys(storage.begin(), storage.end());
+
+    basicpp::core::perfect_hash table;
+    if (!table.build(keys) || table.size() != keys.size()) {
+        throw std::runtime_error("build failed");
+    }
+
+    for (std::uint32_t i = 0; i < keys.size(); ++i) {
+        if (table.find(keys[i]) != i) {
+            throw std::runtime_error("lookup returned the wrong index for " + storage[i]);
+        }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (table.find("other." + std::to_string(i)) != basicpp::core::perfect_hash::npos) {
+            throw std::runtime_error("non-member key was found");
+        }
+    }
+}
+
+BASICPP_TEST(PerfectHashRejectsDuplicatesAndHandlesEmptySets) {
+    basicpp::core::perfect_hash table;
+    std::array<std::string_view, 3> duplicated{"a", "b", "a"};
+    if (table.build(duplicated) || table.size() != 0 || table.find("a") != basicpp::core::perfect_hash::npos) {
+        throw std::runtime_error("duplicate keys should fail to build");
+    }
+
+    std::array<std::uint32_t, 2> values{70, 80};
+    std::array<std::string_view, 2> pair{"x", "y"};
+    if (!table.build(pair, values) || table.find("y") != 80) {
+        throw std::runtime_error("explicit values should be returned");
+    }
+
+    if (!table.build({}) || table.find("x") != basicpp::core::perfect_hash::npos) {
+        throw std::runtime_error("empty build should succeed and find nothing");
+    }
+}
+
+BASICPP_TEST_MAIN()
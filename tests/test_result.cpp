@@ -0,0 +1,154 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <basicpp/core/result.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+using basicpp::core::result;
+
+static_assert(std::is_trivially_copyable_v<result<int, int>>);
+static_assert(std::is_trivially_destructible_v<result<int, int>>);
+static_assert(std::is_trivially_copyable_v<result<void, int>>);
+static_assert(!std::is_trivially_destructible_v<result<std::string, int>>);
+static_assert(sizeof(result<int, int>) == 2 * sizeof(int));
+static_assert(sizeof(result<std::string, std::string>) <= sizeof(std::string) + alignof(std::string));
+static_assert(!std::is_copy_constructible_v<result<std::unique_ptr<int>, int>>);
+static_assert(std::is_nothrow_move_constructible_v<result<std::string, int>>);
+
+namespace {
+
+constexpr result<int, int> halve(int value) {
+    if (value % 2 != 0) {
+        return result<int, int>::err(value);
+    }
+    return result<int, int>::ok(value / 2);
+}
+
+constexpr int constexpr_chain() {
+    auto r = halve(40).and_then(halve).transform([](int v) { return v + 1; });
+    auto copy = r;
+    copy = halve(3);
+    return r.value() * 100 + copy.error();
+}
+
+static_assert(constexpr_chain() == 1103);
+static_assert(result<int, int>().value() == 0);
+static_assert(result<void, int>().has_value());
+
+} // namespace
+
+BASICPP_TEST(ResultAccessorsThrowOnMisuse) {
+    auto ok = result<std::string, std::string>::ok("value");
+    auto err = result<std::string, std::string>::err("boom");
+
+    if (!ok || ok.value() != "value" || err || err.error() != "boom") {
+        throw std::runtime_error("unexpected accessor results");
+    }
+    if (err.value_or("fallback") != "fallback" || ok.value_or("fallback") != "value") {
+        throw std::runtime_error("value_or mismatch");
+    }
+
+    bool threw = false;
+    try {
+        (void)err.value();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("value() on error should throw");
+    }
+
+    threw = false;
+    try {
+        (void)ok.error();
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("error() on value should throw");
+    }
+}
+
+BASICPP_TEST(ResultAssignmentSwitchesAlternatives) {
+    auto r = result<std::string, std::string>::ok("first");
+    r = result<std::string, std::string>::err("second");
+    if (r || r.error() != "second") {
+        throw std::runtime_error("assignment should switch to error");
+    }
+
+    const auto ok = result<std::string, std::string>::ok("third");
+    r = ok;
+    if (!r || r.value() != "third" || ok.value() != "third") {
+        throw std::runtime_error("copy assignment should switch to value");
+    }
+
+    auto v = result<void, std::string>::err("bad");
+    v = result<void, std::string>::ok();
+    if (!v) {
+        throw std::runtime_error("void result should become ok");
+    }
+    v = result<void, std::string>::err("again");
+    if (v || v.error() != "again") {
+        throw std::runtime_error("void result should become error");
+    }
+}
+
+BASICPP_TEST(ResultMonadicChainsMoveValues) {
+    using owned = result<std::unique_ptr<int>, std::string>;
+
+    auto chained = owned::ok(std::make_unique<int>(20))
+                       .and_then([](std::unique_ptr<int> p) {
+                           *p += 1;
+                           return owned::ok(std::move(p));
+                       })
+                       .transform([](std::unique_ptr<int> p) { return *p * 2; });
+    if (!chained || chained.value() != 42) {
+        throw std::runtime_error("and_then/transform should move through the chain");
+    }
+
+    bool called = false;
+    auto failed = owned::err("missing").and_then([&](std::unique_ptr<int> p) {
+        called = true;
+        return owned::ok(std::move(p));
+    });
+    if (called || failed || failed.error() != "missing") {
+        throw std::runtime_error("and_then should skip continuation on error");
+    }
+
+    auto recovered = std::move(failed).or_else([](std::string message) {
+        return owned::ok(std::make_unique<int>(static_cast<int>(message.size())));
+    });
+    if (!recovered || *recovered.value() != 7) {
+        throw std::runtime_error("or_else should recover from error");
+    }
+
+    auto relabelled = result<int, int>::err(5).transform_error([](int code) { return std::to_string(code); });
+    if (relabelled || relabelled.error() != "5") {
+        throw std::runtime_error("transform_error should map the error");
+    }
+}
+
+BASICPP_TEST(ResultVoidMonadicOperations) {
+    using status = result<void, std::string>;
+
+    auto value = status::ok().and_then([] { return result<int, std::string>::ok(3); });
+    if (!value || value.value() != 3) {
+        throw std::runtime_error("void and_then should run continuation");
+    }
+
+    int calls = 0;
+    auto unit = result<int, std::string>::ok(1).transform([&](int) { ++calls; });
+    static_assert(std::is_same_v<decltype(unit), status>);
+    if (!unit || calls != 1) {
+        throw std::runtime_error("transform returning void should yield result<void, E>");
+    }
+
+    auto recovered = status::err("x").or_else([](const std::string&) { return status::ok(); });
+    if (!recovered) {
+        throw std::runtime_error("void or_else should recover");
+    }
+}
+
+BASICPP_TEST_MAIN()
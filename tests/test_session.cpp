@@ -0,0 +1,149 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <basicpp/testing/selftest.hpp>
+
+#include "codegen/generator.hpp"
+#include "frontend/lexer.hpp"
+#include "frontend/parser.hpp"
+#include "frontend/session.hpp"
+
+namespace {
+
+using basicpp::frontend::diagnostic_phase;
+using basicpp::frontend::diagnostic_severity;
+using basicpp::frontend::transpile_options;
+using basicpp::frontend::transpiler_session;
+
+constexpr std::string_view sample_source =
+    "module Demo\n"
+    "const Version = \"0.1.0\"\n"
+    "state Machine = Idle\n"
+    "on Start => Running\n"
+    "command SayHello(name)\n"
+    "return\n"
+    "end command\n";
+
+std::string reference_output(std::string_view source) {
+    auto tokens = basicpp::frontend::lexer::tokenize(source);
+    auto module = basicpp::frontend::parser::parse_module(tokens.value());
+    return basicpp::codegen::generate_translation_unit(module.value()).value();
+}
+
+} // namespace
+
+BASICPP_TEST(SessionMatchesStandalonePipeline) {
+    transpiler_session session;
+    auto output = session.transpile(sample_source, {true});
+    if (!output) {
+        throw std::runtime_error("session transpile failed: " + output.error().message);
+    }
+
+    if (output.value().cpp_source != reference_output(sample_source)) {
+        throw std::runtime_error("session output differs from the standalone pipeline");
+    }
+    if (output.value().interface_summary.find("command SayHello(name)") == std::string_view::npos) {
+        throw std::runtime_error("missing interface summary");
+    }
+    if (output.value().module == nullptr || output.value().module->name != "Demo") {
+        throw std::runtime_error("missing module view");
+    }
+}
+
+BASICPP_TEST(SessionReusesBuffersAcrossCalls) {
+    transpiler_session session;
+    auto first = session.transpile(sample_source);
+    if (!first) {
+        throw std::runtime_error("first transpile failed");
+    }
+    const auto* first_buffer = first.value().cpp_source.data();
+
+    auto second = session.transpile("module Small\n");
+    if (!second) {
+        throw std::runtime_error("second transpile failed");
+    }
+    if (second.value().cpp_source.data() != first_buffer) {
+        throw std::runtime_error("smaller output should reuse the existing buffer");
+    }
+    if (second.value().cpp_source.find("// Module: Small") == std::string_view::npos) {
+        throw std::runtime_error("second output not regenerated");
+    }
+}
+
+BASICPP_TEST(SessionReportsStructuredDiagnostics) {
+    transpiler_session session;
+
+    auto lex_failure = session.transpile("module Demo\nconst Name = \"open\n");
+    if (lex_failure) {
+        throw std::runtime_error("unterminated string should fail");
+    }
+    const auto& lex_error = lex_failure.error();
+    if (lex_error.phase != diagnostic_phase::lexer || lex_error.line != 2 || lex_error.column != 14) {
+        throw std::runtime_error("lexer diagnostic should point at the string literal");
+    }
+
+    auto parse_failure = session.transpile("module Demo\nconst = 1\n");
+    if (parse_failure) {
+        throw std::runtime_error("missing constant name should fail");
+    }
+    const auto& parse_error = parse_failure.error();
+    if (parse_error.phase != diagnostic_phase::parser || parse_error.line != 2 || parse_error.column != 7) {
+        throw std::runtime_error("parser diagnostic should point at the unexpected token");
+    }
+    if (session.diagnostics().size() != 1) {
+        throw std::runtime_error("diagnostics should describe the last call only");
+    }
+}
+
+BASICPP_TEST(SessionReportsStateWarnings) {
+    transpiler_session session;
+    constexpr std::string_view source = "module Demo\nstate Machine = Idle\nin Spare: Ghost\non Start => Busy\n";
+
+    transpile_options checking{};
+    checking.check_states = true;
+    auto checked = session.transpile(source, checking);
+    if (!checked || checked.value().diagnostics.size() != 1) {
+        throw std::runtime_error("an unreachable state should produce one warning");
+    }
+    const auto& warning = checked.value().diagnostics[0];
+    if (warning.severity != diagnostic_severity::warning || warning.phase != diagnostic_phase::codegen ||
+        warning.message != "state Machine: 'Ghost' is unreachable from 'Idle'") {
+        throw std::runtime_error("unexpected state warning");
+    }
+
+    auto unchecked = session.transpile(source);
+    if (!unchecked || !unchecked.value().diagnostics.empty()) {
+        throw std::runtime_error("state checks should be opt-in for sessions");
+    }
+}
+
+BASICPP_TEST(SessionsRunIndependentlyOnSeparateThreads) {
+    const auto expected = reference_output(sample_source);
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (std::size_t t = 0; t < mismatches.size(); ++t) {
+        threads.emplace_back([&, t] {
+            transpiler_session session;
+            for (int i = 0; i < 200; ++i) {
+                auto output = session.transpile(sample_source);
+                if (!output || output.value().cpp_source != expected) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int count : mismatches) {
+        if (count != 0) {
+            throw std::runtime_error("concurrent sessions produced divergent output");
+        }
+    }
+}
+
+BASICPP_TEST_MAIN()
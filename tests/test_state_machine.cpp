@@ -1,11 +1,76 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include <basicpp/state/concurrent_state_machine.hpp>
+#include <basicpp/state/dense_state_machine.hpp>
 #include <basicpp/state/state_machine.hpp>
+#include <basicpp/state/state_hierarchy.hpp>
+#include <basicpp/state/state_machine_pool.hpp>
+#include <basicpp/state/transition_trace.hpp>
 #include <basicpp/testing/selftest.hpp>
 
 using state_machine_t = basicpp::state::state_machine<std::string, std::string>;
 
+enum class door : std::uint8_t { closed, open, locked };
+enum class door_event : std::uint8_t { push, pull, lock, unlock, count };
+using door_table = basicpp::state::dense_transition_table<door, door_event, 3, 4>;
+using dense_door = basicpp::state::dense_state_machine<door, door_event, 3, 4>;
+
+namespace {
+
+constexpr door_table make_door_table() {
+    door_table table;
+    table.add_transition(door::closed, door_event::pull, door::open);
+    table.add_transition(door::open, door_event::push, door::closed);
+    table.add_transition(door::closed, door_event::lock, door::locked);
+    table.add_transition(door::locked, door_event::unlock, door::closed);
+    return table;
+}
+
+constexpr door_table door_transitions = make_door_table();
+
+static_assert(sizeof(door_table::cell_type) == 1);
+static_assert(door_transitions.contains(door::closed, door_event::pull));
+static_assert(!door_transitions.contains(door::locked, door_event::pull));
+
+enum class session : std::uint8_t { offline, online, idle, busy };
+enum class session_event : std::uint8_t { connect, start, finish, drop };
+using session_hierarchy = basicpp::state::state_hierarchy<session, session_event, 4, 4>;
+
+// idle and busy are substates of online; drop is declared once on the parent, and busy overrides it.
+constexpr session_hierarchy::table_type session_transitions = [] {
+    session_hierarchy hierarchy;
+    hierarchy.set_parent(session::idle, session::online);
+    hierarchy.set_parent(session::busy, session::online);
+    hierarchy.add_transition(session::offline, session_event::connect, session::online);
+    hierarchy.add_transition(session::idle, session_event::start, session::busy);
+    hierarchy.add_transition(session::busy, session_event::finish, session::idle);
+    hierarchy.add_transition(session::online, session_event::drop, session::offline);
+    hierarchy.add_transition(session::busy, session_event::drop, session::idle);
+    return hierarchy.build();
+}();
+
+static_assert(session_transitions.next(0, session_event::connect) == static_cast<std::uint8_t>(session::idle));
+static_assert(session_transitions.next(2, session_event::drop) == static_cast<std::uint8_t>(session::offline));
+static_assert(session_transitions.next(3, session_event::drop) == static_cast<std::uint8_t>(session::idle));
+
+// Observers are held by reference, so temporaries are rejected at compile time.
+template <typename Machine>
+concept accepts_temporary_observer = requires(Machine& machine) {
+    machine.add_observer([](const door&, const door&, const door_event&) {});
+};
+static_assert(!accepts_temporary_observer<dense_door>);
+
+} // namespace
+
 BASICPP_TEST(StateMachineTransitionsWhenMatchExists) {
     state_machine_t machine{"idle"};
     machine.add_transition("idle", "start", "running");
@@ -28,4 +93,275 @@ BASICPP_TEST(StateMachineFailsWhenTransitionMissing) {
     }
 }
 
+BASICPP_TEST(DenseStateMachineMatchesStateMachine) {
+    dense_door machine{door::closed, door_transitions};
+    std::vector<std::pair<door, door>> seen;
+    machine.on_transition([&](const door& from, const door& to, const door_event&) { seen.emplace_back(from, to); });
+
+    if (machine.dispatch(door_event::pull).value() != door::open || machine.current_state() != door::open) {
+        throw std::runtime_error("dense machine should follow the table");
+    }
+
+    auto rejected = machine.dispatch(door_event::lock);
+    if (rejected || rejected.error() != "transition not found" || machine.current_state() != door::open) {
+        throw std::runtime_error("missing transition should fail and keep the state");
+    }
+    if (machine.dispatch(door_event::count)) {
+        throw std::runtime_error("out-of-range events should be rejected");
+    }
+
+    machine.dispatch(door_event::push);
+    if (seen != std::vector<std::pair<door, door>>{{door::closed, door::open}, {door::open, door::closed}}) {
+        throw std::runtime_error("callbacks should see each transition after the state update");
+    }
+}
+
+BASICPP_TEST(DenseStateMachineBuildsAtRuntime) {
+    basicpp::state::dense_state_machine<int, int, 300, 2, basicpp::state::state_machine_policy<basicpp::core::error>>
+        machine{0};
+    static_assert(sizeof(decltype(machine)::table_type::cell_type) == 2);
+    for (int state = 0; state < 299; ++state) {
+        machine.add_transition(state, 0, state + 1);
+    }
+    if (machine.add_transition(5, 0, 7)) {
+        throw std::runtime_error("overwriting a transition should report no insertion");
+    }
+    if (machine.dispatch(0).value() != 1 || machine.dispatch(1).error() != basicpp::core::errc::transition_not_found) {
+        throw std::runtime_error("integer ids should index the table directly");
+    }
+
+    bool threw = false;
+    try {
+        machine.add_transition(0, 2, 1);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    if (!threw) {
+        throw std::runtime_error("ids outside the table should be rejected");
+    }
+}
+
+BASICPP_TEST(StateHierarchyFlattensParentTransitions) {
+    basicpp::state::dense_state_machine<session, session_event, 4, 4> machine{session::offline, session_transitions};
+    machine.dispatch(session_event::connect);
+    machine.dispatch(session_event::start);
+    if (machine.current_state() != session::busy || machine.dispatch(session_event::drop).value() != session::idle) {
+        throw std::runtime_error("a substate's own transition should win over its parent's");
+    }
+    if (machine.dispatch(session_event::drop).value() != session::offline || machine.dispatch(session_event::start)) {
+        throw std::runtime_error("substates should inherit parent transitions");
+    }
+
+    session_hierarchy hierarchy;
+    hierarchy.set_parent(session::idle, session::online);
+    bool rejected = false;
+    try {
+        hierarchy.set_parent(session::online, session::idle);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    if (!rejected || hierarchy.parent(session::online) != session_hierarchy::no_state) {
+        throw std::runtime_error("cycles in the hierarchy should be rejected");
+    }
+}
+
+BASICPP_TEST(StateMachineNotifiesEveryObserver) {
+    state_machine_t machine{"idle"};
+    machine.add_transition("idle", "start", "running");
+    machine.add_transition("running", "stop", "idle");
+
+    std::vector<std::string> log;
+    auto first = [&](const std::string&, const std::string& to, const std::string&) { log.push_back("a:" + to); };
+    auto second = [&](const std::string&, const std::string& to, const std::string&) { log.push_back("b:" + to); };
+    if (!machine.add_observer(first) || !machine.add_observer(second)) {
+        throw std::runtime_error("observers should fit");
+    }
+    machine.dispatch("start");
+    machine.remove_observer(first);
+    machine.dispatch("stop");
+
+    if (log != std::vector<std::string>{"a:running", "b:running", "b:idle"}) {
+        throw std::runtime_error("observers should run in order until removed");
+    }
+}
+
+BASICPP_TEST(TransitionTraceKeepsNewestTransitions) {
+    dense_door machine{door::closed, door_transitions};
+    basicpp::state::transition_trace<door, door_event, 4> trace;
+    using index_t = decltype(trace)::index_type;
+    machine.add_observer(trace);
+    for (int i = 0; i < 3; ++i) {
+        machine.dispatch(door_event::pull);
+        machine.dispatch(door_event::push);
+    }
+    machine.dispatch(door_event::unlock); // rejected transitions are not recorded
+
+    if (trace.recorded() != 6 || trace.size() != 4) {
+        throw std::runtime_error("trace should count every transition and keep the newest four");
+    }
+
+    std::vector<std::uint64_t> sequences;
+    trace.for_each([&](std::uint64_t sequence, const auto& entry) {
+        sequences.push_back(sequence);
+        const bool opened = sequence % 2 == 0;
+        if (entry.event != static_cast<index_t>(opened ? door_event::pull : door_event::push) ||
+            entry.to != static_cast<index_t>(opened ? door::open : door::closed)) {
+            throw std::runtime_error("unexpected trace entry");
+        }
+    });
+    if (sequences != std::vector<std::uint64_t>{2, 3, 4, 5}) {
+        throw std::runtime_error("trace should be visited oldest first");
+    }
+
+    std::string text;
+    trace.dump([&](std::string_view line) { text += line; });
+    if (text.rfind("#2 +0 0 -> 1 on 1\n#3 +", 0) != 0 || std::count(text.begin(), text.end(), '\n') != 4) {
+        throw std::runtime_error("unexpected trace dump:\n" + text);
+    }
+
+    std::array<decltype(trace)::entry, 2> newest{};
+    if (trace.copy_to(newest) != 2 || newest[1].to != static_cast<index_t>(door::closed)) {
+        throw std::runtime_error("copy_to should return the newest entries");
+    }
+
+    // Ids wider than 16 bits are kept whole, in entries and in the dump.
+    basicpp::state::transition_trace<std::uint32_t, std::uint32_t, 2> wide;
+    wide.record(70000, 4'000'000'000u, 65536);
+    text.clear();
+    wide.dump([&](std::string_view line) { text += line; });
+    if (text != "#0 +0 70000 -> 4000000000 on 65536\n") {
+        throw std::runtime_error("wide ids should not be truncated:\n" + text);
+    }
+}
+
+BASICPP_TEST(StateMachinePoolDispatchesBatches) {
+    using pool_t = basicpp::state::state_machine_pool<door, door_event, 3, 4>;
+    pool_t pool{door_transitions, 4, door::closed};
+    if (pool.states().size_bytes() != 4) {
+        throw std::runtime_error("each instance should take one byte");
+    }
+
+    const std::vector<door_event> events{door_event::pull, door_event::lock, door_event::push, door_event::count};
+    if (pool.dispatch_all(events) != 2) {
+        throw std::runtime_error("only instances with a matching transition should move");
+    }
+    if (pool.current_state(0) != door::open || pool.current_state(1) != door::locked ||
+        pool.current_state(2) != door::closed || pool.current_state(3) != door::closed) {
+        throw std::runtime_error("dispatch_all should apply events per instance");
+    }
+
+    const std::vector<pool_t::instance_id> ids{1, 1, 0};
+    const std::vector<door_event> scattered{door_event::unlock, door_event::pull, door_event::push};
+    if (pool.dispatch(ids, scattered) != 3 || pool.current_state(1) != door::open ||
+        pool.current_state(0) != door::closed) {
+        throw std::runtime_error("scattered dispatch should apply repeated ids in order");
+    }
+
+    auto rejected = pool.dispatch(2, door_event::unlock);
+    if (rejected || rejected.error() != "transition not found") {
+        throw std::runtime_error("single dispatch should report missing transitions");
+    }
+}
+
+BASICPP_TEST(StateMachinePoolParallelMatchesSerial) {
+    using pool_t = basicpp::state::state_machine_pool<door, door_event, 3, 4>;
+    constexpr std::size_t count = 100000;
+    pool_t serial{door_transitions, count, door::closed};
+    pool_t parallel{door_transitions, count, door::closed};
+
+    std::vector<door_event> events(count);
+    for (std::size_t round = 0; round < 4; ++round) {
+        for (std::size_t i = 0; i < count; ++i) {
+            events[i] = static_cast<door_event>((i * 7 + round * 3) % 5);
+        }
+        const auto expected = serial.dispatch_all(events);
+        if (parallel.dispatch_all(events, basicpp::state::parallel_dispatch{4, 1000}) != expected) {
+            throw std::runtime_error("parallel dispatch should count the same transitions");
+        }
+    }
+    if (!std::equal(serial.states().begin(), serial.states().end(), parallel.states().begin())) {
+        throw std::runtime_error("parallel dispatch should reach the same states");
+    }
+}
+
+namespace {
+
+// A ring of 7 states where event 0 always advances, so the final state reveals any lost transition.
+using ring_machine = basicpp::state::concurrent_state_machine<int, int, 7, 2>;
+
+constexpr ring_machine::table_type make_ring() {
+    ring_machine::table_type table;
+    for (int state = 0; state < 7; ++state) {
+        table.add_transition(state, 0, (state + 1) % 7);
+    }
+    return table;
+}
+
+constexpr auto ring_table = make_ring();
+
+template <typename Machine>
+void hammer(Machine& machine, int threads, int per_thread) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                if (!machine.dispatch(0)) {
+                    throw std::runtime_error("ring transition should always succeed");
+                }
+                machine.dispatch(1);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+BASICPP_TEST(ConcurrentStateMachineLosesNoTransitions) {
+    constexpr int threads = 4;
+    constexpr int per_thread = 20000;
+    ring_machine machine{0, ring_table};
+    hammer(machine, threads, per_thread);
+
+    if (machine.sequence() != threads * per_thread || machine.current_state() != (threads * per_thread) % 7) {
+        throw std::runtime_error("every accepted event should be applied exactly once");
+    }
+    if (machine.dispatch(1).error() != "transition not found") {
+        throw std::runtime_error("missing transitions should be reported");
+    }
+}
+
+BASICPP_TEST(ConcurrentStateMachineSequencedCallbacksFormAChain) {
+    constexpr int threads = 4;
+    constexpr int per_thread = 5000;
+    ring_machine machine{3, ring_table};
+
+    // Sequenced callbacks never overlap, so the log needs no lock.
+    std::vector<std::pair<int, int>> log;
+    machine.on_transition([&](const int& from, const int& to, const int&) { log.emplace_back(from, to); });
+    hammer(machine, threads, per_thread);
+
+    if (log.size() != static_cast<std::size_t>(threads * per_thread) || log.front().first != 3) {
+        throw std::runtime_error("one callback per transition expected");
+    }
+    for (std::size_t i = 1; i < log.size(); ++i) {
+        if (log[i].first != log[i - 1].second) {
+            throw std::runtime_error("sequenced callbacks should follow transition order");
+        }
+    }
+}
+
+BASICPP_TEST(ConcurrentStateMachineUnorderedCallbacks) {
+    ring_machine machine{0, ring_table};
+    std::atomic<int> calls{0};
+    machine.on_transition([&](const int&, const int&, const int&) { calls.fetch_add(1); },
+                          basicpp::state::callback_order::unordered);
+    hammer(machine, 4, 5000);
+    if (calls.load() != 20000) {
+        throw std::runtime_error("unordered callbacks should still run once per transition");
+    }
+}
+
 BASICPP_TEST_MAIN()
@@ -0,0 +1,88 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <basicpp/command/command.hpp>
+#include <basicpp/command/static_command.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+namespace {
+
+struct journal {
+    std::vector<std::string>* lines;
+};
+
+class append_line final : public basicpp::command::static_command<append_line, journal> {
+public:
+    explicit append_line(std::string text)
+        : text_(std::move(text)) {
+    }
+
+    result_type execute(const journal& context) {
+        context.lines->push_back(text_);
+        return result_type::ok();
+    }
+
+private:
+    std::string text_;
+};
+
+// Satisfies command_for without deriving from anything.
+struct fail_when_full {
+    std::size_t limit;
+
+    basicpp::command::command<journal>::result_type execute(const journal& context) const {
+        if (context.lines->size() >= limit) {
+            return basicpp::command::command<journal>::result_type::err("journal full");
+        }
+        return basicpp::command::command<journal>::result_type::ok();
+    }
+};
+
+struct not_a_command {};
+
+static_assert(basicpp::command::command_for<append_line, journal>);
+static_assert(basicpp::command::command_for<fail_when_full, journal>);
+static_assert(!basicpp::command::command_for<not_a_command, journal>);
+
+} // namespace
+
+BASICPP_TEST(StaticCommandCallsDerivedExecute) {
+    std::vector<std::string> lines;
+    append_line command("hello");
+    if (!command(journal{&lines}) || lines != std::vector<std::string>{"hello"}) {
+        throw std::runtime_error("CRTP call operator should forward to execute");
+    }
+}
+
+BASICPP_TEST(CommandSetRunsInOrderAndStopsOnFailure) {
+    std::vector<std::string> lines;
+    const journal context{&lines};
+
+    basicpp::command::command_set<journal, append_line, fail_when_full> commands;
+    commands.emplace<append_line>("a");
+    commands.push_back(append_line("b"));
+    commands.emplace<fail_when_full>(fail_when_full{2});
+    commands.emplace<append_line>("c");
+
+    auto result = commands.execute_all(context);
+    if (result || result.error() != "journal full" || lines != std::vector<std::string>{"a", "b"}) {
+        throw std::runtime_error("execute_all should stop at the first failure");
+    }
+
+    if (!commands.execute(3, context) || lines.back() != "c" || commands.size() != 4) {
+        throw std::runtime_error("execute(index) should run a single command");
+    }
+
+    std::size_t appenders = 0;
+    commands.for_each([&](auto& item) {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(item)>, append_line>) {
+            ++appenders;
+        }
+    });
+    if (appenders != 3) {
+        throw std::runtime_error("for_each should expose concrete types");
+    }
+}
+
+BASICPP_TEST_MAIN()
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <basicpp/history/coalescer.hpp>
+#include <basicpp/history/command_history.hpp>
+#include <basicpp/history/undo_stack.hpp>
+#include <basicpp/testing/selftest.hpp>
+
+BASICPP_TEST(UndoStackUndoesAndRedoes) {
+    basicpp::history::undo_stack<int> stack{0, basicpp::history::history_limits{3, 0}};
+    if (stack.undo() || stack.redo()) {
+        throw std::runtime_error("an empty history has nothing to step over");
+    }
+
+    for (int value = 1; value <= 4; ++value) {
+        stack.push(value);
+    }
+    // Four pushes into three entries: the oldest step (0 -> 1) was evicted.
+    if (stack.current() != 4 || stack.undo_count() != 3) {
+        throw std::runtime_error("undo_stack should keep the newest max_entries steps");
+    }
+    if (!stack.undo() || !stack.undo() || stack.current() != 2 || stack.redo_count() != 2) {
+        throw std::runtime_error("undo should step back one state at a time");
+    }
+    if (!stack.redo() || stack.current() != 3) {
+        throw std::runtime_error("redo should step forward again");
+    }
+
+    stack.push_if(std::optional<int>{});
+    if (stack.current() != 3 || !stack.can_redo()) {
+        throw std::runtime_error("an empty optional should not change the history");
+    }
+    stack.push_if(std::optional<int>{10});
+    if (stack.current() != 10 || stack.can_redo() || stack.undo_count() != 3) {
+        throw std::runtime_error("pushing after an undo should drop the redo steps");
+    }
+    while (stack.undo()) {
+    }
+    if (stack.current() != 1) {
+        throw std::runtime_error("undo should stop at the oldest retained state");
+    }
+}
+
+BASICPP_TEST(UndoStackTakesCoalescedEdits) {
+    using clock = std::chrono::steady_clock;
+    auto edits = basicpp::history::make_coalescer<std::string>(
+        std::chrono::milliseconds(10), [](const std::string&, const std::string& latest) { return latest; });
+    basicpp::history::undo_stack<std::string> stack{""};
+    const auto origin = clock::time_point{};
+
+    edits.push("h", origin);
+    edits.push("he", origin + std::chrono::milliseconds(3));
+    stack.push_if(edits.consume(origin + std::chrono::milliseconds(5)));
+    edits.push("hey", origin + std::chrono::milliseconds(8));
+    stack.push_if(edits.consume(origin + std::chrono::milliseconds(10)));
+    if (stack.current() != "hey" || stack.undo_count() != 1 || !stack.undo() || stack.current() != "") {
+        throw std::runtime_error("a coalesced burst should become one undo step");
+    }
+
+    // A plain value converts to T, not to the optional overload.
+    stack.push("typed");
+    if (stack.current() != "typed" || stack.undo_count() != 1) {
+        throw std::runtime_error("push should take a value convertible to T");
+    }
+}
+
+BASICPP_TEST(SpliceDeltaStoresOnlyTheChange) {
+    using stack_t = basicpp::history::undo_stack<std::string, basicpp::history::splice_delta<std::string>>;
+    const std::string document(64 * 1024, 'x');
+    stack_t stack{document, basicpp::history::history_limits{1024, 16 * 1024}};
+
+    // Random edits checked against every full version.
+    std::mt19937 rng(11);
+    std::vector<std::string> versions{document};
+    for (int step = 0; step < 300; ++step) {
+        auto next = versions.back();
+        const auto at = rng() % (next.size() + 1);
+        switch (rng() % 3) {
+        case 0:
+            next.insert(at, std::string(rng() % 40, static_cast<char>('a' + rng() % 26)));
+            break;
+        case 1:
+            next.erase(at, rng() % 40);
+            break;
+        default:
+            next.replace(at, rng() % 8, "edit");
+            break;
+        }
+        stack.push(next);
+        versions.push_back(std::move(next));
+    }
+    if (stack.bytes() > 16 * 1024 || stack.undo_count() == 0 || stack.undo_count() >= versions.size()) {
+        throw std::runtime_error("splice deltas should respect the byte budget");
+    }
+
+    const auto retained = stack.undo_count();
+    for (std::size_t back = 1; back <= retained; ++back) {
+        if (!stack.undo() || stack.current() != versions[versions.size() - 1 - back]) {
+            throw std::runtime_error("undo through splice deltas should restore every version");
+        }
+    }
+    for (std::size_t forward = retained; forward-- > 0;) {
+        if (!stack.redo() || stack.current() != versions[versions.size() - 1 - forward]) {
+            throw std::runtime_error("redo through splice deltas should restore every version");
+        }
+    }
+}
+
+BASICPP_TEST(CommandHistoryRunsInverses) {
+    int total = 0;
+    basicpp::history::command_history<int, int> history;
+    history.register_command(
+        "add", [&](int amount) { return basicpp::core::result<int, std::string>::ok(total += amount); },
+        [&](int amount) { return basicpp::core::result<int, std::string>::ok(total -= amount); });
+    history.register_command("reset", [&](int) { return basicpp::core::result<int, std::string>::ok(total = 0); });
+
+    if (history.undo() || history.execute("missing", 1)) {
+        throw std::runtime_error("undo with no history and unknown commands should fail");
+    }
+    history.execute("add", 5);
+    history.execute("add", 7);
+    if (total != 12 || !history.undo() || total != 5 || !history.redo() || total != 12) {
+        throw std::runtime_error("command_history should undo and redo through the inverse");
+    }
+    if (!history.undo() || !history.undo() || total != 0 || history.can_undo() || history.redo_count() != 2) {
+        throw std::runtime_error("command_history should undo back to the start");
+    }
+
+    history.execute("add", 3);
+    if (history.can_redo() || history.undo_count() != 1) {
+        throw std::runtime_error("a new command should drop the redo steps");
+    }
+    history.execute("reset", 0);
+    if (total != 0 || history.can_undo()) {
+        throw std::runtime_error("a command without an inverse should clear the history");
+    }
+}
+
+BASICPP_TEST(CommandHistoryChargesArgumentBytes) {
+    using result_t = basicpp::core::result<int, std::string>;
+    basicpp::history::command_history<int, std::string> history{basicpp::history::history_limits{1024, 4096}};
+    auto ignore = [](const std::string&) { return result_t::ok(0); };
+    history.register_command("type", ignore, ignore);
+
+    for (int i = 0; i < 8; ++i) {
+        history.execute("type", std::string(1000, 'x'));
+    }
+    // Eight 1000-byte arguments do not fit in 4096 bytes, whatever the size of a record itself.
+    if (history.undo_count() == 0 || history.undo_count() > 4) {
+        throw std::runtime_error("command_history should charge the heap bytes of its arguments");
+    }
+}
+
+BASICPP_TEST_MAIN()